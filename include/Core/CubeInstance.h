@@ -1,9 +0,0 @@
-#pragma once
-#include "InstanceBase.h"
-#include "CubeMesh.h"
-
-namespace Core {
-
-
-
-}
\ No newline at end of file
@@ -7,11 +7,6 @@ namespace Core {
 class CubeMesh : public Mesh {
 public:
     CubeMesh(); // Constructor will define cube's specific data and call Mesh::setupData
-    ~CubeMesh();
-    void draw();
-private:
-    GLuint vbo = 0, ebo = 0, vao = 0;
-    GLsizei indexCount = 0;
 };
 
 } // namespace Core
@@ -0,0 +1,81 @@
+#pragma once
+#include "InstanceStore.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 从 VP 矩阵提取的六个裁剪平面（Gribb-Hartmann），plane·(x,y,z,1) >= 0 为内侧
+struct Frustum {
+    float planes[6][4];
+
+    void extract(const float vp[16]);
+    // 保守测试：AABB 完全位于某个平面外侧时返回 false
+    bool intersectsAABB(const float boundsMin[3], const float boundsMax[3]) const;
+};
+
+// 实例的世界空间 AABB（网格局部包围盒经模型矩阵变换）
+void instanceWorldBounds(const InstanceStore& instances, uint32_t idx, float boundsMin[3], float boundsMax[3]);
+
+// 视口像素矩形 [x0, x1) × [y0, y1)，x0 >= x1 或 y0 >= y1 为空
+struct ScreenRect {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+    void unite(const ScreenRect& other);
+    bool overlaps(const ScreenRect& other) const;
+    static ScreenRect full(int width, int height);
+};
+
+// 世界 AABB 经 vp 投影后覆盖的像素矩形（外扩 1 像素，裁剪到视口）；
+// 包围盒跨过相机平面时保守地返回整个视口
+ScreenRect projectBounds(const float vp[16], const float boundsMin[3], const float boundsMax[3], int width, int height);
+
+// 视锥裁剪：静态实例按 XY 平面上的均匀网格索引（与 maze[][] 的格子对齐），
+// 查询时只遍历视锥在 XY 平面投影覆盖的格子；动态实例与跨越格子过多的大物体单独逐个测试。
+// 网格在 InstanceStore::staticVersion() 变化时重建
+class CullingGrid {
+public:
+    // 格子 (i, j) 覆盖 [originX + i*cellSize, originX + (i+1)*cellSize) × [originY + j*cellSize, ...)
+    void setGrid(float originX, float originY, float cellSize);
+
+    // 输出 layers & layerMask 非零且与视锥相交的实例下标（升序）
+    void query(const float vp[16], const InstanceStore& instances, unsigned int layerMask, std::vector<uint32_t>& out);
+
+    // 最近一次查询：做了包围盒测试的实例数 / 输出的可见实例数（调试/统计用）
+    uint32_t lastTestedCount() const { return testedCount; }
+    uint32_t lastVisibleCount() const { return visibleCount; }
+
+private:
+    void rebuild(const InstanceStore& instances);
+    void testInstance(const Frustum& frustum, const InstanceStore& instances, uint32_t idx,
+                      unsigned int layerMask, const float* boundsMin, const float* boundsMax,
+                      std::vector<uint32_t>& out);
+
+    float gridOriginX = 0.0f, gridOriginY = 0.0f;
+    float gridCellSize = 1.0f;
+
+    // 网格覆盖的格子范围（以格子坐标表示），按行主序存放为 CSR：
+    // 第 c 个格子的实例为 cellItems[cellStart[c] .. cellStart[c+1])
+    int cellMinX = 0, cellMinY = 0;
+    int cellsX = 0, cellsY = 0;
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellItems;
+
+    std::vector<uint32_t> largeItems;     // 跨越格子过多的静态实例
+    std::vector<uint32_t> dynamicItems;   // 非静态实例，变换每帧可能变化
+    std::vector<float> staticBounds;      // 静态实例世界 AABB，6 floats / 实例（min, max）
+
+    // 实例可能登记在多个格子中，用查询序号去重
+    std::vector<uint32_t> visitStamp;
+    uint32_t currentStamp = 0;
+
+    const InstanceStore* builtStore = nullptr;
+    uint32_t builtVersion = 0;
+    bool built = false;
+
+    uint32_t testedCount = 0;
+    uint32_t visibleCount = 0;
+};
+
+} // namespace Core
@@ -0,0 +1,121 @@
+#pragma once
+#ifdef USE_DESKTOP_GL
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+#include <cstdint>
+#include <unordered_map>
+
+namespace Core {
+
+// 当前 GL 上下文的状态缓存：记录已绑定的程序、FBO、视口、各纹理单元的 2D 纹理、VBO/EBO/VAO、
+// 默认 VAO 上的顶点属性布局，以及每个程序各 uniform 最近一次设置的值，与缓存相同的调用直接跳过。
+// 每帧的执行/跳过次数见 lastFrame()。
+// 约定：逐帧路径上的绑定与 uniform 全部经过这里；创建/删除资源的代码可以直接调用 GL，
+// 结束后调用 invalidate()（GL 名字会复用，删除已绑定的对象后缓存不再可信）
+class GLStateCache {
+public:
+    static const int MAX_TEXTURE_UNITS = 8;
+    static const int MAX_ATTRIBS = 16;
+    static const int MAX_UNIFORM_BINDINGS = 4;
+
+    struct Stats {
+        uint32_t issued = 0;
+        uint32_t elided = 0;
+    };
+
+    GLStateCache() { invalidate(); }
+
+    // 之后的每个绑定都会重新下发；uniform 缓存一并清空
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindFramebuffer(GLuint fbo);
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    // 绑定到 GL_TEXTURE0 + unit 的 GL_TEXTURE_2D，需要时切换活动纹理单元
+    void bindTexture(int unit, GLuint texture);
+
+    void bindArrayBuffer(GLuint buffer);
+    // GL_UNIFORM_BUFFER 通用绑定点（上传用）；bindUniformBufferRange 同时改变它
+    void bindUniformBuffer(GLuint buffer);
+    void bindUniformBufferRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    // EBO 属于 VAO 状态：非默认 VAO 绑定期间直接下发，不更新缓存
+    void bindElementBuffer(GLuint buffer);
+    // 桌面 GL 的网格 VAO；GLES 路径只使用默认 VAO
+    void bindVertexArray(GLuint vao);
+    // 数据来自当前 GL_ARRAY_BUFFER，着色器中读作浮点（整数类型按 normalized 归一化或直接转换）；
+    // 只在默认 VAO 上缓存
+    void vertexAttribPointer(GLuint index, GLint size, GLsizei stride, GLintptr offset,
+                             GLenum type = GL_FLOAT, GLboolean normalized = GL_FALSE);
+    void enableVertexAttrib(GLuint index);
+    void disableVertexAttrib(GLuint index);
+    // 关闭默认 VAO 上 first 及之后所有可能开启的属性（GLES 下属性状态全局共享，
+    // 每种绘制只声明自己用到的属性，其余在这里关掉）；非默认 VAO 绑定期间不做任何事
+    void disableVertexAttribsFrom(GLuint first);
+    void vertexAttribDivisor(GLuint index, GLuint divisor);
+    // 属性数组关闭时着色器读到的常量值（上下文状态，与 VAO 无关）
+    void vertexAttrib4fv(GLuint index, const GLfloat* v);
+
+    // 以下 uniform 作用于当前程序，location 为 -1 时忽略
+    void uniform1i(GLint location, GLint v);
+    void uniform2i(GLint location, GLint x, GLint y);
+    void uniform1f(GLint location, GLfloat v);
+    void uniform2f(GLint location, GLfloat x, GLfloat y);
+    void uniform3fv(GLint location, const GLfloat* v);
+    void uniform4fv(GLint location, const GLfloat* v);
+    void uniformMatrix3fv(GLint location, const GLfloat* m);
+    void uniformMatrix4fv(GLint location, const GLfloat* m);
+
+    // 由渲染器每帧调用一次：保存上一帧的计数并清零
+    void newFrame();
+    const Stats& lastFrame() const { return previous; }
+
+private:
+    struct Attrib {
+        GLuint buffer;
+        GLint size;
+        GLsizei stride;
+        GLintptr offset;
+        GLenum type;
+        GLboolean normalized;
+        GLuint divisor;
+        int enabled;   // -1 未知
+    };
+
+    struct UniformValue {
+        uint32_t words[16];
+        uint8_t count;
+        uint8_t kind;
+    };
+
+    // 值与缓存相同时返回 false；否则更新缓存并返回 true
+    bool uniformChanged(GLint location, uint8_t kind, const void* data, int words);
+    bool elide(bool same);
+
+    GLuint program;
+    GLuint framebuffer;
+    GLint view[4];
+    int activeUnit;
+    GLuint textures[MAX_TEXTURE_UNITS];
+    GLuint arrayBuffer;
+    GLuint uniformBuffer;
+    struct UniformRange {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    } uniformRanges[MAX_UNIFORM_BINDINGS];
+    GLuint elementBuffer;
+    GLuint vertexArray;
+    Attrib attribs[MAX_ATTRIBS];
+    GLfloat attribConstants[MAX_ATTRIBS][4];
+    bool attribConstantKnown[MAX_ATTRIBS];
+    std::unordered_map<uint64_t, UniformValue> uniforms;
+
+    Stats current, previous;
+};
+
+// 进程内唯一的 GL 上下文对应的缓存（Renderer、Mesh、StaticBatch 共用）
+GLStateCache& glState();
+
+} // namespace Core
@@ -0,0 +1,101 @@
+#pragma once
+#ifdef USE_DESKTOP_GL
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+#include "Core/VertexFormat.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 网格在共享缓冲中的位置：顶点 [baseVertex, baseVertex + vertexCount)，
+// 索引 [firstIndex, firstIndex + indexCount)，索引值保持网格内的相对编号（16 位）
+struct GeometryRange {
+    uint32_t baseVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+// 所有 Mesh 共用一个顶点缓冲（position + normal，格式见 VertexLayout）与一个 16 位索引缓冲，按区间分配。
+// 切换网格不再重新绑定缓冲：桌面 GL 绑定一个共享 VAO 并用 glDrawElementsBaseVertex 绘制；
+// GLES 3.0/3.1 没有 base vertex 绘制，改为把顶点属性指针偏移到 baseVertex 处。
+// 空闲区间按偏移排序，首次适配分配、释放时与相邻区间合并；空间不足时整体搬迁到更大的新缓冲。
+// 压缩格式的位置反量化参数按网格以常量顶点属性（POSITION_SCALE_ATTRIB / POSITION_BIAS_ATTRIB）下发。
+// 需要当前 GL 上下文
+class GeometryArena {
+public:
+    static const uint32_t INVALID_HANDLE = 0xFFFFFFFFu;
+
+    struct Stats {
+        uint32_t meshes = 0;
+        uint32_t usedVertices = 0, vertexCapacity = 0;
+        uint32_t usedIndices = 0, indexCapacity = 0;
+        uint32_t freeBlocks = 0; // 顶点与索引空闲区间总数，碎片化程度
+        uint32_t vertexStride = 0;
+        float maxPositionError = 0.0f, maxNormalError = 0.0f; // 所有存活网格中的最大编码误差
+    };
+
+    // 顶点格式只能在没有存活网格时切换（着色器按格式编译，需在 Renderer::init 之前设置）
+    bool setLayout(const VertexLayout& layout);
+    const VertexLayout& layout() const { return vertexLayout; }
+
+    // 上传一个网格（输入格式同 Mesh::setupData，按 layout() 编码），返回句柄
+    uint32_t allocate(const float* verts, uint32_t vertexCount, const unsigned short* idxs, uint32_t indexCount);
+    // 上传已按 layout() 编码的顶点（如映射的 MeshCache），data 直接交给 glBufferSubData，不经编码缓冲
+    uint32_t allocateEncoded(const uint8_t* data, uint32_t vertexCount, const VertexEncoding& encoding,
+                             const unsigned short* idxs, uint32_t indexCount);
+    // 归还区间；最后一个网格释放后删除 GL 缓冲
+    void release(uint32_t handle);
+    const GeometryRange& range(uint32_t handle) const { return slots[handle].range; }
+    const VertexEncoding& encoding(uint32_t handle) const { return slots[handle].encoding; }
+
+    // 把存活的区间紧凑排列到新缓冲，空闲空间合并为末尾一段。
+    // 运行时反复加载/卸载网格后调用；句柄不变，区间位置改变
+    void defragment();
+
+    // 绑定共享缓冲并设置该网格的反量化常量：桌面 GL 为共享 VAO，
+    // GLES 为 VBO + EBO，位置 / 法线属性指针偏移到该网格的 baseVertex
+    void bind(uint32_t handle);
+#ifdef USE_DESKTOP_GL
+    // 实例属性保存在共享 VAO 中：实例化绘制后标记，非实例化绘制前关闭
+    void markInstanceAttribsEnabled() { instanceAttribsEnabled = true; }
+    void disableInstanceAttribs();
+#endif
+
+    Stats stats() const;
+
+private:
+    struct Block {
+        uint32_t offset, count;
+    };
+    struct Slot {
+        GeometryRange range;
+        VertexEncoding encoding;
+        bool live = false;
+    };
+
+    static bool takeBlock(std::vector<Block>& blocks, uint32_t count, uint32_t& offset);
+    static void returnBlock(std::vector<Block>& blocks, uint32_t offset, uint32_t count);
+    // 创建指定容量的新缓冲，把存活区间按句柄顺序紧凑复制过去
+    void relocate(uint32_t newVertexCapacity, uint32_t newIndexCapacity);
+    void destroy();
+
+    VertexLayout vertexLayout;
+    std::vector<uint8_t> encodeScratch;
+    GLuint vbo = 0, ebo = 0, vao = 0;
+    uint32_t vertexCapacity = 0, indexCapacity = 0;
+    std::vector<Block> freeVertices, freeIndices;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    uint32_t liveMeshes = 0;
+#ifdef USE_DESKTOP_GL
+    bool instanceAttribsEnabled = false;
+#endif
+};
+
+GeometryArena& geometryArena();
+
+} // namespace Core
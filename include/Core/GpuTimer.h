@@ -0,0 +1,39 @@
+#pragma once
+#include "Profiler.h"
+
+namespace Core {
+
+// GL_TIME_ELAPSED 计时（桌面 GL 3.3 / ARB_timer_query，GLES 3 需要 EXT_disjoint_timer_query）。
+// 每个通道 LATENCY 个查询对象轮流使用，结果在之后的帧就绪时才读取，不会让 CPU 等待 GPU；
+// 同一时刻只能有一个计时查询，嵌套的通道不计 GPU 时间。GLES 上发生 disjoint（频率切换等）时丢弃当批结果
+class GLTimerQueries : public GpuPassTimer {
+public:
+    static const int LATENCY = 4;
+
+    ~GLTimerQueries() override;
+
+    // 需要当前 GL 上下文；不支持时返回 false，之后的调用都是空操作
+    bool init();
+    void shutdown();
+    bool supported() const { return ready; }
+
+    void begin(int pass, uint32_t frame) override;
+    void end(int pass) override;
+    void collect(PassProfiler& profiler) override;
+
+private:
+    struct Slot {
+        unsigned int query = 0;
+        uint32_t frame = 0;
+        bool pending = false;
+    };
+
+    bool ready = false;
+    bool checkDisjoint = false;
+    int activePass = -1;
+    int activeSlot = -1;
+    Slot slots[PROFILE_PASS_COUNT][LATENCY];
+    int nextSlot[PROFILE_PASS_COUNT] = {0};
+};
+
+} // namespace Core
@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace Core {
+
+// 图像读写，像素均为 RGBA8、第 0 行为画面底部（与 RenderBackend::readPixels 一致），写文件时翻转为自上而下
+
+// 无压缩 PNG（deflate 存储块），不依赖 zlib
+bool writePNG(const std::string& path, const std::vector<uint8_t>& rgba, int width, int height);
+// 二进制 PPM（P6），alpha 丢弃
+bool writePPM(const std::string& path, const std::vector<uint8_t>& rgba, int width, int height);
+// 按扩展名选择格式：.png 为 PNG，其余为 PPM
+bool writeImage(const std::string& path, const std::vector<uint8_t>& rgba, int width, int height);
+// 读取 P6 PPM（maxval 255），alpha 填 255
+bool readPPM(const std::string& path, std::vector<uint8_t>& rgba, int& width, int& height);
+
+// 两张同尺寸图像 RGB 通道的平均绝对误差（0~255），尺寸不同时返回负数
+double meanAbsoluteError(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b);
+
+} // namespace Core
@@ -0,0 +1,89 @@
+#pragma once
+#include "Mesh.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 实例所属的渲染层，可按位组合；各渲染通道通过层掩码筛选实例
+enum InstanceLayer : unsigned int {
+    LAYER_STATIC   = 1u << 0, // 场景通道：静态物体（创建后变换不再改变）
+    LAYER_DYNAMIC  = 1u << 1, // 场景通道：动态物体
+    LAYER_OCCLUDER = 1u << 2, // 写入 blockMap 的遮挡物
+    LAYER_RADIANCE = 1u << 3, // 写入 radiance 贴图的发光体
+};
+
+// 稳定句柄：实例在数组中的位置会因删除而移动，句柄始终有效直到 destroy
+struct InstanceHandle {
+    static const uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+    uint32_t slot = INVALID_SLOT;
+    uint32_t generation = 0;
+};
+
+// 结构数组（SoA）形式的实例存储：变换、颜色、自发光、网格 ID、层掩码各自连续存放，
+// 渲染通道按下标 [0, size()) 线性遍历，不需要逐实例的堆分配
+class InstanceStore {
+public:
+    InstanceHandle create(Mesh* mesh, unsigned int layers);
+    // 删除后末尾实例移入空位，保持数组紧凑
+    void destroy(InstanceHandle h);
+    bool isAlive(InstanceHandle h) const;
+    void reserve(std::size_t count);
+    void clear();
+
+    void setModelMatrix(InstanceHandle h, const float* mat);
+    void setColor(InstanceHandle h, float r, float g, float b, float a = 1.0f);
+    void setEmissive(InstanceHandle h, float r, float g, float b, float a = 1.0f);
+    void setLayers(InstanceHandle h, unsigned int layers);
+
+    const float* getModelMatrix(InstanceHandle h) const { return &transforms[denseIndex(h) * 16]; }
+    const float* getColor(InstanceHandle h) const { return &colorData[denseIndex(h) * 4]; }
+    const float* getEmissive(InstanceHandle h) const { return &emissiveData[denseIndex(h) * 4]; }
+
+    // 句柄对应的当前数组下标
+    uint32_t denseIndex(InstanceHandle h) const { return slotToDense[h.slot]; }
+
+    // 连续数组访问，第 i 个实例：modelMatrices()[i*16]，colors()/emissives()[i*4]
+    std::size_t size() const { return meshIdData.size(); }
+    const float* modelMatrices() const { return transforms.data(); }
+    const float* colors() const { return colorData.data(); }
+    const float* emissives() const { return emissiveData.data(); }
+    const uint16_t* meshIds() const { return meshIdData.data(); }
+    const unsigned int* layers() const { return layerData.data(); }
+    // 每个实例的变换版本号，setModelMatrix 时递增
+    const uint32_t* transformVersions() const { return versionData.data(); }
+
+    // 全局版本号，供缓存判断是否失效：
+    // staticVersion  - 增删实例、修改层掩码、修改 LAYER_STATIC 实例的变换 / 颜色 / 发光时递增（下标可能变化）
+    // dynamicVersion - 修改非静态实例的变换时递增（下标不变）；非静态实例的颜色 / 发光每帧直接读取，不计版本
+    uint32_t staticVersion() const { return staticVersionCounter; }
+    uint32_t dynamicVersion() const { return dynamicVersionCounter; }
+
+    // 网格表：同一 Mesh* 只登记一次，ID 从 0 连续分配
+    std::size_t meshCount() const { return meshTable.size(); }
+    Mesh* mesh(uint16_t id) const { return meshTable[id]; }
+
+private:
+    uint16_t registerMesh(Mesh* mesh);
+
+    // 按实例连续存放的数据
+    std::vector<float> transforms;      // 16 floats / 实例
+    std::vector<float> colorData;       // 4 floats / 实例
+    std::vector<float> emissiveData;    // 4 floats / 实例
+    std::vector<uint16_t> meshIdData;
+    std::vector<unsigned int> layerData;
+    std::vector<uint32_t> versionData;
+    std::vector<uint32_t> denseToSlot;
+
+    uint32_t staticVersionCounter = 0;
+    uint32_t dynamicVersionCounter = 0;
+
+    // 句柄间接表
+    std::vector<uint32_t> slotToDense;
+    std::vector<uint32_t> slotGeneration;
+    std::vector<uint32_t> freeSlots;
+
+    std::vector<Mesh*> meshTable;
+};
+
+} // namespace Core
@@ -0,0 +1,68 @@
+#pragma once
+#include "InstanceStore.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 烘焙用的静态点光源（世界 XY 平面，半径为世界单位，颜色已乘强度）
+struct BakeLight {
+    float pos[2];
+    float radius;
+    float color[3];
+};
+
+// 静态光照烘焙：启动时在 CPU 上对占据网格（maze[][]）逐纹素计算静态光源的辐照度，
+// 衰减与 SDF GI 着色器一致（smoothstep 后平方），可见性沿纹素到光源的线段做格子 DDA。
+// 结果为世界 XY 上的 RGB 光照贴图，运行时 GI 每个像素只采样一次，动态光源仍走 GPU 路径。
+// 不依赖 GL，可在无 GPU 环境下与 bakeReference() 对照
+class LightBaker {
+public:
+    // occupancy[y * width + x] 非零为墙；格子 (x, y) 覆盖
+    // [originX + x*cellSize, originX + (x+1)*cellSize) × [originY + y*cellSize, ...)
+    void setGrid(const uint8_t* occupancy, int width, int height, float originX, float originY, float cellSize);
+    // 每个格子边长上的纹素数（默认 8）
+    void setTexelsPerCell(int texels);
+
+    void clearLights() { lightData.clear(); }
+    void addLight(const BakeLight& light) { lightData.push_back(light); }
+    // 按 TiledLightList 的规则从 layers & layerMask 的自发光实例收集光源：
+    // 半径 = baseRadius * min(1, emissive.rgb * emissive.a 的最大分量)，颜色 = emissive.rgb * emissive.a * intensity
+    void addEmissiveInstances(const InstanceStore& instances, unsigned int layerMask, float baseRadius, float intensity);
+
+    // 按行分给 threadCount 个线程（<= 0 时取硬件线程数），每行一次用 SIMD 计算 4 个纹素的衰减
+    void bake(int threadCount = 0);
+    // 标量单线程参考实现，与 bake() 结果一致（仅浮点舍入差异），由 tests/LightBakerTest.cpp 对照
+    void bakeReference();
+
+    int mapWidth() const { return mapW; }
+    int mapHeight() const { return mapH; }
+    // RGB，行主序，第 0 行对应 originY 一侧
+    const std::vector<float>& irradiance() const { return mapData; }
+    const std::vector<BakeLight>& lights() const { return lightData; }
+    // 世界 XY -> 贴图 UV：uv = world * scale + offset
+    void worldToMapUV(float scale[2], float offset[2]) const;
+
+private:
+    void resizeMap();
+    void bakeRows(int rowBegin, int rowEnd, int rowStep);
+    bool wall(int cx, int cy) const;
+    // 格子坐标下 (x0, y0) -> (x1, y1) 的线段是否不经过墙（起点与光源所在格子不计）
+    bool visible(float x0, float y0, float x1, float y1) const;
+
+    std::vector<uint8_t> occupancyData;
+    int gridW = 0, gridH = 0;
+    float gridOriginX = 0.0f, gridOriginY = 0.0f;
+    float gridCellSize = 1.0f;
+    int texelsPerCell = 8;
+
+    std::vector<BakeLight> lightData;
+    int mapW = 0, mapH = 0;
+    std::vector<float> mapData;
+};
+
+// 屏幕 UV -> 光照贴图 UV 的单应矩阵（3x3 列主序，可直接传给 glUniformMatrix3fv）：
+// 先求屏幕位置对应的地面 z=0 世界 XY，再按 world * scale + offset 映射；vp 不可逆时全为 0
+void screenToLightmapUV(const float vp[16], const float scale[2], const float offset[2], float out[9]);
+
+} // namespace Core
@@ -0,0 +1,58 @@
+#pragma once
+#include "InstanceStore.h"
+#include "Culling.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 屏幕空间点光源：位置与半径以 GI 纹理 UV 表示，颜色已乘强度
+struct ScreenLight {
+    float uv[2];
+    float range;
+    float color[3];
+};
+
+// 多光源分块列表：emissive.rgb 非零的实例都作为点光源，投影到屏幕后按 TILE_SIZE 像素的方块分箱，
+// 每块只记录能照到它的光源下标（CSR：tileRanges 为每块 (offset, count)，下标存于 tileIndices）。
+// GI 着色器按像素所在块遍历光源，火把增多时每像素开销只取决于附近的光源数
+class TiledLightList {
+public:
+    static const int TILE_SIZE = 16;            // GI 像素
+    static const int MAX_LIGHTS = 256;
+    static const int MAX_LIGHTS_PER_TILE = 16;  // 与着色器的循环上限一致，超出的按实例顺序丢弃
+
+    // 半径 = baseRange * min(1, emissive.rgb * emissive.a 的最大分量)；颜色 = emissive.rgb * emissive.a * intensity
+    void setLightParameters(float baseRange, float intensity);
+
+    // 收集 layers & layerMask 非零的自发光实例（按实例下标顺序，最多 MAX_LIGHTS 个），
+    // 投影到 width × height 的 GI 视口并分块。光源下标只随实例增删或自发光变化而改变，屏幕外的光源保留但不入块
+    void build(const float vp[16], const InstanceStore& instances, unsigned int layerMask, int width, int height);
+
+    const std::vector<ScreenLight>& lights() const { return lightData; }
+    // 每个光源照亮的像素矩形（外扩 1 像素，裁剪到视口；屏幕外为空）
+    const std::vector<ScreenRect>& lightRects() const { return rectData; }
+
+    int tilesX() const { return tileCountX; }
+    int tilesY() const { return tileCountY; }
+    const std::vector<uint32_t>& tileRanges() const { return tileRangeData; }
+    const std::vector<uint16_t>& tileIndices() const { return tileIndexData; }
+
+    // 最近一次构建因单块超限丢弃的 (块, 光源) 对数（调试/统计用）
+    uint32_t droppedCount() const { return dropped; }
+
+private:
+    float lightBaseRange = 0.2f;
+    float lightIntensity = 0.8f;
+
+    std::vector<ScreenLight> lightData;
+    std::vector<ScreenRect> rectData;
+
+    int tileCountX = 0, tileCountY = 0;
+    std::vector<uint32_t> tileRangeData;   // 2 / 块
+    std::vector<uint16_t> tileIndexData;
+    std::vector<uint32_t> tileCursor;      // 计数排序的写入位置
+    uint32_t dropped = 0;
+};
+
+} // namespace Core
@@ -0,0 +1,60 @@
+#pragma once
+#include "InstanceStore.h"
+#include "LightBaker.h"
+#include "CubeMesh.h"
+#include "PanelMesh.h"
+#include "Sphere.h"
+#include "ModelMesh.h"
+#include "MeshCache.h"
+#include <memory>
+#include <vector>
+#include <utility>
+
+namespace Core {
+
+// 迷宫布局：0=通道，1=墙，2=起点，3=终点；格子 (x, y) 的中心位于世界坐标 (x, y)
+const int MAZE_WIDTH = 16;
+const int MAZE_HEIGHT = 16;
+extern const int mazeLayout[MAZE_HEIGHT][MAZE_WIDTH];
+
+// 起点和终点坐标
+const float MAZE_START_X = 1.0f;
+const float MAZE_START_Y = 1.0f;
+const float MAZE_EXIT_X = 14.0f;
+const float MAZE_EXIT_Y = 14.0f;
+
+// 迷宫场景共用的网格，须比引用它们的 InstanceStore 活得久
+struct MazeMeshes {
+    // icosphere 为 true 时玩家球体用轮廓误差不超过默认 UV 球的最小 icosphere（--sphere ico）
+    explicit MazeMeshes(bool icosphere = false);
+    CubeMesh cube;
+    PanelMesh panel;
+    std::unique_ptr<Mesh> sphere;
+};
+
+// 向 instances 加入地板、墙体与起点/终点标记（均为静态），以及位于起点的玩家球体（动态发光），
+// 返回玩家实例句柄。窗口程序与无窗口基准程序共用同一场景
+InstanceHandle buildMazeScene(InstanceStore& instances, MazeMeshes& meshes);
+
+// 玩家球体的模型矩阵
+void mazePlayerModel(const float pos[3], float model[16]);
+
+// 把导入的 OBJ 模型（--model）作为静态遮挡物放到终点格子上：为每个分段创建 ModelMesh（需要 GL 上下文，
+// 追加到 meshes，须比 instances 活得久）。OBJ 的 Y 轴朝上转为场景的 Z 轴朝上，
+// 水平最大尺寸缩放到 0.8 格，底部与墙体底部（z = -1）对齐
+void addMazeModel(const ModelData& model, std::vector<std::unique_ptr<ModelMesh> >& meshes, InstanceStore& instances);
+// 同上，分段取自映射的网格缓存；创建完成后 cache 即可关闭。
+// keepCpuCopy 见 ModelMesh：开启静态合批时须为 true，否则只上传 GPU 数据
+void addMazeModel(const MeshCache& cache, std::vector<std::unique_ptr<ModelMesh> >& meshes, InstanceStore& instances,
+                  bool keepCpuCopy);
+
+// 起点到终点的最短路径（格子坐标，含两端），广度优先搜索
+std::vector<std::pair<int, int> > mazeSolutionPath();
+// 沿路径前进 distance 格后的位置，到终点后折返；无人输入时（基准、离屏运行）的脚本化玩家移动
+void mazePathPosition(const std::vector<std::pair<int, int> >& path, float distance, float pos[3]);
+
+// 把静态发光体（起点/终点标记）烘焙进光照贴图。半径与 TiledLightList 的屏幕半径 0.2 对应：
+// 正交投影下屏幕高度为 orthoSize 个世界单位
+void bakeMazeLights(const InstanceStore& instances, float orthoSize, LightBaker& baker);
+
+} // namespace Core
@@ -1,21 +1,74 @@
 #pragma once
 
-#ifdef USE_DESKTOP_GL
+#if defined(PI_HEADLESS)
+// 无窗口构建（SoftRenderer）：只保留 CPU 端几何数据，不创建 GL 缓冲，也不需要 GL 头文件
+#include <cstddef>
+typedef unsigned int GLuint;
+typedef int GLsizei;
+typedef std::ptrdiff_t GLintptr;
+#elif defined(USE_DESKTOP_GL)
 #include <glad/glad.h>
 #else
 
-#include <GLES2/gl2.h>
+#include <GLES3/gl3.h> // 运行时上下文为 ES 3.x，需要实例化相关接口
 
 #endif
+#include "Core/MeshOptimizer.h"
+#include "Core/VertexFormat.h"
 #include <vector>
 #include <cstddef> // For std::size_t
+#include <cstdint>
 
 namespace Core
 {
+
+// 实例化绘制的每实例属性布局（instance VBO 中连续存放）：
+// mat4 model 占用 location 2~5，vec4 color 为 location 6，vec4 emissive 为 location 7
+const GLuint INSTANCE_ATTRIB_FIRST = 2;
+const int INSTANCE_ATTRIB_VEC4_COUNT = 6;
+const int INSTANCE_DATA_FLOATS = INSTANCE_ATTRIB_VEC4_COUNT * 4;
+// 压缩顶点格式的位置反量化 scale / bias（vec3），以常量属性下发，不开启属性数组
+const GLuint POSITION_SCALE_ATTRIB = 8;
+const GLuint POSITION_BIAS_ATTRIB = 9;
+
 class Mesh {
 public:
-    virtual void draw() = 0;
-    virtual ~Mesh() {}
+    virtual void draw();
+    // 一次 glDrawElementsInstanced 绘制 instanceCount 个实例，
+    // 每实例数据从 instanceVBO 的 instanceOffset 字节处开始
+    virtual void drawInstanced(GLuint instanceVBO, GLintptr instanceOffset, GLsizei instanceCount);
+    virtual ~Mesh();
     // 可以加一些通用属性和方法
+
+    // CPU 端几何数据副本（顶点格式同 setupData），供静态合批、软件光栅等离线处理使用；
+    // 由 setupEncoded 创建且未要求副本的网格为空
+    const std::vector<float>& getVertices() const { return vertices; }
+    const std::vector<unsigned short>& getIndices() const { return indices; }
+    // 局部空间包围盒，setupData 时计算；无顶点时为零
+    const float* boundsMin() const { return aabbMin; }
+    const float* boundsMax() const { return aabbMax; }
+    // 程序生成网格在构造时做的顶点缓存优化（生成顺序与优化后的 ACMR）；未经优化的网格为 0
+    const MeshOrderStats& orderStats() const { return order; }
+
+protected:
+    // 顶点格式 (px, py, pz, nx, ny, nz)，由子类在构造函数中调用
+    void setupData(const float* verts, std::size_t vertexFloatCount,
+                   const unsigned short* idxs, std::size_t idxCount);
+    // 已编码的顶点（MeshCache 映射）：layout 与 GeometryArena 相同时直接从 data 上传，不经解码；
+    // keepCpuCopy 为 true 时才按 layout 解码出 CPU 副本（无窗口构建总是保留）。
+    // 包围盒取编码前记录的 boundsMin / boundsMax
+    void setupEncoded(const uint8_t* data, std::size_t vertexCount, const VertexLayout& layout,
+                      const VertexEncoding& encoding, const float boundsMin[3], const float boundsMax[3],
+                      const unsigned short* idxs, std::size_t idxCount, bool keepCpuCopy);
+    void bindGeometry();
+
+    // GeometryArena 中的区间句柄（见 GeometryArena::range），GPU 端只保留这一条记录
+    uint32_t geometry = 0xFFFFFFFFu;
+    GLsizei indexCount = 0;
+    std::vector<float> vertices;
+    std::vector<unsigned short> indices;
+    float aabbMin[3] = {0.0f, 0.0f, 0.0f};
+    float aabbMax[3] = {0.0f, 0.0f, 0.0f};
+    MeshOrderStats order;
 };
 } // namespace core
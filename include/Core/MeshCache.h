@@ -0,0 +1,107 @@
+#pragma once
+#include "Core/ModelMesh.h"
+#include "Core/VertexFormat.h"
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace Core {
+
+// 导入结果的二进制缓存（小端，树莓派与 x86 相同），布局：
+// MeshCacheHeader | MeshCachePart x partCount | 各分段的顶点块与索引块（起点 16 字节对齐）
+// 顶点块已按 GPU 顶点格式编码，运行时映射文件后直接交给 glBufferSubData，不经中间缓冲
+const uint32_t MESH_CACHE_VERSION = 1; // 文件布局或导入流程（去重、重排）改变时递增
+
+struct MeshCacheHeader {
+    char magic[4];                 // "PIMC"
+    uint32_t version;
+    uint64_t sourceHash;           // meshSourceHash(源文件)
+    uint8_t positionFormat;        // PositionFormat
+    uint8_t normalFormat;          // NormalFormat
+    uint16_t vertexStride;
+    uint32_t partCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t triangles;
+    uint32_t faceCorners;
+    uint32_t uniqueVertices;
+    float acmrBefore;
+    float acmrAfter;
+    uint32_t reserved;
+};
+
+struct MeshCachePart {
+    uint64_t vertexOffset;         // 相对文件起点的字节偏移
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;           // 16 位索引
+    float positionScale[3];        // VertexEncoding
+    float positionBias[3];
+    float maxPositionError;
+    float maxNormalError;
+    float boundsMin[3];            // 编码前的局部包围盒，与 OBJ 导入路径的 Mesh::boundsMin/Max 一致
+    float boundsMax[3];
+};
+
+static_assert(sizeof(MeshCacheHeader) == 72, "MeshCacheHeader layout");
+static_assert(sizeof(MeshCachePart) == 80, "MeshCachePart layout");
+
+// 源文件指纹：文件大小与修改时间的 FNV-1a 哈希，不读取内容（热启动不碰 OBJ 文本）。文件不存在时为 0
+uint64_t meshSourceHash(const std::string& sourcePath);
+// <源文件>.<顶点格式名>.pimesh，不同顶点格式各存一份
+std::string meshCachePath(const std::string& sourcePath, const VertexLayout& layout);
+// 按 layout 编码各分段写入缓存。先写临时文件再改名，中途失败不会留下半个缓存
+bool writeMeshCache(const std::string& cachePath, uint64_t sourceHash, const VertexLayout& layout,
+                    const ModelData& model);
+
+// 只读映射的缓存文件（POSIX mmap；Windows 退化为整体读入内存）。
+// open 校验魔数、版本、源文件指纹、顶点格式与各数据块的边界，任一不符返回 false，调用方重新导入
+class MeshCache {
+public:
+    MeshCache() {}
+    ~MeshCache() { close(); }
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    bool open(const std::string& cachePath, uint64_t sourceHash, const VertexLayout& layout);
+    // 解除映射；网格创建后（GPU 与 CPU 副本都已就绪）即可关闭
+    void close();
+    bool isOpen() const { return bytes != nullptr; }
+    size_t size() const { return length; }
+
+    const MeshCacheHeader& header() const { return head; }
+    VertexLayout layout() const;
+    uint32_t partCount() const { return head.partCount; }
+    const MeshCachePart& part(uint32_t i) const { return parts[i]; }
+    VertexEncoding encoding(uint32_t i) const;
+    // 指向映射内存，close 后失效
+    const uint8_t* vertexData(uint32_t i) const { return bytes + parts[i].vertexOffset; }
+    const unsigned short* indexData(uint32_t i) const {
+        return reinterpret_cast<const unsigned short*>(bytes + parts[i].indexOffset);
+    }
+
+private:
+    bool validate(uint64_t sourceHash, const VertexLayout& layout);
+
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+    MeshCacheHeader head = {};
+    const MeshCachePart* parts = nullptr;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+#endif
+};
+
+struct ModelImport {
+    ModelData model;
+    bool cacheWritten = false;
+    double cacheWriteMs = 0.0;
+};
+
+// 在工作线程中执行 loadObjModel，成功后按 layout 写入 cachePath；下次启动由 MeshCache 直接映射
+std::future<ModelImport> importObjModelAsync(const std::string& sourcePath, const std::string& cachePath,
+                                             const VertexLayout& layout);
+
+} // namespace Core
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+
+// 模拟的 post-transform 缓存大小（Tipsify 论文推荐 12 ~ 24，取中间值）
+const uint32_t VERTEX_CACHE_SIZE = 16;
+
+// 平均缓存未命中率（未命中顶点数 / 三角形数），模拟 cacheSize 项的 FIFO post-transform 缓存
+float vertexCacheMissRatio(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize);
+// Tipsify（Sander 等，2007）：就地重排三角形。clusterStarts 非空时写入各簇起始三角形下标，
+// 簇在跳到不相邻顶点（缓存相当于清空）处分开，簇之间任意重排不增加缓存未命中
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize,
+                         std::vector<uint32_t>* clusterStarts);
+// 按簇排序：面积加权的平均法线与（簇中心 - 网格中心）点积大的簇先画，先画外侧朝外的面，
+// 被遮挡的内侧片元更早被深度测试剔除。vertices 格式同 Mesh::setupData
+void optimizeOverdraw(const float* vertices, std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusterStarts);
+
+struct MeshOrderStats {
+    float acmrBefore = 0.0f;
+    float acmrAfter = 0.0f;
+};
+
+// 程序生成网格用（16 位索引，顶点格式同 Mesh::setupData）：上面两步之后顶点按首次使用重新编号，
+// 顶点读取也按顺序进行。就地修改，返回优化前后的 ACMR（VERTEX_CACHE_SIZE 项缓存）
+MeshOrderStats optimizeMeshOrder(std::vector<float>& vertices, std::vector<unsigned short>& indices);
+
+} // namespace Core
@@ -0,0 +1,49 @@
+#pragma once
+#include "Core/Mesh.h"
+#include "Core/MeshOptimizer.h"
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace Core {
+
+// 可以用 16 位索引绘制的一段几何，顶点格式同 Mesh::setupData
+struct ModelPart {
+    std::vector<float> vertices;
+    std::vector<unsigned short> indices;
+};
+
+// OBJ 导入结果，纯 CPU 数据，可以在工作线程中生成
+struct ModelData {
+    std::vector<ModelPart> parts;
+    float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+    float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    uint32_t triangles = 0;
+    uint32_t faceCorners = 0;      // 去重前的顶点数（三角形数 x 3）
+    uint32_t uniqueVertices = 0;
+    float acmrBefore = 0.0f;       // 文件原始三角形顺序的平均缓存未命中率（未命中顶点数 / 三角形数）
+    float acmrAfter = 0.0f;
+    double loadMs = 0.0;           // 解析与优化耗时
+    std::string error;             // 非空表示失败
+};
+
+// 读取 OBJ：多边形三角化，按 (位置, 法线) 索引对用哈希表去重，缺法线的面按面积加权生成平滑法线；
+// Tipsify 重排三角形提高顶点缓存命中，再按簇的朝外程度排序减少 overdraw（见 MeshOptimizer.h），顶点按首次使用重新编号。
+// GeometryArena 与 Mesh 的 CPU 副本都是 16 位索引，超过 65535 个顶点时沿三角形顺序切成多段
+// （与 StaticBatch 的分块方式相同）
+bool loadObjModel(const std::string& path, ModelData& out);
+// 在工作线程中执行 loadObjModel；GL 上传（创建 ModelMesh）须回到持有上下文的线程
+std::future<ModelData> loadObjModelAsync(const std::string& path);
+
+class MeshCache;
+
+class ModelMesh : public Mesh {
+public:
+    explicit ModelMesh(const ModelPart& part);
+    // 从映射的缓存创建第 part 段，GPU 数据直接取自映射内存。
+    // keepCpuCopy 为 false 时不解码 CPU 副本（getVertices 为空），静态合批或软件光栅会读取该网格时须为 true
+    ModelMesh(const MeshCache& cache, uint32_t part, bool keepCpuCopy);
+};
+
+} // namespace Core
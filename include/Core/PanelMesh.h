@@ -6,11 +6,6 @@ class PanelMesh : public Mesh {
 
 public:
     PanelMesh(); // Constructor will define panel's specific data and call Mesh::setupData
-    ~PanelMesh();
-    void draw();
-private:
-    GLuint vbo = 0, ebo = 0, vao = 0;
-    GLsizei indexCount = 0;
 };
 
 
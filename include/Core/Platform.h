@@ -8,12 +8,17 @@ struct InputState {
 
 // 初始化窗口与 OpenGL 上下文，返回是否成功
 bool initWindow(int width, int height);
+// 无窗口模式：EGL pbuffer（或 Mesa surfaceless）上的 OpenGL ES 3 上下文，不需要显示器与 SDL 视频；
+// 默认帧缓冲为 width x height 的 pbuffer（surfaceless 时没有默认帧缓冲，结果从 FBO 读回）。
+// 仅 GLES 构建可用，用于无显示器机器上的性能测试与画面对比
+bool initOffscreen(int width, int height);
+bool isOffscreen();
 // 轮询事件，修改 running 标志
 void pollEvents(bool &running);
 void pollEvents(bool &running, InputState &in);
-// 交换前后缓冲区，显示渲染结果
+// 交换前后缓冲区，显示渲染结果；无窗口模式下等待 GPU 完成本帧（帧时间包含 GPU 开销）
 void swapBuffers();
-// 清理 SDL 和 GL 资源
+// 清理 SDL / EGL 和 GL 资源
 void shutdown();
 
-} // namespace Platform
\ No newline at end of file
+} // namespace Platform
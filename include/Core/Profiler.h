@@ -0,0 +1,105 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+
+// 渲染后端的各个通道（与 RenderBackend 一帧的调用顺序一致）
+enum ProfilePass {
+    PROFILE_BEGIN_FRAME,
+    PROFILE_RADIANCE,
+    PROFILE_BLOCKMAP,   // 含 JFA 距离场
+    PROFILE_GI,         // SDF GI 或 Radiance Cascades，含上采样
+    PROFILE_STATIC,
+    PROFILE_DYNAMIC,
+    PROFILE_PPGI,
+    PROFILE_FINISH,
+    PROFILE_PASS_COUNT
+};
+
+struct PassStats {
+    int samples = 0;
+    double avg = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0; // 毫秒
+};
+
+class PassProfiler;
+class TraceRecorder;
+
+// GPU 计时源（GL 后端用 timer query 实现）。begin/end 包住一个通道的 GL 命令，
+// collect 在之后的帧把已就绪的结果交给 PassProfiler::addGpuSample，不等待 GPU
+class GpuPassTimer {
+public:
+    virtual ~GpuPassTimer() {}
+    virtual void begin(int pass, uint32_t frame) = 0;
+    virtual void end(int pass) = 0;
+    virtual void collect(PassProfiler& profiler) = 0;
+};
+
+// 逐通道计时：CPU 用 steady_clock，GPU 由可选的 GpuPassTimer 提供。每个通道保留最近 WINDOW 帧的样本，
+// 给出滚动平均与 p50/p95/p99；同一帧多次进入同一通道时累加。帧时间为相邻两次 beginFrame 的间隔
+class PassProfiler {
+public:
+    static const int WINDOW = 256;
+
+    PassProfiler();
+
+    void setEnabled(bool enabled) { active = enabled; }
+    bool enabled() const { return active; }
+    // 不拥有 timer；nullptr 时只记录 CPU 时间
+    void setGpuTimer(GpuPassTimer* timer) { gpuTimer = timer; }
+    bool hasGpuTimer() const { return gpuTimer != nullptr; }
+    // 不拥有 trace；设置后每个通道同时写入帧时间线（帧号取 trace->frame()）
+    void setTrace(TraceRecorder* recorder) { trace = recorder; }
+
+    // 由后端的 beginFrame 调用：记录上一帧的帧时间并收集已就绪的 GPU 结果
+    void beginFrame();
+    void beginPass(int pass);
+    void endPass(int pass);
+    void addGpuSample(int pass, uint32_t frame, double ms);
+
+    uint32_t frameIndex() const { return frame; }
+    PassStats cpuStats(int pass) const;
+    PassStats gpuStats(int pass) const;
+    PassStats frameStats() const;
+    static const char* passName(int pass);
+    // 打印各通道 CPU / GPU 的 avg、p50、p95、p99
+    void print() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Series {
+        std::vector<double> values;  // 环形缓冲
+        int next = 0;
+        uint32_t lastFrame = 0xFFFFFFFFu;
+        void add(uint32_t frame, double ms);
+        PassStats stats() const;
+    };
+
+    bool active = true;
+    GpuPassTimer* gpuTimer = nullptr;
+    TraceRecorder* trace = nullptr;
+    uint32_t frame = 0;
+    bool frameStarted = false;
+    Clock::time_point frameStart;
+    Clock::time_point passStart[PROFILE_PASS_COUNT];
+    Series cpu[PROFILE_PASS_COUNT];
+    Series gpu[PROFILE_PASS_COUNT];
+    Series frames;
+};
+
+// 作用域计时：构造时 beginPass，析构时 endPass
+class ProfileScope {
+public:
+    ProfileScope(PassProfiler& profiler, int pass) : owner(profiler), id(pass) { owner.beginPass(id); }
+    ~ProfileScope() { owner.endPass(id); }
+
+private:
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+    PassProfiler& owner;
+    int id;
+};
+
+} // namespace Core
@@ -0,0 +1,52 @@
+#pragma once
+#include "InstanceStore.h"
+#include "LightBaker.h"
+#include "Profiler.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 渲染后端接口。一帧的调用顺序：
+// beginFrame → renderEmissiveToRadianceFBO → renderBlockMap → renderSDFLightsFBO →
+// renderStaticInstances → renderDynamicInstances → renderPPGI → OneFrameRenderFinish。
+// Renderer 为 GL/GLES 实现（需要窗口与上下文）；SoftRenderer 为 CPU 实现，
+// 在没有 GPU 的构建机上做帧时间与画面回归
+class RenderBackend {
+public:
+    virtual ~RenderBackend() {}
+
+    virtual bool init() = 0;
+    // 按新分辨率重建所有渲染目标
+    virtual void reinitializeFBOs(int width, int height) = 0;
+    virtual void shutdown() = 0;
+
+    // GI 分辨率除数（1 / 2 / 4）
+    virtual void setGIResolutionDivisor(int divisor) = 0;
+    // SDF GI 光源半径（屏幕 UV）与强度
+    virtual void setLightParameters(float baseRange, float intensity) = 0;
+    // 静态光照贴图，见 LightBaker
+    virtual void setStaticLightmap(const LightBaker& baker) = 0;
+
+    virtual void beginFrame(const float vp[16], uint32_t vpVersion, const InstanceStore& instances) = 0;
+    // 以下各通道只处理 layers & layerMask != 0 的实例
+    virtual void renderEmissiveToRadianceFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) = 0;
+    virtual void renderBlockMap(const float vp[16], const InstanceStore& instances, unsigned int layerMask) = 0;
+    virtual void renderSDFLightsFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) = 0;
+    virtual void renderStaticInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) = 0;
+    virtual void renderDynamicInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) = 0;
+    virtual void renderPPGI() = 0;
+    virtual void OneFrameRenderFinish(bool usePostProcessing = true) = 0;
+
+    // 读回最近一次 OneFrameRenderFinish 输出的画面：RGBA8，第 0 行为画面底部（与 glReadPixels 一致）
+    virtual void readPixels(std::vector<uint8_t>& rgba, int& width, int& height) = 0;
+
+    // 各通道的 CPU（以及后端支持时的 GPU）耗时，beginFrame 开始新的一帧
+    PassProfiler& profiler() { return passProfiler; }
+    const PassProfiler& profiler() const { return passProfiler; }
+
+protected:
+    PassProfiler passProfiler;
+};
+
+} // namespace Core
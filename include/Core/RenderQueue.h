@@ -0,0 +1,35 @@
+#pragma once
+#include "InstanceStore.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 通道内的绘制排序：每个实例一个 64 位键
+//   [63:48] 网格 ID  [47:24] 观察深度  [23:0] 实例下标（最多 2^24 个实例）
+// 按键升序输出，同一网格的实例连续（几何绑定只切换一次），网格内由近到远（利用 early-Z）。
+// 一个队列只服务一个通道、一个着色器程序，因此键中不含通道 / 程序字段；
+// 颜色、自发光等材质数据随实例上传，不产生状态切换，也不参与排序
+class RenderQueue {
+public:
+    // 按 vp 计算 indices 中每个实例包围盒中心的观察深度（裁剪空间 w）并排序
+    void build(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices);
+
+    void clear();
+    // depth 越小越靠前，负值（中心位于相机后方）按 0 处理
+    void push(uint32_t instance, uint16_t mesh, float depth);
+    // LSD 基数排序（8 位一趟），只处理高 40 位，所有键取值相同的字节直接跳过；
+    // 排序稳定，键相同时保持 push 顺序
+    void sort();
+
+    // 排序后的实例下标
+    const std::vector<uint32_t>& order() const { return sorted; }
+    bool empty() const { return sorted.empty(); }
+
+private:
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> scratch;
+    std::vector<uint32_t> sorted;
+};
+
+} // namespace Core
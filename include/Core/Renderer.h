@@ -3,52 +3,94 @@
 #ifdef USE_DESKTOP_GL
 #include <glad/glad.h>
 #else
-#include <GLES2/gl2.h> // For OpenGL ES (Raspberry Pi)
+#include <GLES3/gl3.h> // For OpenGL ES 3.x (Raspberry Pi)
 #endif
 #include <memory>
 #include <vector>
 #include "Mesh.h"
 #include "CubeMesh.h" // Include CubeMesh class for cube rendering
 #include "PanelMesh.h" // Include PanelMesh class for panel rendering
-#include "InstanceBase.h" // Include Instance class for rendering instances
+#include "InstanceStore.h" // SoA instance storage consumed by the render passes
+#include "TransformCache.h"
+#include "StaticBatch.h"
+#include "Culling.h"
+#include "RenderQueue.h"
+#include "Lights.h"
+#include "LightBaker.h"
+#include "RenderBackend.h"
+#include "GpuTimer.h"
+#include "GLState.h"
+#include "UniformRing.h"
 
 namespace Core {
 
-class Renderer {
+class Renderer : public RenderBackend {
 public:
     // 初始化着色器与几何体
-    bool init();
+    bool init() override;
     // 设置窗口大小以更新视口
     void resize(int width, int height);
     // 渲染，参数为 4x4 MVP 矩阵
     void render(const float mvp[16], const float model[16]);
     
     void render(const float vp[16], const std::vector<float*>& modelMatrices);
-    // 清理资源
-    void renderStaticInstances(const float vp[16], const std::vector<Core::Instance*>& instances);
+    // 每帧开始时调用：按相机 VP 版本号更新 MVP 缓存，之后各通道共享结果
+    void beginFrame(const float vp[16], uint32_t vpVersion, const InstanceStore& instances) override;
 
-    void renderDynamicInstances(const float vp[16], const std::vector<Core::Instance*>& instances);
+    // 以下各通道只绘制 layers & layerMask != 0 的实例（见 InstanceLayer）
+    void renderStaticInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
+
+    void renderDynamicInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
 
     void renderPanel(const float vp[16],const float model[16]);
 
-    void renderEmissiveToRadianceFBO(const float vp[16], const std::vector<Instance*>& instances);
+    void renderEmissiveToRadianceFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
 
-    void renderDiffuseFBO(const float vp[16],const std::vector<Instance*>& instances);
+    // Radiance Cascades GI：radianceTex 中的所有发光体，墙体遮挡，开销与光线长度无关
+    void renderDiffuseFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask);
     
-    // 添加支持SDF GI的新渲染函数
-    void renderDiffuseFBO(const float vp[16], const std::vector<Instance*>& instances, 
-                         const float playerWorldPos[3], const float viewProjectionMatrix[16]);
+    // SDF GI：layers & layerMask 中 emissive 非零的实例都作为点光源，按屏幕分块只着色照到该像素的光源
+    void renderSDFLightsFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
+    // 光源半径（屏幕 UV）与强度，见 TiledLightList::setLightParameters
+    void setLightParameters(float baseRange, float intensity) override;
+    const TiledLightList& lightList() const { return sdfLights; }
+    // 上传 CPU 烘焙的静态光照贴图，SDF GI 每个像素采样一次后再叠加动态光源；
+    // 烘焙过的光源应从 renderSDFLightsFBO 的层掩码中去掉
+    void setStaticLightmap(const LightBaker& baker) override;
+
+    void renderBlockMap(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
 
-    void renderBlockMap(const float vp[16], const std::vector<Instance*>& instances);
+    void renderPPGI() override;
 
-    void renderPPGI();
+    void OneFrameRenderFinish(bool usePostProcessing = true) override;
 
-    void OneFrameRenderFinish(bool usePostProcessing = true);
+    void readPixels(std::vector<uint8_t>& rgba, int& width, int& height) override;
 
     // 重新初始化FBO以适应新的屏幕分辨率
-    void reinitializeFBOs(int width, int height);
+    void reinitializeFBOs(int width, int height) override;
+
+    void shutdown() override;
 
-    void shutdown();
+    // 当前上下文是否支持实例化绘制（GL 3.3 / GLES 3.0）
+    bool supportsInstancing() const { return instancingSupported; }
+    // 开启后 renderStaticInstances 使用预变换的静态合批（适合不支持实例化的设备），
+    // 静态实例变化时自动重新烘焙
+    void setStaticBatchingEnabled(bool enabled);
+    // 视锥裁剪（默认开启）：各通道只提交与视锥相交的实例。
+    // 网格应与场景布局对齐，例如迷宫格子中心在整数坐标时用 (-0.5, -0.5, 1)
+    void setCullingEnabled(bool enabled);
+    void setCullingGrid(float originX, float originY, float cellSize);
+    const CullingGrid& culling() const { return cullingGrid; }
+    // GI 分辨率除数（1 / 2 / 4）：radiance 与扩散通道以 屏幕/divisor 的分辨率运行，
+    // 之后按全分辨率 blockMap 做双边上采样再交给 renderPPGI。应在 init() 之前设置，
+    // 之后修改会重建 FBO
+    void setGIResolutionDivisor(int divisor) override;
+    int giResolutionDivisor() const { return giDivisor; }
+    // 时域 GI：每帧只追踪 1/interleave 的 GI 像素（2 棋盘格，4 为 2x2 交错），
+    // 其余像素复用重投影后的历史结果；1 关闭。代价接近 frameSkip = interleave - 1，但光照不会跳帧
+    void setGITemporalInterleave(int interleave);
+    // 上一帧经 GLStateCache 执行 / 跳过的绑定与 uniform 调用次数
+    const GLStateCache::Stats& glStateStats() const { return glState().lastFrame(); }
 private:
     // 屏幕分辨率
     int screenWidth = 800;
@@ -66,6 +108,7 @@ private:
 
     unsigned int quadVAO = 0, quadVBO = 0;
     unsigned int quadShaderProgram = 0;
+    GLint loc_quad_screenTex = -1;
 
     //BlockMapFBO
     unsigned int blockMapFBO = 0;
@@ -94,25 +137,219 @@ private:
     unsigned int postprocessingFBO_GI = 0;
     unsigned int postprocessingTex_GI = 0;
     unsigned int ppgiShaderProgram = 0;
-    
+    GLint loc_ppgi_scene = -1;
+    GLint loc_ppgi_radiance = -1;
+    GLint loc_ppgi_intensity = -1;
+
+    // 低分辨率 GI：radianceFBO / blurFBO[0] 为 giWidth x giHeight，
+    // blurFBO[1] 保存上采样到全分辨率的结果
+    int giDivisor = 1;
+    int giWidth = 800;
+    int giHeight = 600;
+    bool finishedWithPostProcessing = true; // 最近一次 OneFrameRenderFinish 输出的目标，供 readPixels
+    int fboWidth = 800;
+    int fboHeight = 600;
+    unsigned int giUpsampleShaderProgram = 0;
+    GLint loc_up_giTex = -1;
+    GLint loc_up_blockMapTex = -1;
+    GLint loc_up_giSize = -1;
+
+    // blockMap 的跳跃泛洪（JFA）距离场，GI 分辨率：每个像素存最近遮挡像素的坐标（RG16UI），
+    // SDF GI 着色器据此做球面追踪。jfaTex 两张交替读写，distanceFieldTex 指向最终结果
+    unsigned int jfaFBO[2] = {0, 0};
+    unsigned int jfaTex[2] = {0, 0};
+    unsigned int distanceFieldTex = 0;
+    bool distanceFieldValid = false;
+
+    // Radiance Cascades（见 renderDiffuseFBO 三参数版本）：cascadeTex[i] 为第 i 级合并后的结果，
+    // 发光体（radianceVersion）与距离场都不变时跳过
+    static const int MAX_RADIANCE_CASCADES = 6;
+    int cascadeCount = 0;
+    unsigned int cascadeFBO[MAX_RADIANCE_CASCADES] = {0};
+    unsigned int cascadeTex[MAX_RADIANCE_CASCADES] = {0};
+    int cascadeProbeCount[MAX_RADIANCE_CASCADES][2];
+    float cascadeIntensity = 4.0f;
+    bool cascadesValid = false;
+    uint32_t radianceVersion = 0;
+    uint32_t cascadeRadianceVersion = 0;
+    uint32_t cascadeFieldVersion = 0;
+    unsigned int sceneJfaFBO[2] = {0, 0};
+    unsigned int sceneJfaTex[2] = {0, 0};
+    unsigned int cascadeShaderProgram = 0;
+    unsigned int cascadeGatherShaderProgram = 0;
+    GLint loc_rc_distanceTex = -1;
+    GLint loc_rc_radianceTex = -1;
+    GLint loc_rc_upperTex = -1;
+    GLint loc_rc_giSize = -1;
+    GLint loc_rc_probeCount = -1;
+    GLint loc_rc_tiles = -1;
+    GLint loc_rc_probeSpacing = -1;
+    GLint loc_rc_interval = -1;
+    GLint loc_rc_sceneDistanceTex = -1;
+    GLint loc_rc_hasUpper = -1;
+    GLint loc_rc_upperProbeCount = -1;
+    GLint loc_rc_upperSpacing = -1;
+    GLint loc_rcg_distanceTex = -1;
+    GLint loc_rcg_cascadeTex = -1;
+    GLint loc_rcg_probeCount = -1;
+    GLint loc_rcg_probeSpacing = -1;
+    GLint loc_rcg_intensity = -1;
+    unsigned int jfaSeedShaderProgram = 0;
+    unsigned int jfaStepShaderProgram = 0;
+    GLint loc_jfa_blockMapTex = -1;
+    GLint loc_jfa_radianceTex = -1;
+    GLint loc_jfa_seedEmitters = -1;
+    GLint loc_jfa_seedTex = -1;
+    GLint loc_jfa_step = -1;
+    GLint loc_jfa_size = -1;
+    GLint loc_distanceTex = -1;
+
+    // blockMap 输入（VP、遮挡实例）不变时跳过重绘，距离场也随之复用
+    bool blockMapValid = false;
+    float blockMapVP[16];
+    const InstanceStore* blockMapStore = nullptr;
+    uint32_t blockMapStaticVersion = 0;
+    unsigned int blockMapMask = 0;
+
+    // 增量 GI（GI 分辨率像素）：静态发光体、距离场不变时只重绘动态发光体 / 光照范围
+    // 新旧位置的并集，其余区域沿用上一次的结果
+    bool radianceValid = false;
+    float radianceVP[16];
+    const InstanceStore* radianceStore = nullptr;
+    uint32_t radianceStaticVersion = 0;
+    unsigned int radianceMask = 0;
+    ScreenRect radianceDynamicRect;
+    std::vector<ScreenRect> passRects;
+
+    bool giDiffuseValid = false;
+    uint32_t distanceFieldVersion = 0;
+    uint32_t giDiffuseFieldVersion = 0;
+    ScreenRect giDiffuseRecent[4];    // 时域模式下最近 4 帧的变化区域（环形），变化后还需追踪 interleave - 1 帧
+    ScreenRect giDiffuseLastDrawn;    // 上一次实际重绘的区域（时域模式下另一张缓冲缺少这部分更新）
+    uint32_t giDiffuseFrame = 0;
+
+    // 时域 GI：blurTex[0] 与 giHistoryTex（均为 GI 分辨率）每帧交换，blurTex[0] 始终为最新结果
+    int giTemporalInterleave = 1;
+    unsigned int giHistoryFBO = 0;
+    unsigned int giHistoryTex = 0;
+    bool giHistoryValid = false;
+    float giHistoryVP[16];
+    uint32_t giTemporalFrame = 0;
+    GLint loc_historyTex = -1;
+    GLint loc_reprojection = -1;
+    GLint loc_interleave = -1;
+    GLint loc_phase = -1;
+
+    // 多光源：sdfLights 每帧重建，与上一次绘制时的光源逐个比较得到脏区域。
+    // lightTex 为 RGBA32F（MAX_LIGHTS × 2），lightTileTex 为 RG32UI（每块一个纹素），
+    // lightIndexTex 为 R16UI（宽 LIGHT_INDEX_WIDTH，行数按需增长）
+    TiledLightList sdfLights;
+    std::vector<ScreenLight> drawnLights;
+    std::vector<ScreenRect> drawnLightRects;
+    // 与上一次绘制相比位置变化的光源（1）及其上一次的屏幕 UV（每光源 2 个 float）：
+    // 本像素的历史可见性位是按旧位置追踪的，着色器与相对光源位置相同的历史像素一致时才复用
+    std::vector<uint8_t> movedLights;
+    std::vector<float> movedLightsFrom;
+    unsigned int lightTex = 0;
+    unsigned int lightTileTex = 0;
+    unsigned int lightIndexTex = 0;
+    int lightTileTexSize[2] = {0, 0};
+    int lightIndexRows = 0;
+    std::vector<float> lightUploadData;
+    GLint loc_lightTex = -1;
+    GLint loc_lightTileTex = -1;
+    GLint loc_lightIndexTex = -1;
+    GLint loc_tileSize = -1;
+
+    // 静态光照贴图（RGB16F，世界 XY），staticLightmapScale/Offset 为世界 -> 贴图 UV
+    unsigned int staticLightmapTex = 0;
+    float staticLightmapScale[2] = {0.0f, 0.0f};
+    float staticLightmapOffset[2] = {0.0f, 0.0f};
+    GLint loc_staticLightmap = -1;
+    GLint loc_screenToLightmap = -1;
+    GLint loc_useLightmap = -1;
 
 
     // Uniform locations cache for performance
-    GLint loc_mvpMatrix = -1;
-    GLint loc_modelMatrix = -1;
-    GLint loc_color = -1;
-    GLint loc_emissive = -1;
-    GLint loc_lightDir = -1;
     GLint loc_radianceTex = -1;
-    GLint loc_screenSize = -1;       // 屏幕尺寸
     
     // SDF GI相关uniform变量
-    GLint loc_playerScreenPos = -1;  // 玩家屏幕坐标
     GLint loc_texelSize = -1;        // 纹素大小
-    GLint loc_lightRange = -1;       // 光照范围
+
+    // 实例化绘制：按 Mesh 分组，每组一次 glDrawElementsInstanced
+    bool instancingSupported = false;
+    unsigned int instancedShaderProgram = 0;
+    unsigned int instanceVBO = 0;
+    GLsizeiptr instanceVBOSize = 0;
+    std::vector<float> instanceData;       // 每帧复用，避免重复分配
+    GLint loc_inst_radianceTex = -1;
+
+    // 静态合批：按 (store, staticVersion, layerMask) 判断是否需要重新烘焙
+    bool staticBatchingEnabled = false;
+    StaticBatch staticBatch;
+    const InstanceStore* staticBatchStore = nullptr;
+    uint32_t staticBatchVersion = 0;
+    unsigned int staticBatchMask = 0;
+    unsigned int staticBatchShaderProgram = 0;
+    GLint loc_batch_radianceTex = -1;
+
+    // std140 uniform 块（布局与着色器中的 FrameBlock / ObjectBlock 一致）
+    struct FrameConstants {
+        float vp[16];
+        float lightDir[3];
+        float pad0;
+        float screenSize[2];
+        float pad1[2];
+    };
+    struct ObjectConstants {
+        float mvp[16];
+        float model[16];
+        float color[4];
+        float emissive[4];
+    };
+    static const GLuint FRAME_BLOCK_BINDING = 0;
+    static const GLuint OBJECT_BLOCK_BINDING = 1;
+    // 帧常量内容不变时复用上一次上传的区间；环形缓冲 orphan 后（generation 变化）重新上传
+    UniformRing uniformRing;
+    FrameConstants frameConstants = {};
+    GLintptr frameConstantsOffset = -1;
+    uint32_t frameConstantsGeneration = 0;
+    std::vector<uint8_t> objectUploadData;
+    std::vector<uint32_t> emissiveIndices;
+
+    bool cullingEnabled = true;
+    CullingGrid cullingGrid;
+
+    // 通道实例下标；MVP 缓存未命中时（VP 与 beginFrame 不同）的临时结果
+    std::vector<uint32_t> passIndices;
+    // 非合批绘制的排序（网格、深度），各通道复用
+    RenderQueue renderQueue;
+    TransformCache transformCache;
+    // 各通道 GPU 计时（不支持 timer query 时 passProfiler 只记录 CPU 时间）
+    GLTimerQueries gpuTimers;
+    std::vector<float> mvpResults;
 
     int indexCount;
     bool compileShaders();
+    void collectInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask, std::vector<uint32_t>& out);
+    const float* instanceMVPs(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices);
+    void drawSceneInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask);
+    void drawInstancesImmediate(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices);
+    void drawInstancesInstanced(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices);
+    void drawStaticBatch(const float vp[16], const InstanceStore& instances, unsigned int layerMask);
+    void bindFrameConstants(const float vp[16], const float lightDir[3]);
+    // 按 indices 顺序把每个实例的 ObjectConstants 连续上传到环形缓冲，返回首条记录的偏移
+    GLintptr uploadObjectConstants(const float* mvps, const InstanceStore& instances, const std::vector<uint32_t>& indices);
+    GLintptr uploadObjectConstants(const ObjectConstants& constants);
+    void bindObjectConstants(GLintptr offset);
+    void upsampleGI(const ScreenRect& giRect);
+    void createDistanceFieldTargets();
+    void createGIHistoryTarget();
+    // 把 sdfLights 上传到光源 / 分块 / 下标纹理（首次使用时创建，尺寸不足时重新分配）
+    void uploadLightList();
+    void createRadianceCascadeTargets();
+    unsigned int runJumpFlood(unsigned int fbo[2], unsigned int tex[2], bool seedEmitters);
+    void buildDistanceField();
 
 #ifdef USE_GLES2
     void bindQuadVertexAttributes();
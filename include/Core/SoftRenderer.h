@@ -0,0 +1,112 @@
+#pragma once
+#include "RenderBackend.h"
+#include "Culling.h"
+#include "Lights.h"
+#include "TransformCache.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace Core {
+
+class SoftWorkerPool;
+
+// CPU 软件光栅化后端：不需要窗口与 GL 上下文，按 Renderer 的着色器逐通道计算同样的结果
+// （RGBA8 目标按 [0, 1] 截断，纹理采样同为双线性）。三角形批量变换、近平面裁剪后按 TILE_SIZE
+// 像素分块，各线程领取块并用 NEON/SSE 一次测试 4 个像素的边函数与深度；JFA 距离场、SDF GI
+// 与双边上采样按行并行。Radiance Cascades 与时域/增量 GI 只在 GL 后端实现，这里每次整帧重算
+class SoftRenderer : public RenderBackend {
+public:
+    static const int TILE_SIZE = 32;
+
+    SoftRenderer();
+    ~SoftRenderer() override;
+
+    // 工作线程数（含调用线程），<= 0 时取硬件线程数；应在 init() 之前设置
+    void setThreadCount(int threads);
+
+    bool init() override;
+    void reinitializeFBOs(int width, int height) override;
+    void shutdown() override;
+    void setGIResolutionDivisor(int divisor) override;
+    void setLightParameters(float baseRange, float intensity) override;
+    void setStaticLightmap(const LightBaker& baker) override;
+
+    void beginFrame(const float vp[16], uint32_t vpVersion, const InstanceStore& instances) override;
+    void renderEmissiveToRadianceFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
+    void renderBlockMap(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
+    void renderSDFLightsFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
+    void renderStaticInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
+    void renderDynamicInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) override;
+    void renderPPGI() override;
+    void OneFrameRenderFinish(bool usePostProcessing = true) override;
+
+    void readPixels(std::vector<uint8_t>& rgba, int& width, int& height) override;
+
+    // 最近一帧光栅化的三角形数（调试/统计用）
+    uint32_t lastTriangleCount() const { return triangleCount; }
+
+private:
+    enum Pass { PASS_SCENE, PASS_RADIANCE, PASS_BLOCKMAP };
+
+    // 视口像素坐标下的三角形，边函数与重心插值在光栅化时按块计算
+    struct Triangle {
+        float x[3], y[3];
+        float z[3];        // 窗口深度 [0, 1]
+        float invW[3];     // 透视校正插值
+        float normal[3][3];
+        uint32_t instance;
+        int minX, minY, maxX, maxY;
+    };
+
+    void rasterize(Pass pass, const float vp[16], const InstanceStore& instances, unsigned int layerMask);
+    void setupTriangles(Pass pass, const float vp[16], const InstanceStore& instances, unsigned int layerMask);
+    void emitTriangle(const float clip[3][4], const float normals[3][3], uint32_t instance);
+    void rasterizeTile(Pass pass, int tile, const InstanceStore& instances);
+    void buildDistanceField();
+
+    std::unique_ptr<SoftWorkerPool> pool;
+    int threadCount = 0;
+
+    int width = 800, height = 600;
+    int giDivisor = 1;
+    int giWidth = 800, giHeight = 600;
+
+    // 各目标行主序，第 0 行为画面底部；颜色为 RGBA float
+    std::vector<float> sceneColor;
+    std::vector<float> sceneDepth;
+    std::vector<float> radiance;        // GI 分辨率
+    std::vector<uint8_t> blockMap;
+    std::vector<uint32_t> distanceField; // GI 分辨率，最近遮挡像素 x | y << 16，无遮挡为 0xFFFFFFFF
+    std::vector<uint32_t> jfaScratch;
+    std::vector<uint8_t> giBlockMap;     // GI 纹素中心处 step(0.5, blockMap)，上采样的样本权重用
+    std::vector<float> giColor;          // GI 分辨率
+    std::vector<float> giFull;           // 降分辨率时的上采样结果
+    std::vector<float> ppColor;
+    const std::vector<float>* finalColor = nullptr;
+
+    // blockMap 只在遮挡物全为静态且 VP 不变时复用，距离场随之复用
+    bool blockMapValid = false;
+    float blockMapVP[16];
+    const InstanceStore* blockMapStore = nullptr;
+    uint32_t blockMapStaticVersion = 0;
+    unsigned int blockMapMask = 0;
+
+    TransformCache transformCache;
+    std::vector<float> mvpScratch;
+    std::vector<float> clipScratch;     // 当前实例的裁剪空间顶点
+    std::vector<float> normalScratch;   // 当前实例的世界空间法线
+    std::vector<Triangle> triangles;
+    int targetWidth = 0, targetHeight = 0; // 当前光栅化通道的目标尺寸
+    int tilesX = 0, tilesY = 0;
+    std::vector<std::vector<uint32_t> > tileBins;
+    uint32_t triangleCount = 0;
+
+    TiledLightList sdfLights;
+    std::vector<float> lightmap;         // RGB，见 LightBaker::irradiance
+    int lightmapW = 0, lightmapH = 0;
+    float lightmapScale[2] = {0.0f, 0.0f};
+    float lightmapOffset[2] = {0.0f, 0.0f};
+};
+
+} // namespace Core
@@ -1,17 +1,34 @@
 #pragma once
 
 #include "Core/Mesh.h"
+#include <vector>
 
 namespace Core {
 
+// 默认 UV 球的细分（玩家球体）
+const int SPHERE_SECTORS = 32;
+const int SPHERE_STACKS = 16;
+
+// 半径 0.5 的球面几何，顶点格式同 Mesh::setupData，索引为生成顺序（未做缓存优化）
+// UV 球：sectorCount 条经线 x stackCount 层，经线接缝处顶点重复，极点附近是细长三角形
+void generateUVSphere(int sectorCount, int stackCount, std::vector<float>& verts, std::vector<unsigned short>& idxs);
+// icosphere：正二十面体每个面的边 frequency 等分（每面 frequency^2 个三角形）后投影到球面，
+// 顶点在各面之间共享，共 10 * frequency^2 + 2 个；三角形大小接近均匀。frequency 取 1 ~ 80（16 位索引）
+void generateIcosphere(int frequency, std::vector<float>& verts, std::vector<unsigned short>& idxs);
+// 内接于半径 radius 球面的凸网格的轮廓误差：任意视角下轮廓到圆的最大径向偏差，
+// 等于 radius 减去球心到各三角形所在平面的最小距离
+float sphereSilhouetteError(const std::vector<float>& verts, const std::vector<unsigned short>& idxs, float radius);
+// 轮廓误差不超过 maxError 的最小 frequency
+int icosphereFrequencyFor(float maxError);
+
 class SphereMesh : public Mesh {
 public:
-    SphereMesh(int sectorCount = 32, int stackCount = 16);
-    ~SphereMesh();
-    void draw();
-private:
-    GLuint vbo = 0, ebo = 0, vao = 0;
-    GLsizei indexCount = 0;
+    SphereMesh(int sectorCount = SPHERE_SECTORS, int stackCount = SPHERE_STACKS);
+};
+
+class IcosphereMesh : public Mesh {
+public:
+    explicit IcosphereMesh(int frequency);
 };
 
-} // namespace Core
\ No newline at end of file
+} // namespace Core
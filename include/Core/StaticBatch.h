@@ -0,0 +1,51 @@
+#pragma once
+#include "Mesh.h"
+#include "InstanceStore.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 静态合批：把层掩码匹配的静态实例预变换到世界空间，颜色与自发光烘焙为顶点属性，
+// 合并为少量 16 位索引的顶点/索引缓冲（每块不超过 65535 个顶点），
+// 在不支持实例化的 GLES2 设备上整个静态迷宫只需 1 次（或按块数的少量）draw call。
+// 合并时会剔除相邻墙体之间重合且朝向相反的内部面。
+class StaticBatch {
+public:
+    // 合批顶点格式：position(3) + normal(3) + color(4) + emissive(4)
+    static const int VERTEX_FLOATS = 14;
+
+    struct Chunk {
+        std::vector<float> vertices;
+        std::vector<unsigned short> indices;
+    };
+
+    ~StaticBatch();
+
+    // CPU 端烘焙（不涉及 GL），返回剔除的内部三角形数量
+    static uint32_t bake(const InstanceStore& instances, unsigned int layerMask, std::vector<Chunk>& chunks);
+
+    // 烘焙并上传到 GPU，替换已有数据
+    void build(const InstanceStore& instances, unsigned int layerMask);
+    void release();
+    // 顶点属性：location 0 位置，1 法线，2 颜色，3 自发光
+    void draw();
+
+    bool empty() const { return gpuChunks.empty(); }
+    uint32_t drawCallCount() const { return (uint32_t)gpuChunks.size(); }
+    uint32_t triangleCount() const { return triangles; }
+    uint32_t removedTriangleCount() const { return removedTriangles; }
+
+private:
+    struct GpuChunk {
+        GLuint vao = 0, vbo = 0, ebo = 0;
+        GLsizei indexCount = 0;
+    };
+    void bindChunk(const GpuChunk& chunk);
+
+    std::vector<GpuChunk> gpuChunks;
+    uint32_t triangles = 0;
+    uint32_t removedTriangles = 0;
+};
+
+} // namespace Core
@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Core {
+
+// 帧时间线记录：固定容量的环形缓冲，写满后覆盖最旧的事件，长时间采集的开销与内存都有上界。
+// 导出为 Chrome Trace Event JSON（"X" 完整事件，时间单位微秒），可直接在 chrome://tracing 或
+// Perfetto 中打开，查看被滚动平均掩盖的单帧卡顿。只在调用线程记录，名称须为静态字符串
+class TraceRecorder {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit TraceRecorder(size_t capacity = 65536);
+
+    void setEnabled(bool enabled) { active = enabled; }
+    bool enabled() const { return active; }
+
+    // 记录 [start, end) 区间；frame 写入事件参数，便于在时间线上按帧号定位
+    void record(const char* name, const char* category, Clock::time_point start, Clock::time_point end, uint32_t frame);
+    void setFrame(uint32_t frame) { currentFrame = frame; }
+    uint32_t frame() const { return currentFrame; }
+
+    size_t size() const { return count; }
+    // 已被覆盖的事件数
+    uint64_t dropped() const { return overwritten; }
+    void clear();
+
+    // 按时间顺序写出缓冲中的事件，失败返回 false
+    bool writeJSON(const std::string& path) const;
+
+private:
+    struct Event {
+        const char* name;
+        const char* category;
+        int64_t startNs;   // 相对 origin
+        int64_t durationNs;
+        uint32_t frame;
+    };
+
+    bool active = true;
+    Clock::time_point origin;
+    std::vector<Event> events;
+    size_t head = 0;   // 下一个写入位置
+    size_t count = 0;
+    uint64_t overwritten = 0;
+    uint32_t currentFrame = 0;
+};
+
+// 作用域事件：recorder 为 nullptr 或未启用时不记录
+class TraceScope {
+public:
+    TraceScope(TraceRecorder* recorder, const char* name, const char* category = "app")
+        : owner(recorder && recorder->enabled() ? recorder : nullptr), eventName(name), eventCategory(category) {
+        if (owner) start = TraceRecorder::Clock::now();
+    }
+    ~TraceScope() {
+        if (owner) owner->record(eventName, eventCategory, start, TraceRecorder::Clock::now(), owner->frame());
+    }
+
+private:
+    TraceScope(const TraceScope&);
+    TraceScope& operator=(const TraceScope&);
+    TraceRecorder* owner;
+    const char* eventName;
+    const char* eventCategory;
+    TraceRecorder::Clock::time_point start;
+};
+
+} // namespace Core
@@ -0,0 +1,38 @@
+#pragma once
+#include "InstanceStore.h"
+#include <vector>
+#include <cstdint>
+
+namespace Core {
+
+// 每帧 MVP 缓存：以相机 VP 版本号与 InstanceStore 的版本号为键。
+// - VP 与静态实例都未变化时，静态实例完全跳过，只重算变换版本号变化的动态实例
+// - VP 或静态数据变化时整体批量重算
+// 同一帧内的各个渲染通道共享结果，每个 MVP 每帧最多计算一次
+class TransformCache {
+public:
+    void update(const float vp[16], uint32_t vpVersion, const InstanceStore& instances);
+
+    // 缓存是否对应这份 VP 与实例数据（store 在 update 之后未被修改）
+    bool isValidFor(const float vp[16], const InstanceStore& instances) const;
+
+    // 按实例下标寻址：第 idx 个实例的 MVP 位于 [idx * 16]
+    const float* mvps() const { return mvpData.data(); }
+
+    // 最近一次 update 实际重算的矩阵数量（调试/统计用）
+    uint32_t lastRecomputeCount() const { return recomputeCount; }
+
+private:
+    std::vector<float> mvpData;
+    std::vector<uint32_t> dynamicIndices;   // 非静态实例下标，整体重算时重建
+    std::vector<uint32_t> dynamicVersions;  // 与 dynamicIndices 对应的已缓存版本号
+
+    const InstanceStore* cachedStore = nullptr;
+    float cachedVp[16];
+    uint32_t cachedVpVersion = 0;
+    uint32_t cachedStaticVersion = 0;
+    uint32_t cachedDynamicVersion = 0;
+    uint32_t recomputeCount = 0;
+};
+
+} // namespace Core
@@ -0,0 +1,37 @@
+#pragma once
+#ifdef USE_DESKTOP_GL
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+#include <cstdint>
+
+namespace Core {
+
+// std140 uniform 数据的环形缓冲：每次 upload 追加在上一次之后，空间不足时 orphan 整个缓冲
+// （glBufferData(nullptr)）从头开始，驱动为仍在使用旧内容的绘制保留原存储，CPU 不需要等待 GPU。
+// 调用方按 stride() 排列记录，绘制前用 glBindBufferRange 绑定各自的区间
+class UniformRing {
+public:
+    // 需要当前 GL 上下文；capacity 为初始字节数，单次上传超过时自动扩容
+    bool init(GLsizeiptr capacity);
+    void shutdown();
+    bool ready() const { return ubo != 0; }
+
+    GLuint buffer() const { return ubo; }
+    // size 字节的记录按 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 对齐后的间距
+    GLsizeiptr stride(GLsizeiptr size) const;
+    // 拷贝 size 字节，返回在缓冲中的起始偏移（已对齐）
+    GLintptr upload(const void* data, GLsizeiptr size);
+    // 每次 orphan 加一：之前上传的区间在新存储中不再有效，需要重新上传
+    uint32_t generation() const { return orphans; }
+
+private:
+    GLuint ubo = 0;
+    GLsizeiptr capacity = 0;
+    GLintptr cursor = 0;
+    GLint alignment = 256;
+    uint32_t orphans = 0;
+};
+
+} // namespace Core
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Core {
+
+// GPU 端网格顶点的压缩格式。CPU 端（Mesh::getVertices，合批、软件光栅、烘焙使用）始终是 6 个 float
+enum PositionFormat : uint8_t {
+    POSITION_FLOAT32,   // 3 x float，12 字节
+    POSITION_HALF,      // 3 x half + 2 字节填充，8 字节
+    POSITION_SNORM16,   // 3 x int16 + 填充，8 字节；按网格包围盒量化到 [-32767, 32767]，scale / bias 反量化
+};
+
+enum NormalFormat : uint8_t {
+    NORMAL_FLOAT32,     // 3 x float，12 字节
+    NORMAL_OCT8,        // 八面体编码 2 x int8 归一化 + 填充，4 字节
+    NORMAL_OCT16,       // 八面体编码 2 x int16 归一化，4 字节
+};
+
+// 位置在前、法线在后，两段都按 4 字节对齐
+struct VertexLayout {
+    PositionFormat position = POSITION_FLOAT32;
+    NormalFormat normal = NORMAL_FLOAT32;
+
+    uint32_t normalOffset() const { return position == POSITION_FLOAT32 ? 12 : 8; }
+    uint32_t stride() const { return normalOffset() + (normal == NORMAL_FLOAT32 ? 12 : 4); }
+    bool octNormals() const { return normal != NORMAL_FLOAT32; }
+};
+
+// 预设名：float（24 字节，未压缩）、half（half 位置 + oct8 法线，12 字节）、
+// compact（snorm16 位置 + oct16 法线，12 字节）
+bool parseVertexLayout(const std::string& name, VertexLayout& out);
+const char* vertexLayoutName(const VertexLayout& layout);
+
+// 一个网格的编码参数与实测误差
+struct VertexEncoding {
+    // 位置 = 存储值 * scale + bias（float / half 格式为 1 和 0）。snorm16 以非归一化整数上传，
+    // 1/32767 并入 scale：GL 3.3 与 GLES 3 的有符号归一化转换规则不同，这样两边结果一致
+    float positionScale[3] = {1.0f, 1.0f, 1.0f};
+    float positionBias[3] = {0.0f, 0.0f, 0.0f};
+    // 解码结果与原始数据的最大误差：位置为逐分量绝对误差（局部空间单位），法线为夹角（度）
+    float maxPositionError = 0.0f;
+    float maxNormalError = 0.0f;
+};
+
+// verts 为 (px, py, pz, nx, ny, nz) x vertexCount，写入 vertexCount * layout.stride() 字节到 out。
+// 八面体编码在四个相邻量化点中取解码误差最小的一个
+VertexEncoding encodeVertices(const float* verts, size_t vertexCount, const VertexLayout& layout, uint8_t* out);
+// 按着色器的规则解码一个顶点（误差统计与离线检查用），法线已归一化
+void decodeVertex(const uint8_t* in, const VertexLayout& layout, const VertexEncoding& encoding, float out[6]);
+
+// IEEE 754 binary16，就近舍入到偶数
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t value);
+
+} // namespace Core
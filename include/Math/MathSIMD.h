@@ -0,0 +1,22 @@
+#pragma once
+
+// 向量化矩阵内核：树莓派上使用 NEON，x86 上使用 SSE（开启 -mavx 时批量接口使用 AVX），
+// 其余平台（或定义 PI_MATH_SCALAR 时）退回标量实现。所有矩阵均为 OpenGL 列主序。
+
+// 当前编译使用的实现："NEON" / "AVX" / "SSE" / "Scalar"
+const char* mathSIMDBackendName();
+
+// result = a * b；result 可以与 a 或 b 指向同一数组
+void multiplyMatricesSIMD(const float a[16], const float b[16], float result[16]);
+
+// 标量参考实现（原 MathTool 的三重循环），作为无 SIMD 平台的回退与正确性对照
+void multiplyMatricesScalar(const float a[16], const float b[16], float result[16]);
+
+// 批量：out[i*16..] = vp * models[i*16..]，models 与 out 为连续的 count 个矩阵
+void multiplyMatricesBatch(const float vp[16], const float* models, int count, float* out);
+
+// 批量：models 为指针数组（兼容各自独立存放的矩阵），输出仍为连续数组
+void multiplyMatricesBatch(const float vp[16], const float* const* models, int count, float* out);
+
+// 仿射矩阵（最后一行为 0,0,0,1）快速求逆：3x3 伴随矩阵 + 平移，不可逆时返回 false
+bool invertAffineMatrix(const float m[16], float inv[16]);
@@ -0,0 +1,277 @@
+#include "Core/Culling.h"
+#include "Math/MathTool.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+
+namespace Core {
+
+// 单个实例最多登记的格子数，超过则放入 largeItems（例如地板）
+static const int kMaxCellsPerItem = 16;
+
+void Frustum::extract(const float vp[16]) {
+    // 列主序：第 r 行为 (vp[r], vp[4+r], vp[8+r], vp[12+r])
+    for (int i = 0; i < 3; ++i) {
+        for (int k = 0; k < 4; ++k) {
+            float row3 = vp[k * 4 + 3];
+            float rowI = vp[k * 4 + i];
+            planes[i * 2 + 0][k] = row3 + rowI; // 左 / 下 / 近
+            planes[i * 2 + 1][k] = row3 - rowI; // 右 / 上 / 远
+        }
+    }
+    for (int p = 0; p < 6; ++p) {
+        float len = sqrtf(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]);
+        if (len > 0.0f) {
+            for (int k = 0; k < 4; ++k) planes[p][k] /= len;
+        }
+    }
+}
+
+bool Frustum::intersectsAABB(const float boundsMin[3], const float boundsMax[3]) const {
+    for (int p = 0; p < 6; ++p) {
+        const float* pl = planes[p];
+        // 取沿平面法线方向最远的角点
+        float x = pl[0] >= 0.0f ? boundsMax[0] : boundsMin[0];
+        float y = pl[1] >= 0.0f ? boundsMax[1] : boundsMin[1];
+        float z = pl[2] >= 0.0f ? boundsMax[2] : boundsMin[2];
+        if (pl[0] * x + pl[1] * y + pl[2] * z + pl[3] < 0.0f) return false;
+    }
+    return true;
+}
+
+// 局部 AABB 经仿射变换后的世界 AABB：中心直接变换，半长取 |M| * extent
+void instanceWorldBounds(const InstanceStore& instances, uint32_t idx, float boundsMin[3], float boundsMax[3]) {
+    const float* m = instances.modelMatrices() + idx * 16;
+    const Mesh* mesh = instances.mesh(instances.meshIds()[idx]);
+    const float* localMin = mesh->boundsMin();
+    const float* localMax = mesh->boundsMax();
+    float c[3], e[3];
+    for (int k = 0; k < 3; ++k) {
+        c[k] = (localMin[k] + localMax[k]) * 0.5f;
+        e[k] = (localMax[k] - localMin[k]) * 0.5f;
+    }
+    for (int r = 0; r < 3; ++r) {
+        float wc = m[12 + r] + m[r] * c[0] + m[4 + r] * c[1] + m[8 + r] * c[2];
+        float we = fabsf(m[r]) * e[0] + fabsf(m[4 + r]) * e[1] + fabsf(m[8 + r]) * e[2];
+        boundsMin[r] = wc - we;
+        boundsMax[r] = wc + we;
+    }
+}
+
+void ScreenRect::unite(const ScreenRect& other) {
+    if (other.empty()) return;
+    if (empty()) {
+        *this = other;
+        return;
+    }
+    x0 = std::min(x0, other.x0);
+    y0 = std::min(y0, other.y0);
+    x1 = std::max(x1, other.x1);
+    y1 = std::max(y1, other.y1);
+}
+
+bool ScreenRect::overlaps(const ScreenRect& other) const {
+    return !empty() && !other.empty() &&
+           x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1;
+}
+
+ScreenRect ScreenRect::full(int width, int height) {
+    ScreenRect r;
+    r.x1 = width;
+    r.y1 = height;
+    return r;
+}
+
+ScreenRect projectBounds(const float vp[16], const float boundsMin[3], const float boundsMax[3], int width, int height) {
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int corner = 0; corner < 8; ++corner) {
+        float p[3] = {(corner & 1) ? boundsMax[0] : boundsMin[0],
+                      (corner & 2) ? boundsMax[1] : boundsMin[1],
+                      (corner & 4) ? boundsMax[2] : boundsMin[2]};
+        float w = vp[3] * p[0] + vp[7] * p[1] + vp[11] * p[2] + vp[15];
+        if (w <= 1e-6f) return ScreenRect::full(width, height);
+        float x = (vp[0] * p[0] + vp[4] * p[1] + vp[8] * p[2] + vp[12]) / w;
+        float y = (vp[1] * p[0] + vp[5] * p[1] + vp[9] * p[2] + vp[13]) / w;
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+    }
+    // NDC -> 像素，先在浮点域夹到视口附近避免整数溢出
+    auto toPixel = [](float ndc, int size) {
+        return std::min(std::max((ndc * 0.5f + 0.5f) * size, -1.0f), (float)size + 1.0f);
+    };
+    ScreenRect r;
+    r.x0 = (int)floorf(toPixel(minX, width)) - 1;
+    r.y0 = (int)floorf(toPixel(minY, height)) - 1;
+    r.x1 = (int)ceilf(toPixel(maxX, width)) + 1;
+    r.y1 = (int)ceilf(toPixel(maxY, height)) + 1;
+    r.x0 = std::max(r.x0, 0);
+    r.y0 = std::max(r.y0, 0);
+    r.x1 = std::min(r.x1, width);
+    r.y1 = std::min(r.y1, height);
+    return r;
+}
+
+void CullingGrid::setGrid(float originX, float originY, float cellSize) {
+    gridOriginX = originX;
+    gridOriginY = originY;
+    gridCellSize = cellSize > 0.0f ? cellSize : 1.0f;
+    built = false;
+}
+
+void CullingGrid::rebuild(const InstanceStore& instances) {
+    const uint32_t count = (uint32_t)instances.size();
+    const unsigned int* layers = instances.layers();
+    staticBounds.assign(count * 6, 0.0f);
+    dynamicItems.clear();
+    largeItems.clear();
+    visitStamp.assign(count, 0);
+    currentStamp = 0;
+
+    // 1) 静态实例的世界包围盒与整体格子范围
+    std::vector<int> itemRect;   // 每个静态实例的格子矩形 x0, y0, x1, y1
+    itemRect.assign(count * 4, 0);
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    const float invCell = 1.0f / gridCellSize;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!(layers[i] & LAYER_STATIC)) {
+            dynamicItems.push_back(i);
+            continue;
+        }
+        float* b = &staticBounds[i * 6];
+        instanceWorldBounds(instances, i, b, b + 3);
+        int* r = &itemRect[i * 4];
+        r[0] = (int)floorf((b[0] - gridOriginX) * invCell);
+        r[1] = (int)floorf((b[1] - gridOriginY) * invCell);
+        r[2] = (int)floorf((b[3] - gridOriginX) * invCell);
+        r[3] = (int)floorf((b[4] - gridOriginY) * invCell);
+        if ((r[2] - r[0] + 1) * (r[3] - r[1] + 1) > kMaxCellsPerItem) {
+            largeItems.push_back(i);
+            continue;
+        }
+        minX = std::min(minX, r[0]); minY = std::min(minY, r[1]);
+        maxX = std::max(maxX, r[2]); maxY = std::max(maxY, r[3]);
+    }
+
+    cellItems.clear();
+    if (minX > maxX) {
+        cellsX = cellsY = 0;
+        cellStart.assign(1, 0);
+    } else {
+        cellMinX = minX;
+        cellMinY = minY;
+        cellsX = maxX - minX + 1;
+        cellsY = maxY - minY + 1;
+
+        // 2) 计数排序写入 CSR：先统计每格数量，前缀和后再填充
+        cellStart.assign((std::size_t)cellsX * cellsY + 1, 0);
+        std::vector<char> isLarge(count, 0);
+        for (uint32_t i : largeItems) isLarge[i] = 1;
+        auto forEachCell = [&](uint32_t i, std::vector<uint32_t>& cursor, bool fill) {
+            const int* r = &itemRect[i * 4];
+            for (int y = r[1]; y <= r[3]; ++y) {
+                for (int x = r[0]; x <= r[2]; ++x) {
+                    std::size_t c = (std::size_t)(y - cellMinY) * cellsX + (x - cellMinX);
+                    if (fill) cellItems[cursor[c]++] = i;
+                    else ++cursor[c + 1];
+                }
+            }
+        };
+        for (uint32_t i = 0; i < count; ++i) {
+            if ((layers[i] & LAYER_STATIC) && !isLarge[i]) forEachCell(i, cellStart, false);
+        }
+        for (std::size_t c = 1; c < cellStart.size(); ++c) cellStart[c] += cellStart[c - 1];
+        cellItems.resize(cellStart.back());
+        std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+        for (uint32_t i = 0; i < count; ++i) {
+            if ((layers[i] & LAYER_STATIC) && !isLarge[i]) forEachCell(i, cursor, true);
+        }
+    }
+
+    builtStore = &instances;
+    builtVersion = instances.staticVersion();
+    built = true;
+}
+
+void CullingGrid::testInstance(const Frustum& frustum, const InstanceStore& instances, uint32_t idx,
+                               unsigned int layerMask, const float* boundsMin, const float* boundsMax,
+                               std::vector<uint32_t>& out) {
+    if (!(instances.layers()[idx] & layerMask)) return;
+    ++testedCount;
+    if (frustum.intersectsAABB(boundsMin, boundsMax)) out.push_back(idx);
+}
+
+void CullingGrid::query(const float vp[16], const InstanceStore& instances, unsigned int layerMask, std::vector<uint32_t>& out) {
+    out.clear();
+    testedCount = 0;
+    if (!built || builtStore != &instances || builtVersion != instances.staticVersion()) {
+        rebuild(instances);
+    }
+
+    Frustum frustum;
+    frustum.extract(vp);
+
+    // 查询序号回绕时清零，避免误判为已访问
+    if (++currentStamp == 0) {
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        currentStamp = 1;
+    }
+
+    // 1) 视锥 8 个角点反投影到世界空间，取 XY 包围矩形对应的格子范围
+    int qx0 = cellMinX, qy0 = cellMinY, qx1 = cellMinX + cellsX - 1, qy1 = cellMinY + cellsY - 1;
+    float invVP[16];
+    if (invertMatrix(vp, invVP)) {
+        float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+        bool valid = true;
+        for (int corner = 0; corner < 8 && valid; ++corner) {
+            float ndc[3] = {(corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f};
+            float w = invVP[3] * ndc[0] + invVP[7] * ndc[1] + invVP[11] * ndc[2] + invVP[15];
+            if (w <= 0.0f) { valid = false; break; }
+            float x = (invVP[0] * ndc[0] + invVP[4] * ndc[1] + invVP[8] * ndc[2] + invVP[12]) / w;
+            float y = (invVP[1] * ndc[0] + invVP[5] * ndc[1] + invVP[9] * ndc[2] + invVP[13]) / w;
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+        }
+        if (valid) {
+            const float invCell = 1.0f / gridCellSize;
+            // 先在浮点域夹到网格范围，避免超大远平面导致整数溢出
+            float fx0 = std::max((minX - gridOriginX) * invCell, (float)cellMinX - 1.0f);
+            float fy0 = std::max((minY - gridOriginY) * invCell, (float)cellMinY - 1.0f);
+            float fx1 = std::min((maxX - gridOriginX) * invCell, (float)(cellMinX + cellsX));
+            float fy1 = std::min((maxY - gridOriginY) * invCell, (float)(cellMinY + cellsY));
+            qx0 = std::max(qx0, (int)floorf(fx0));
+            qy0 = std::max(qy0, (int)floorf(fy0));
+            qx1 = std::min(qx1, (int)floorf(fx1));
+            qy1 = std::min(qy1, (int)floorf(fy1));
+        }
+    }
+
+    // 2) 覆盖格子内的静态实例
+    for (int y = qy0; y <= qy1; ++y) {
+        for (int x = qx0; x <= qx1; ++x) {
+            std::size_t c = (std::size_t)(y - cellMinY) * cellsX + (x - cellMinX);
+            for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                uint32_t idx = cellItems[k];
+                if (visitStamp[idx] == currentStamp) continue;
+                visitStamp[idx] = currentStamp;
+                testInstance(frustum, instances, idx, layerMask, &staticBounds[idx * 6], &staticBounds[idx * 6 + 3], out);
+            }
+        }
+    }
+
+    // 3) 大物体与动态实例逐个测试（动态实例的包围盒按当前变换计算）
+    for (uint32_t idx : largeItems) {
+        testInstance(frustum, instances, idx, layerMask, &staticBounds[idx * 6], &staticBounds[idx * 6 + 3], out);
+    }
+    for (uint32_t idx : dynamicItems) {
+        float b[6];
+        instanceWorldBounds(instances, idx, b, b + 3);
+        testInstance(frustum, instances, idx, layerMask, b, b + 3, out);
+    }
+
+    // 保持下标升序，与不裁剪时的提交顺序一致
+    std::sort(out.begin(), out.end());
+    visibleCount = (uint32_t)out.size();
+}
+
+} // namespace Core
@@ -0,0 +1,287 @@
+#include "Core/GLState.h"
+#include <cstring>
+
+namespace Core {
+
+static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+enum UniformKind : uint8_t { U_INT, U_FLOAT, U_MAT3, U_MAT4 };
+
+GLStateCache& glState() {
+    static GLStateCache cache;
+    return cache;
+}
+
+void GLStateCache::invalidate() {
+    program = UNKNOWN;
+    framebuffer = UNKNOWN;
+    view[0] = view[1] = view[2] = view[3] = -1;
+    activeUnit = -1;
+    for (int i = 0; i < MAX_TEXTURE_UNITS; ++i) textures[i] = UNKNOWN;
+    arrayBuffer = UNKNOWN;
+    uniformBuffer = UNKNOWN;
+    for (int i = 0; i < MAX_UNIFORM_BINDINGS; ++i) {
+        uniformRanges[i].buffer = UNKNOWN;
+        uniformRanges[i].offset = -1;
+        uniformRanges[i].size = -1;
+    }
+    elementBuffer = UNKNOWN;
+#ifdef USE_DESKTOP_GL
+    vertexArray = UNKNOWN;
+#else
+    vertexArray = 0; // GLES 路径从不绑定 VAO，属性状态总在默认 VAO 上
+#endif
+    for (int i = 0; i < MAX_ATTRIBS; ++i) {
+        attribs[i].buffer = UNKNOWN;
+        attribs[i].size = -1;
+        attribs[i].stride = -1;
+        attribs[i].offset = -1;
+        attribs[i].type = GL_NONE;
+        attribs[i].normalized = GL_FALSE;
+        attribs[i].divisor = UNKNOWN;
+        attribs[i].enabled = -1;
+        attribConstantKnown[i] = false;
+    }
+    uniforms.clear();
+}
+
+bool GLStateCache::elide(bool same) {
+    if (same) {
+        ++current.elided;
+    } else {
+        ++current.issued;
+    }
+    return same;
+}
+
+void GLStateCache::newFrame() {
+    previous = current;
+    current = Stats();
+}
+
+void GLStateCache::useProgram(GLuint p) {
+    if (elide(program == p)) return;
+    glUseProgram(p);
+    program = p;
+}
+
+void GLStateCache::bindFramebuffer(GLuint fbo) {
+    if (elide(framebuffer == fbo)) return;
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    framebuffer = fbo;
+}
+
+void GLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (elide(view[0] == x && view[1] == y && view[2] == width && view[3] == height)) return;
+    glViewport(x, y, width, height);
+    view[0] = x;
+    view[1] = y;
+    view[2] = width;
+    view[3] = height;
+}
+
+void GLStateCache::bindTexture(int unit, GLuint texture) {
+    if (unit < 0 || unit >= MAX_TEXTURE_UNITS) {
+        ++current.issued;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        activeUnit = unit;
+        return;
+    }
+    if (elide(textures[unit] == texture)) return;
+    if (activeUnit != unit) {
+        ++current.issued;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    textures[unit] = texture;
+}
+
+void GLStateCache::bindArrayBuffer(GLuint buffer) {
+    if (elide(arrayBuffer == buffer)) return;
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    arrayBuffer = buffer;
+}
+
+void GLStateCache::bindUniformBuffer(GLuint buffer) {
+    if (elide(uniformBuffer == buffer)) return;
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    uniformBuffer = buffer;
+}
+
+void GLStateCache::bindUniformBufferRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    if (index < (GLuint)MAX_UNIFORM_BINDINGS) {
+        UniformRange& r = uniformRanges[index];
+        if (elide(r.buffer == buffer && r.offset == offset && r.size == size)) return;
+        r.buffer = buffer;
+        r.offset = offset;
+        r.size = size;
+    } else {
+        ++current.issued;
+    }
+    glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+    uniformBuffer = buffer;
+}
+
+void GLStateCache::bindElementBuffer(GLuint buffer) {
+    if (vertexArray != 0) {
+        ++current.issued;
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+        return;
+    }
+    if (elide(elementBuffer == buffer)) return;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    elementBuffer = buffer;
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+#ifdef USE_DESKTOP_GL
+    if (elide(vertexArray == vao)) return;
+    glBindVertexArray(vao);
+    vertexArray = vao;
+#else
+    (void)vao;
+#endif
+}
+
+void GLStateCache::vertexAttribPointer(GLuint index, GLint size, GLsizei stride, GLintptr offset,
+                                       GLenum type, GLboolean normalized) {
+    bool cacheable = vertexArray == 0 && arrayBuffer != UNKNOWN && index < (GLuint)MAX_ATTRIBS;
+    if (cacheable) {
+        Attrib& a = attribs[index];
+        if (elide(a.buffer == arrayBuffer && a.size == size && a.stride == stride && a.offset == offset &&
+                  a.type == type && a.normalized == normalized)) return;
+        a.buffer = arrayBuffer;
+        a.size = size;
+        a.stride = stride;
+        a.offset = offset;
+        a.type = type;
+        a.normalized = normalized;
+    } else {
+        ++current.issued;
+        if (vertexArray == 0 && index < (GLuint)MAX_ATTRIBS) attribs[index].buffer = UNKNOWN;
+    }
+    glVertexAttribPointer(index, size, type, normalized, stride, (const void*)offset);
+}
+
+void GLStateCache::enableVertexAttrib(GLuint index) {
+    bool cacheable = vertexArray == 0 && index < (GLuint)MAX_ATTRIBS;
+    if (cacheable) {
+        if (elide(attribs[index].enabled == 1)) return;
+        attribs[index].enabled = 1;
+    } else {
+        ++current.issued;
+    }
+    glEnableVertexAttribArray(index);
+}
+
+void GLStateCache::disableVertexAttrib(GLuint index) {
+    bool cacheable = vertexArray == 0 && index < (GLuint)MAX_ATTRIBS;
+    if (cacheable) {
+        if (elide(attribs[index].enabled == 0)) return;
+        attribs[index].enabled = 0;
+    } else {
+        ++current.issued;
+    }
+    glDisableVertexAttribArray(index);
+}
+
+void GLStateCache::disableVertexAttribsFrom(GLuint first) {
+    if (vertexArray != 0) return;
+    for (GLuint i = first; i < (GLuint)MAX_ATTRIBS; ++i) {
+        if (attribs[i].enabled == 0) continue;
+        ++current.issued;
+        glDisableVertexAttribArray(i);
+        attribs[i].enabled = 0;
+    }
+}
+
+void GLStateCache::vertexAttribDivisor(GLuint index, GLuint divisor) {
+    bool cacheable = vertexArray == 0 && index < (GLuint)MAX_ATTRIBS;
+    if (cacheable) {
+        if (elide(attribs[index].divisor == divisor)) return;
+        attribs[index].divisor = divisor;
+    } else {
+        ++current.issued;
+    }
+    glVertexAttribDivisor(index, divisor);
+}
+
+void GLStateCache::vertexAttrib4fv(GLuint index, const GLfloat* v) {
+    if (index < (GLuint)MAX_ATTRIBS) {
+        if (elide(attribConstantKnown[index] && memcmp(attribConstants[index], v, 4 * sizeof(GLfloat)) == 0)) return;
+        memcpy(attribConstants[index], v, 4 * sizeof(GLfloat));
+        attribConstantKnown[index] = true;
+    } else {
+        ++current.issued;
+    }
+    glVertexAttrib4fv(index, v);
+}
+
+bool GLStateCache::uniformChanged(GLint location, uint8_t kind, const void* data, int words) {
+    if (program == UNKNOWN) {
+        ++current.issued;
+        return true;
+    }
+    uint64_t key = ((uint64_t)program << 32) | (uint32_t)location;
+    auto it = uniforms.find(key);
+    if (it != uniforms.end()) {
+        UniformValue& v = it->second;
+        if (elide(v.kind == kind && v.count == words && memcmp(v.words, data, words * 4) == 0)) return false;
+        v.kind = kind;
+        v.count = (uint8_t)words;
+        memcpy(v.words, data, words * 4);
+        return true;
+    }
+    ++current.issued;
+    UniformValue& v = uniforms[key];
+    v.kind = kind;
+    v.count = (uint8_t)words;
+    memcpy(v.words, data, words * 4);
+    return true;
+}
+
+void GLStateCache::uniform1i(GLint location, GLint x) {
+    if (location < 0) return;
+    if (uniformChanged(location, U_INT, &x, 1)) glUniform1i(location, x);
+}
+
+void GLStateCache::uniform2i(GLint location, GLint x, GLint y) {
+    if (location < 0) return;
+    GLint v[2] = {x, y};
+    if (uniformChanged(location, U_INT, v, 2)) glUniform2i(location, x, y);
+}
+
+void GLStateCache::uniform1f(GLint location, GLfloat x) {
+    if (location < 0) return;
+    if (uniformChanged(location, U_FLOAT, &x, 1)) glUniform1f(location, x);
+}
+
+void GLStateCache::uniform2f(GLint location, GLfloat x, GLfloat y) {
+    if (location < 0) return;
+    GLfloat v[2] = {x, y};
+    if (uniformChanged(location, U_FLOAT, v, 2)) glUniform2f(location, x, y);
+}
+
+void GLStateCache::uniform3fv(GLint location, const GLfloat* v) {
+    if (location < 0) return;
+    if (uniformChanged(location, U_FLOAT, v, 3)) glUniform3fv(location, 1, v);
+}
+
+void GLStateCache::uniform4fv(GLint location, const GLfloat* v) {
+    if (location < 0) return;
+    if (uniformChanged(location, U_FLOAT, v, 4)) glUniform4fv(location, 1, v);
+}
+
+void GLStateCache::uniformMatrix3fv(GLint location, const GLfloat* m) {
+    if (location < 0) return;
+    if (uniformChanged(location, U_MAT3, m, 9)) glUniformMatrix3fv(location, 1, GL_FALSE, m);
+}
+
+void GLStateCache::uniformMatrix4fv(GLint location, const GLfloat* m) {
+    if (location < 0) return;
+    if (uniformChanged(location, U_MAT4, m, 16)) glUniformMatrix4fv(location, 1, GL_FALSE, m);
+}
+
+} // namespace Core
@@ -0,0 +1,273 @@
+#include "Core/GeometryArena.h"
+#include "Core/GLState.h"
+#include "Core/Mesh.h"
+#include <algorithm>
+
+namespace Core {
+
+// 首次分配时的容量：示例场景的全部网格约 600 个顶点
+static const uint32_t INITIAL_VERTICES = 4096;
+static const uint32_t INITIAL_INDICES = 16384;
+
+GeometryArena& geometryArena() {
+    static GeometryArena arena;
+    return arena;
+}
+
+// 位置 / 法线属性指针，offset 为第一个顶点的字节偏移
+static void setVertexAttribs(const VertexLayout& layout, GLintptr offset) {
+    const GLsizei stride = (GLsizei)layout.stride();
+    GLenum positionType = GL_FLOAT;
+    if (layout.position == POSITION_HALF) positionType = GL_HALF_FLOAT;
+    if (layout.position == POSITION_SNORM16) positionType = GL_SHORT; // 非归一化，1/32767 在 scale 中
+    GLint normalSize = layout.octNormals() ? 2 : 3;
+    GLenum normalType = GL_FLOAT;
+    if (layout.normal == NORMAL_OCT8) normalType = GL_BYTE;
+    if (layout.normal == NORMAL_OCT16) normalType = GL_SHORT;
+    const GLboolean normalNormalized = layout.octNormals() ? GL_TRUE : GL_FALSE;
+    const GLintptr normalOffset = offset + layout.normalOffset();
+#ifdef USE_DESKTOP_GL
+    glVertexAttribPointer(0, 3, positionType, GL_FALSE, stride, (const void*)offset);
+    glVertexAttribPointer(1, normalSize, normalType, normalNormalized, stride, (const void*)normalOffset);
+#else
+    GLStateCache& gl = glState();
+    gl.vertexAttribPointer(0, 3, stride, offset, positionType, GL_FALSE);
+    gl.vertexAttribPointer(1, normalSize, stride, normalOffset, normalType, normalNormalized);
+#endif
+}
+
+bool GeometryArena::setLayout(const VertexLayout& layout) {
+    if (liveMeshes > 0) return false;
+    vertexLayout = layout;
+    return true;
+}
+
+uint32_t GeometryArena::allocate(const float* verts, uint32_t vertexCount, const unsigned short* idxs, uint32_t indexCount) {
+    encodeScratch.resize((size_t)vertexCount * vertexLayout.stride());
+    VertexEncoding encoding = encodeVertices(verts, vertexCount, vertexLayout, encodeScratch.data());
+    return allocateEncoded(encodeScratch.data(), vertexCount, encoding, idxs, indexCount);
+}
+
+uint32_t GeometryArena::allocateEncoded(const uint8_t* data, uint32_t vertexCount, const VertexEncoding& encoding,
+                                        const unsigned short* idxs, uint32_t indexCount) {
+    if (!vbo) relocate(std::max(INITIAL_VERTICES, vertexCount), std::max(INITIAL_INDICES, indexCount));
+
+    uint32_t baseVertex = 0, firstIndex = 0;
+    bool fits = takeBlock(freeVertices, vertexCount, baseVertex);
+    if (fits && !takeBlock(freeIndices, indexCount, firstIndex)) {
+        returnBlock(freeVertices, baseVertex, vertexCount);
+        fits = false;
+    }
+    if (!fits) {
+        // 搬迁时紧凑排列，之后所有空闲空间都在末尾
+        Stats s = stats();
+        relocate(std::max(vertexCapacity * 2, s.usedVertices + vertexCount),
+                 std::max(indexCapacity * 2, s.usedIndices + indexCount));
+        takeBlock(freeVertices, vertexCount, baseVertex);
+        takeBlock(freeIndices, indexCount, firstIndex);
+    }
+
+    const uint32_t stride = vertexLayout.stride();
+    // 通过 COPY_WRITE 目标上传，不影响状态缓存记录的 ARRAY / ELEMENT_ARRAY 绑定（以及桌面 GL 当前 VAO）
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)baseVertex * stride,
+                    (GLsizeiptr)vertexCount * stride, data);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)firstIndex * sizeof(unsigned short),
+                    (GLsizeiptr)indexCount * sizeof(unsigned short), idxs);
+
+    uint32_t handle;
+    if (!freeSlots.empty()) {
+        handle = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        handle = (uint32_t)slots.size();
+        slots.emplace_back();
+    }
+    Slot& slot = slots[handle];
+    slot.range.baseVertex = baseVertex;
+    slot.range.vertexCount = vertexCount;
+    slot.range.firstIndex = firstIndex;
+    slot.range.indexCount = indexCount;
+    slot.encoding = encoding;
+    slot.live = true;
+    ++liveMeshes;
+    return handle;
+}
+
+void GeometryArena::release(uint32_t handle) {
+    if (handle >= slots.size() || !slots[handle].live) return;
+    Slot& slot = slots[handle];
+    returnBlock(freeVertices, slot.range.baseVertex, slot.range.vertexCount);
+    returnBlock(freeIndices, slot.range.firstIndex, slot.range.indexCount);
+    slot.live = false;
+    slot.range = GeometryRange();
+    freeSlots.push_back(handle);
+    if (--liveMeshes == 0) destroy();
+}
+
+void GeometryArena::defragment() {
+    if (vbo) relocate(vertexCapacity, indexCapacity);
+}
+
+void GeometryArena::bind(uint32_t handle) {
+    GLStateCache& gl = glState();
+#ifdef USE_DESKTOP_GL
+    gl.bindVertexArray(vao);
+#else
+    gl.bindArrayBuffer(vbo);
+    gl.bindElementBuffer(ebo);
+    // 同一网格连续绘制时由 GLStateCache 跳过
+    setVertexAttribs(vertexLayout, (GLintptr)slots[handle].range.baseVertex * vertexLayout.stride());
+    gl.enableVertexAttrib(0);
+    gl.enableVertexAttrib(1);
+#endif
+    if (vertexLayout.position == POSITION_SNORM16) {
+        const VertexEncoding& e = slots[handle].encoding;
+        const GLfloat scale[4] = {e.positionScale[0], e.positionScale[1], e.positionScale[2], 0.0f};
+        const GLfloat bias[4] = {e.positionBias[0], e.positionBias[1], e.positionBias[2], 0.0f};
+        gl.vertexAttrib4fv(POSITION_SCALE_ATTRIB, scale);
+        gl.vertexAttrib4fv(POSITION_BIAS_ATTRIB, bias);
+    }
+}
+
+#ifdef USE_DESKTOP_GL
+void GeometryArena::disableInstanceAttribs() {
+    if (!instanceAttribsEnabled) return;
+    for (int i = 0; i < INSTANCE_ATTRIB_VEC4_COUNT; ++i) {
+        glDisableVertexAttribArray(INSTANCE_ATTRIB_FIRST + i);
+    }
+    instanceAttribsEnabled = false;
+}
+#endif
+
+GeometryArena::Stats GeometryArena::stats() const {
+    Stats s;
+    s.meshes = liveMeshes;
+    s.vertexCapacity = vertexCapacity;
+    s.indexCapacity = indexCapacity;
+    s.usedVertices = vertexCapacity;
+    s.usedIndices = indexCapacity;
+    for (const Block& b : freeVertices) s.usedVertices -= b.count;
+    for (const Block& b : freeIndices) s.usedIndices -= b.count;
+    s.freeBlocks = (uint32_t)(freeVertices.size() + freeIndices.size());
+    s.vertexStride = vertexLayout.stride();
+    for (const Slot& slot : slots) {
+        if (!slot.live) continue;
+        s.maxPositionError = std::max(s.maxPositionError, slot.encoding.maxPositionError);
+        s.maxNormalError = std::max(s.maxNormalError, slot.encoding.maxNormalError);
+    }
+    return s;
+}
+
+// 首次适配；空区间（count 为 0）总是成功
+bool GeometryArena::takeBlock(std::vector<Block>& blocks, uint32_t count, uint32_t& offset) {
+    if (count == 0) {
+        offset = 0;
+        return true;
+    }
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        Block& b = blocks[i];
+        if (b.count < count) continue;
+        offset = b.offset;
+        b.offset += count;
+        b.count -= count;
+        if (b.count == 0) blocks.erase(blocks.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+void GeometryArena::returnBlock(std::vector<Block>& blocks, uint32_t offset, uint32_t count) {
+    if (count == 0) return;
+    auto it = std::lower_bound(blocks.begin(), blocks.end(), offset,
+                               [](const Block& b, uint32_t o) { return b.offset < o; });
+    it = blocks.insert(it, Block{offset, count});
+    // 与后一个、前一个相邻区间合并
+    auto next = it + 1;
+    if (next != blocks.end() && it->offset + it->count == next->offset) {
+        it->count += next->count;
+        blocks.erase(next);
+    }
+    if (it != blocks.begin()) {
+        auto prev = it - 1;
+        if (prev->offset + prev->count == it->offset) {
+            prev->count += it->count;
+            blocks.erase(it);
+        }
+    }
+}
+
+void GeometryArena::relocate(uint32_t newVertexCapacity, uint32_t newIndexCapacity) {
+    const GLsizeiptr stride = vertexLayout.stride();
+    GLuint newVbo = 0, newEbo = 0;
+    glGenBuffers(1, &newVbo);
+    glGenBuffers(1, &newEbo);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newVbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newVertexCapacity * stride, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newEbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newIndexCapacity * sizeof(unsigned short), nullptr, GL_STATIC_DRAW);
+
+    // 缓冲之间复制（同一缓冲内源与目标区间重叠是错误，因此总是复制到新缓冲）
+    uint32_t vertexCursor = 0, indexCursor = 0;
+    for (Slot& slot : slots) {
+        if (!slot.live) continue;
+        GeometryRange& r = slot.range;
+        glBindBuffer(GL_COPY_READ_BUFFER, vbo);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, newVbo);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)r.baseVertex * stride,
+                            (GLintptr)vertexCursor * stride, (GLsizeiptr)r.vertexCount * stride);
+        glBindBuffer(GL_COPY_READ_BUFFER, ebo);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, newEbo);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)r.firstIndex * sizeof(unsigned short),
+                            (GLintptr)indexCursor * sizeof(unsigned short),
+                            (GLsizeiptr)r.indexCount * sizeof(unsigned short));
+        r.baseVertex = vertexCursor;
+        r.firstIndex = indexCursor;
+        vertexCursor += r.vertexCount;
+        indexCursor += r.indexCount;
+    }
+
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ebo) glDeleteBuffers(1, &ebo);
+    vbo = newVbo;
+    ebo = newEbo;
+    vertexCapacity = newVertexCapacity;
+    indexCapacity = newIndexCapacity;
+    freeVertices.clear();
+    freeIndices.clear();
+    if (vertexCursor < vertexCapacity) freeVertices.push_back(Block{vertexCursor, vertexCapacity - vertexCursor});
+    if (indexCursor < indexCapacity) freeIndices.push_back(Block{indexCursor, indexCapacity - indexCursor});
+
+#ifdef USE_DESKTOP_GL
+    // 共享 VAO 指向新缓冲；位置 / 法线从缓冲起点开始，baseVertex 由绘制调用给出
+    if (!vao) glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    setVertexAttribs(vertexLayout, 0);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+#endif
+    // 旧缓冲名可能被之后的 glGenBuffers 复用
+    glState().invalidate();
+}
+
+void GeometryArena::destroy() {
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ebo) glDeleteBuffers(1, &ebo);
+#ifdef USE_DESKTOP_GL
+    if (vao) glDeleteVertexArrays(1, &vao);
+    instanceAttribsEnabled = false;
+#endif
+    vbo = ebo = vao = 0;
+    vertexCapacity = indexCapacity = 0;
+    freeVertices.clear();
+    freeIndices.clear();
+    slots.clear();
+    freeSlots.clear();
+    glState().invalidate();
+}
+
+} // namespace Core
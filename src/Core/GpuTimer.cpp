@@ -0,0 +1,129 @@
+#include "Core/GpuTimer.h"
+#ifdef USE_DESKTOP_GL
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#include <EGL/egl.h>
+#endif
+#include <cstdio>
+#include <cstring>
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF // == GL_TIME_ELAPSED_EXT
+#endif
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+// 64 位结果：桌面 GL 3.3 为核心函数，GLES 由 EXT_disjoint_timer_query 提供
+#ifdef USE_DESKTOP_GL
+#define getQueryResult64 glGetQueryObjectui64v
+#else
+typedef void (GL_APIENTRYP QueryObjectui64vProc)(GLuint id, GLenum pname, GLuint64* params);
+static QueryObjectui64vProc getQueryResult64 = nullptr;
+#endif
+
+namespace Core {
+
+static bool hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (ext && strcmp(ext, name) == 0) return true;
+    }
+    return false;
+}
+
+GLTimerQueries::~GLTimerQueries() {
+    // 查询对象随上下文销毁；需要提前释放时调用 shutdown()
+}
+
+bool GLTimerQueries::init() {
+    shutdown();
+#ifdef USE_DESKTOP_GL
+    int major = 0, minor = 0;
+    const char* version = (const char*)glGetString(GL_VERSION);
+    if (version) sscanf(version, "%d.%d", &major, &minor);
+    ready = major > 3 || (major == 3 && minor >= 3) || hasExtension("GL_ARB_timer_query");
+    checkDisjoint = false;
+#else
+    getQueryResult64 = (QueryObjectui64vProc)eglGetProcAddress("glGetQueryObjectui64vEXT");
+    ready = getQueryResult64 && hasExtension("GL_EXT_disjoint_timer_query");
+    checkDisjoint = ready;
+#endif
+    if (!ready) return false;
+    for (int p = 0; p < PROFILE_PASS_COUNT; ++p) {
+        for (int s = 0; s < LATENCY; ++s) {
+            glGenQueries(1, &slots[p][s].query);
+            slots[p][s].pending = false;
+        }
+        nextSlot[p] = 0;
+    }
+    if (checkDisjoint) {
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint); // 读取即清除标志
+    }
+    return true;
+}
+
+void GLTimerQueries::shutdown() {
+    if (!ready) return;
+    if (activePass >= 0) glEndQuery(GL_TIME_ELAPSED);
+    for (int p = 0; p < PROFILE_PASS_COUNT; ++p) {
+        for (int s = 0; s < LATENCY; ++s) {
+            if (slots[p][s].query) glDeleteQueries(1, &slots[p][s].query);
+            slots[p][s] = Slot();
+        }
+    }
+    activePass = -1;
+    activeSlot = -1;
+    ready = false;
+}
+
+void GLTimerQueries::begin(int pass, uint32_t frame) {
+    if (!ready || activePass >= 0) return;
+    int s = nextSlot[pass];
+    Slot& slot = slots[pass][s];
+    if (slot.pending) return; // GPU 落后超过 LATENCY 帧，这一帧不计
+    glBeginQuery(GL_TIME_ELAPSED, slot.query);
+    slot.frame = frame;
+    activePass = pass;
+    activeSlot = s;
+}
+
+void GLTimerQueries::end(int pass) {
+    if (!ready || activePass != pass) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    slots[pass][activeSlot].pending = true;
+    nextSlot[pass] = (activeSlot + 1) % LATENCY;
+    activePass = -1;
+    activeSlot = -1;
+}
+
+void GLTimerQueries::collect(PassProfiler& profiler) {
+    if (!ready) return;
+    bool discard = false;
+    if (checkDisjoint) {
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        discard = disjoint != 0;
+    }
+    for (int p = 0; p < PROFILE_PASS_COUNT; ++p) {
+        // 按提交顺序读取，遇到未就绪的查询即停止（之后的更不可能就绪）
+        for (int i = 0; i < LATENCY; ++i) {
+            Slot& slot = slots[p][(nextSlot[p] + i) % LATENCY];
+            if (!slot.pending) continue;
+            GLuint available = 0;
+            glGetQueryObjectuiv(slot.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+            GLuint64 elapsed = 0; // 纳秒
+            getQueryResult64(slot.query, GL_QUERY_RESULT, &elapsed);
+            slot.pending = false;
+            // 第 0 帧含着色器编译等一次性开销，且部分驱动（llvmpipe）首个查询的结果无效，不计
+            if (!discard && slot.frame > 0) profiler.addGpuSample(p, slot.frame, elapsed * 1e-6);
+        }
+    }
+}
+
+} // namespace Core
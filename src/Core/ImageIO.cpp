@@ -0,0 +1,149 @@
+#include "Core/ImageIO.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+namespace Core {
+
+static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putBE32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back((uint8_t)(v >> 24));
+    out.push_back((uint8_t)(v >> 16));
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)v);
+}
+
+static void writeChunk(std::ofstream& file, const char type[4], const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    putBE32(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    putBE32(chunk, crc32(&chunk[4], chunk.size() - 4));
+    file.write((const char*)chunk.data(), chunk.size());
+}
+
+bool writePNG(const std::string& path, const std::vector<uint8_t>& rgba, int width, int height) {
+    if (width <= 0 || height <= 0 || rgba.size() < (size_t)width * height * 4) return false;
+    std::ofstream file(path.c_str(), std::ios::binary);
+    if (!file) return false;
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write((const char*)signature, sizeof(signature));
+
+    std::vector<uint8_t> header;
+    putBE32(header, (uint32_t)width);
+    putBE32(header, (uint32_t)height);
+    header.push_back(8);  // 位深
+    header.push_back(6);  // RGBA
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    writeChunk(file, "IHDR", header);
+
+    // 扫描线：每行前加过滤类型 0，自上而下
+    const size_t rowBytes = (size_t)width * 4 + 1;
+    std::vector<uint8_t> raw(rowBytes * height);
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = &raw[(size_t)y * rowBytes];
+        row[0] = 0;
+        const uint8_t* src = &rgba[(size_t)(height - 1 - y) * width * 4];
+        std::copy(src, src + (size_t)width * 4, row + 1);
+    }
+
+    // zlib 流：存储块每块最多 65535 字节，末尾为 Adler-32
+    std::vector<uint8_t> zdata;
+    zdata.push_back(0x78);
+    zdata.push_back(0x01);
+    uint32_t a = 1, b = 0;
+    for (size_t pos = 0; pos < raw.size(); ) {
+        size_t len = std::min<size_t>(65535, raw.size() - pos);
+        bool last = pos + len == raw.size();
+        zdata.push_back(last ? 1 : 0);
+        zdata.push_back((uint8_t)len);
+        zdata.push_back((uint8_t)(len >> 8));
+        zdata.push_back((uint8_t)~len);
+        zdata.push_back((uint8_t)(~len >> 8));
+        zdata.insert(zdata.end(), raw.begin() + pos, raw.begin() + pos + len);
+        for (size_t i = pos; i < pos + len; ++i) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        pos += len;
+    }
+    putBE32(zdata, (b << 16) | a);
+    writeChunk(file, "IDAT", zdata);
+    writeChunk(file, "IEND", std::vector<uint8_t>());
+    return (bool)file;
+}
+
+bool writePPM(const std::string& path, const std::vector<uint8_t>& rgba, int width, int height) {
+    if (width <= 0 || height <= 0 || rgba.size() < (size_t)width * height * 4) return false;
+    std::ofstream file(path.c_str(), std::ios::binary);
+    if (!file) return false;
+    file << "P6\n" << width << " " << height << "\n255\n";
+    std::vector<char> row((size_t)width * 3);
+    for (int y = height - 1; y >= 0; --y) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 3; ++c) row[x * 3 + c] = (char)rgba[((size_t)y * width + x) * 4 + c];
+        }
+        file.write(row.data(), row.size());
+    }
+    return (bool)file;
+}
+
+bool writeImage(const std::string& path, const std::vector<uint8_t>& rgba, int width, int height) {
+    const size_t n = path.size();
+    if (n >= 4 && path.compare(n - 4, 4, ".png") == 0) return writePNG(path, rgba, width, height);
+    return writePPM(path, rgba, width, height);
+}
+
+bool readPPM(const std::string& path, std::vector<uint8_t>& rgba, int& width, int& height) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    std::string magic;
+    int maxValue = 0;
+    if (!(file >> magic >> width >> height >> maxValue) || magic != "P6" || maxValue != 255 ||
+        width <= 0 || height <= 0) {
+        return false;
+    }
+    file.get();
+    std::vector<uint8_t> rgb((size_t)width * height * 3);
+    if (!file.read((char*)rgb.data(), rgb.size())) return false;
+    rgba.resize((size_t)width * height * 4);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const uint8_t* src = &rgb[((size_t)(height - 1 - y) * width + x) * 3];
+            uint8_t* dst = &rgba[((size_t)y * width + x) * 4];
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+        }
+    }
+    return true;
+}
+
+double meanAbsoluteError(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    if (a.size() != b.size() || a.empty()) return -1.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if ((i & 3) == 3) continue;
+        sum += std::abs((int)a[i] - (int)b[i]);
+    }
+    return sum / (double)(a.size() / 4 * 3);
+}
+
+} // namespace Core
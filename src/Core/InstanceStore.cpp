@@ -0,0 +1,135 @@
+#include "Core/InstanceStore.h"
+#include <cstring>
+
+namespace Core {
+
+uint16_t InstanceStore::registerMesh(Mesh* mesh) {
+    for (std::size_t i = 0; i < meshTable.size(); ++i) {
+        if (meshTable[i] == mesh) return (uint16_t)i;
+    }
+    meshTable.push_back(mesh);
+    return (uint16_t)(meshTable.size() - 1);
+}
+
+InstanceHandle InstanceStore::create(Mesh* mesh, unsigned int layers) {
+    uint32_t dense = (uint32_t)size();
+
+    InstanceHandle h;
+    if (!freeSlots.empty()) {
+        h.slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        h.slot = (uint32_t)slotToDense.size();
+        slotToDense.push_back(0);
+        slotGeneration.push_back(0);
+    }
+    h.generation = slotGeneration[h.slot];
+    slotToDense[h.slot] = dense;
+
+    // 默认：单位矩阵、白色、无自发光（与原 Instance 一致）
+    static const float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    transforms.insert(transforms.end(), identity, identity + 16);
+    colorData.insert(colorData.end(), {1.0f, 1.0f, 1.0f, 1.0f});
+    emissiveData.insert(emissiveData.end(), {0.0f, 0.0f, 0.0f, 1.0f});
+    meshIdData.push_back(registerMesh(mesh));
+    layerData.push_back(layers);
+    versionData.push_back(0);
+    denseToSlot.push_back(h.slot);
+    ++staticVersionCounter;
+    return h;
+}
+
+void InstanceStore::destroy(InstanceHandle h) {
+    if (!isAlive(h)) return;
+
+    uint32_t dense = slotToDense[h.slot];
+    uint32_t last = (uint32_t)size() - 1;
+    if (dense != last) {
+        // 末尾实例移入空位
+        memcpy(&transforms[dense * 16], &transforms[last * 16], 16 * sizeof(float));
+        memcpy(&colorData[dense * 4], &colorData[last * 4], 4 * sizeof(float));
+        memcpy(&emissiveData[dense * 4], &emissiveData[last * 4], 4 * sizeof(float));
+        meshIdData[dense] = meshIdData[last];
+        layerData[dense] = layerData[last];
+        versionData[dense] = versionData[last];
+        denseToSlot[dense] = denseToSlot[last];
+        slotToDense[denseToSlot[dense]] = dense;
+    }
+    transforms.resize(last * 16);
+    colorData.resize(last * 4);
+    emissiveData.resize(last * 4);
+    meshIdData.pop_back();
+    layerData.pop_back();
+    versionData.pop_back();
+    denseToSlot.pop_back();
+
+    ++slotGeneration[h.slot]; // 使旧句柄失效
+    freeSlots.push_back(h.slot);
+    ++staticVersionCounter;
+}
+
+bool InstanceStore::isAlive(InstanceHandle h) const {
+    return h.slot < slotGeneration.size() && slotGeneration[h.slot] == h.generation;
+}
+
+void InstanceStore::reserve(std::size_t count) {
+    transforms.reserve(count * 16);
+    colorData.reserve(count * 4);
+    emissiveData.reserve(count * 4);
+    meshIdData.reserve(count);
+    layerData.reserve(count);
+    versionData.reserve(count);
+    denseToSlot.reserve(count);
+    slotToDense.reserve(count);
+    slotGeneration.reserve(count);
+}
+
+void InstanceStore::clear() {
+    // 逐个失效现有句柄，保留槽位以便复用
+    for (uint32_t slot : denseToSlot) {
+        ++slotGeneration[slot];
+        freeSlots.push_back(slot);
+    }
+    transforms.clear();
+    colorData.clear();
+    emissiveData.clear();
+    meshIdData.clear();
+    layerData.clear();
+    versionData.clear();
+    denseToSlot.clear();
+    ++staticVersionCounter;
+}
+
+void InstanceStore::setModelMatrix(InstanceHandle h, const float* mat) {
+    uint32_t dense = denseIndex(h);
+    memcpy(&transforms[dense * 16], mat, 16 * sizeof(float));
+    ++versionData[dense];
+    if (layerData[dense] & LAYER_STATIC) {
+        ++staticVersionCounter;
+    } else {
+        ++dynamicVersionCounter;
+    }
+}
+
+void InstanceStore::setColor(InstanceHandle h, float r, float g, float b, float a) {
+    uint32_t dense = denseIndex(h);
+    float* c = &colorData[dense * 4];
+    c[0] = r; c[1] = g; c[2] = b; c[3] = a;
+    // 静态合批把颜色烘焙进顶点
+    if (layerData[dense] & LAYER_STATIC) ++staticVersionCounter;
+}
+
+void InstanceStore::setEmissive(InstanceHandle h, float r, float g, float b, float a) {
+    uint32_t dense = denseIndex(h);
+    float* e = &emissiveData[dense * 4];
+    e[0] = r; e[1] = g; e[2] = b; e[3] = a;
+    // 静态合批与 radiance 脏矩形缓存都按 staticVersion 缓存静态发光
+    if (layerData[dense] & LAYER_STATIC) ++staticVersionCounter;
+}
+
+void InstanceStore::setLayers(InstanceHandle h, unsigned int layers) {
+    layerData[denseIndex(h)] = layers;
+    ++staticVersionCounter;
+}
+
+} // namespace Core
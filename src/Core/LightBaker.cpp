@@ -0,0 +1,252 @@
+#include "Core/LightBaker.h"
+#include "Math/MathTool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PI_BAKE_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PI_BAKE_SSE 1
+#endif
+
+namespace Core {
+
+// 标量衰减：smoothstep(0, 1, 1 - d / r) 再平方，与 SDF GI 着色器一致
+static inline float bakeAttenuation(float d, float invRadius) {
+    float t = std::min(std::max(1.0f - d * invRadius, 0.0f), 1.0f);
+    float s = t * t * (3.0f - 2.0f * t);
+    return s * s;
+}
+
+// out[i] = 纹素 (xs[i], y) 到光源的衰减，dy2 = (y - ly)^2，count 为 4 的倍数
+#if defined(PI_BAKE_NEON)
+
+static void attenuationRow(const float* xs, int count, float lx, float dy2, float invRadius, float* out) {
+    const float32x4_t vlx = vdupq_n_f32(lx), vdy2 = vdupq_n_f32(dy2), vinv = vdupq_n_f32(invRadius);
+    const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f), three = vdupq_n_f32(3.0f);
+    const float32x4_t tiny = vdupq_n_f32(1e-12f);
+    for (int i = 0; i < count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(xs + i), vlx);
+        float32x4_t d2 = vmaxq_f32(vmlaq_f32(vdy2, dx, dx), tiny);
+#if defined(__aarch64__)
+        float32x4_t d = vsqrtq_f32(d2);
+#else
+        // armv7 没有 vsqrtq：倒数平方根估计加两次牛顿迭代
+        float32x4_t r = vrsqrteq_f32(d2);
+        r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(d2, r), r));
+        r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(d2, r), r));
+        float32x4_t d = vmulq_f32(d2, r);
+#endif
+        float32x4_t t = vminq_f32(vmaxq_f32(vmlsq_f32(one, d, vinv), zero), one);
+        float32x4_t s = vmulq_f32(vmulq_f32(t, t), vmlsq_f32(three, t, vdupq_n_f32(2.0f)));
+        vst1q_f32(out + i, vmulq_f32(s, s));
+    }
+}
+
+#elif defined(PI_BAKE_SSE)
+
+static void attenuationRow(const float* xs, int count, float lx, float dy2, float invRadius, float* out) {
+    const __m128 vlx = _mm_set1_ps(lx), vdy2 = _mm_set1_ps(dy2), vinv = _mm_set1_ps(invRadius);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), three = _mm_set1_ps(3.0f), two = _mm_set1_ps(2.0f);
+    for (int i = 0; i < count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), vlx);
+        __m128 d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), vdy2));
+        __m128 t = _mm_min_ps(_mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(d, vinv)), zero), one);
+        __m128 s = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(three, _mm_mul_ps(two, t)));
+        _mm_storeu_ps(out + i, _mm_mul_ps(s, s));
+    }
+}
+
+#else
+
+static void attenuationRow(const float* xs, int count, float lx, float dy2, float invRadius, float* out) {
+    for (int i = 0; i < count; ++i) {
+        float dx = xs[i] - lx;
+        out[i] = bakeAttenuation(sqrtf(dx * dx + dy2), invRadius);
+    }
+}
+
+#endif
+
+void LightBaker::setGrid(const uint8_t* occupancy, int width, int height, float originX, float originY, float cellSize) {
+    occupancyData.assign(occupancy, occupancy + width * height);
+    gridW = width;
+    gridH = height;
+    gridOriginX = originX;
+    gridOriginY = originY;
+    gridCellSize = cellSize;
+}
+
+void LightBaker::setTexelsPerCell(int texels) {
+    texelsPerCell = std::max(1, texels);
+}
+
+void LightBaker::addEmissiveInstances(const InstanceStore& instances, unsigned int layerMask, float baseRadius, float intensity) {
+    const std::size_t count = instances.size();
+    const float* matrices = instances.modelMatrices();
+    const float* emissives = instances.emissives();
+    const unsigned int* layers = instances.layers();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!(layers[i] & layerMask)) continue;
+        const float* e = emissives + i * 4;
+        float r = e[0] * e[3], g = e[1] * e[3], b = e[2] * e[3];
+        float peak = std::max(r, std::max(g, b));
+        if (peak <= 0.0f) continue;
+        BakeLight light;
+        light.pos[0] = matrices[i * 16 + 12];
+        light.pos[1] = matrices[i * 16 + 13];
+        light.radius = baseRadius * std::min(1.0f, peak);
+        light.color[0] = r * intensity;
+        light.color[1] = g * intensity;
+        light.color[2] = b * intensity;
+        lightData.push_back(light);
+    }
+}
+
+void LightBaker::worldToMapUV(float scale[2], float offset[2]) const {
+    scale[0] = 1.0f / (gridW * gridCellSize);
+    scale[1] = 1.0f / (gridH * gridCellSize);
+    offset[0] = -gridOriginX * scale[0];
+    offset[1] = -gridOriginY * scale[1];
+}
+
+void LightBaker::resizeMap() {
+    mapW = gridW * texelsPerCell;
+    mapH = gridH * texelsPerCell;
+    mapData.assign((std::size_t)mapW * mapH * 3, 0.0f);
+}
+
+bool LightBaker::wall(int cx, int cy) const {
+    if (cx < 0 || cy < 0 || cx >= gridW || cy >= gridH) return false;
+    return occupancyData[cy * gridW + cx] != 0;
+}
+
+// Amanatides-Woo：按线段穿过的先后顺序逐个访问格子
+bool LightBaker::visible(float x0, float y0, float x1, float y1) const {
+    int cx = (int)floorf(x0), cy = (int)floorf(y0);
+    const int ex = (int)floorf(x1), ey = (int)floorf(y1);
+    const float dx = x1 - x0, dy = y1 - y0;
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepY = dy > 0.0f ? 1 : -1;
+    const float tDeltaX = dx != 0.0f ? fabsf(1.0f / dx) : HUGE_VALF;
+    const float tDeltaY = dy != 0.0f ? fabsf(1.0f / dy) : HUGE_VALF;
+    float tMaxX = dx > 0.0f ? (cx + 1 - x0) * tDeltaX : dx < 0.0f ? (x0 - cx) * tDeltaX : HUGE_VALF;
+    float tMaxY = dy > 0.0f ? (cy + 1 - y0) * tDeltaY : dy < 0.0f ? (y0 - cy) * tDeltaY : HUGE_VALF;
+    for (int n = std::abs(ex - cx) + std::abs(ey - cy); n > 1; --n) {
+        if (tMaxX < tMaxY) {
+            cx += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            cy += stepY;
+            tMaxY += tDeltaY;
+        }
+        if (wall(cx, cy)) return false;
+    }
+    return true;
+}
+
+void LightBaker::bakeRows(int rowBegin, int rowEnd, int rowStep) {
+    const float texel = gridCellSize / texelsPerCell;
+    const float invCell = 1.0f / gridCellSize;
+    const int paddedW = (mapW + 3) & ~3;
+    std::vector<float> xs(paddedW), att(paddedW);
+    for (int tx = 0; tx < paddedW; ++tx) xs[tx] = gridOriginX + (tx + 0.5f) * texel;
+
+    for (int ty = rowBegin; ty < rowEnd; ty += rowStep) {
+        float* row = &mapData[(std::size_t)ty * mapW * 3];
+        const float wy = gridOriginY + (ty + 0.5f) * texel;
+        const int cy = ty / texelsPerCell;
+        for (const BakeLight& light : lightData) {
+            const float dy = wy - light.pos[1];
+            if (light.radius <= 0.0f || fabsf(dy) >= light.radius) continue;
+            // 本行在光源半径内的纹素区间，起点按 4 对齐
+            int x0 = (int)floorf((light.pos[0] - light.radius - gridOriginX) / texel);
+            int x1 = (int)ceilf((light.pos[0] + light.radius - gridOriginX) / texel) + 1;
+            x0 = std::max(0, x0) & ~3;
+            x1 = std::min(mapW, x1);
+            if (x0 >= x1) continue;
+            attenuationRow(&xs[x0], (x1 - x0 + 3) & ~3, light.pos[0], dy * dy, 1.0f / light.radius, &att[x0]);
+
+            const float lx = (light.pos[0] - gridOriginX) * invCell;
+            const float ly = (light.pos[1] - gridOriginY) * invCell;
+            const float gy = (wy - gridOriginY) * invCell;
+            for (int tx = x0; tx < x1; ++tx) {
+                if (att[tx] <= 0.0f || wall(tx / texelsPerCell, cy)) continue;
+                // 起点与 bakeReference 按同一公式换算：非 2 的幂格子上舍入不同会让擦过墙角的线段可见性翻转
+                if (!visible((xs[tx] - gridOriginX) * invCell, gy, lx, ly)) continue;
+                row[tx * 3 + 0] += att[tx] * light.color[0];
+                row[tx * 3 + 1] += att[tx] * light.color[1];
+                row[tx * 3 + 2] += att[tx] * light.color[2];
+            }
+        }
+    }
+}
+
+void LightBaker::bake(int threadCount) {
+    resizeMap();
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    threadCount = std::max(1, std::min(threadCount, mapH));
+
+    // 行交错分配，墙体与光源分布不均时各线程负载仍接近
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threadCount; ++t) {
+        workers.emplace_back(&LightBaker::bakeRows, this, t, mapH, threadCount);
+    }
+    bakeRows(0, mapH, threadCount);
+    for (std::thread& worker : workers) worker.join();
+}
+
+void LightBaker::bakeReference() {
+    resizeMap();
+    const float texel = gridCellSize / texelsPerCell;
+    const float invCell = 1.0f / gridCellSize;
+    for (int ty = 0; ty < mapH; ++ty) {
+        for (int tx = 0; tx < mapW; ++tx) {
+            if (wall(tx / texelsPerCell, ty / texelsPerCell)) continue;
+            const float wx = gridOriginX + (tx + 0.5f) * texel;
+            const float wy = gridOriginY + (ty + 0.5f) * texel;
+            float* out = &mapData[((std::size_t)ty * mapW + tx) * 3];
+            for (const BakeLight& light : lightData) {
+                if (light.radius <= 0.0f) continue;
+                float dx = wx - light.pos[0], dy = wy - light.pos[1];
+                float a = bakeAttenuation(sqrtf(dx * dx + dy * dy), 1.0f / light.radius);
+                if (a <= 0.0f) continue;
+                if (!visible((wx - gridOriginX) * invCell, (wy - gridOriginY) * invCell,
+                             (light.pos[0] - gridOriginX) * invCell, (light.pos[1] - gridOriginY) * invCell)) continue;
+                out[0] += a * light.color[0];
+                out[1] += a * light.color[1];
+                out[2] += a * light.color[2];
+            }
+        }
+    }
+}
+
+void screenToLightmapUV(const float vp[16], const float scale[2], const float offset[2], float out[9]) {
+    float plane[16], planeInv[16];
+    createIdentityMatrix(plane);
+    plane[0] = vp[0]; plane[1] = vp[1]; plane[3] = vp[3];
+    plane[4] = vp[4]; plane[5] = vp[5]; plane[7] = vp[7];
+    plane[12] = vp[12]; plane[13] = vp[13]; plane[15] = vp[15];
+    if (!invertMatrix(plane, planeInv)) {
+        for (int i = 0; i < 9; ++i) out[i] = 0.0f;
+        return;
+    }
+    float uvToNdc[16], world[16];
+    createIdentityMatrix(uvToNdc);
+    uvToNdc[0] = 2.0f; uvToNdc[5] = 2.0f; uvToNdc[12] = -1.0f; uvToNdc[13] = -1.0f;
+    multiplyMatrices(planeInv, uvToNdc, world);
+    // 第 c 列取 world 的 x、y、w 行（列 0、1、3）
+    static const int cols[3] = {0, 1, 3};
+    for (int c = 0; c < 3; ++c) {
+        const float* col = world + cols[c] * 4;
+        out[c * 3 + 0] = col[0] * scale[0] + col[3] * offset[0];
+        out[c * 3 + 1] = col[1] * scale[1] + col[3] * offset[1];
+        out[c * 3 + 2] = col[3];
+    }
+}
+
+} // namespace Core
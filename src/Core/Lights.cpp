@@ -0,0 +1,94 @@
+#include "Core/Lights.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Core {
+
+void TiledLightList::setLightParameters(float baseRange, float intensity) {
+    lightBaseRange = baseRange;
+    lightIntensity = intensity;
+}
+
+void TiledLightList::build(const float vp[16], const InstanceStore& instances, unsigned int layerMask, int width, int height) {
+    lightData.clear();
+    rectData.clear();
+    dropped = 0;
+
+    // 1) 收集光源：位置取模型矩阵的平移列，经 vp 投影到屏幕 UV
+    const std::size_t count = instances.size();
+    const float* matrices = instances.modelMatrices();
+    const float* emissives = instances.emissives();
+    const unsigned int* layers = instances.layers();
+    for (std::size_t i = 0; i < count && lightData.size() < (std::size_t)MAX_LIGHTS; ++i) {
+        if (!(layers[i] & layerMask)) continue;
+        const float* e = emissives + i * 4;
+        float r = e[0] * e[3], g = e[1] * e[3], b = e[2] * e[3];
+        float peak = std::max(r, std::max(g, b));
+        if (peak <= 0.0f) continue;
+
+        const float* m = matrices + i * 16;
+        float cx = vp[0] * m[12] + vp[4] * m[13] + vp[8] * m[14] + vp[12];
+        float cy = vp[1] * m[12] + vp[5] * m[13] + vp[9] * m[14] + vp[13];
+        float cw = vp[3] * m[12] + vp[7] * m[13] + vp[11] * m[14] + vp[15];
+
+        ScreenLight light;
+        light.range = lightBaseRange * std::min(1.0f, peak);
+        light.color[0] = r * lightIntensity;
+        light.color[1] = g * lightIntensity;
+        light.color[2] = b * lightIntensity;
+        ScreenRect rect;
+        if (cw > 1e-6f) {
+            light.uv[0] = (cx / cw + 1.0f) * 0.5f;
+            light.uv[1] = (cy / cw + 1.0f) * 0.5f;
+            // 着色器在半径外不贡献，矩形外扩 1 纹素覆盖上采样的双线性邻域
+            rect.x0 = std::max(0, (int)floorf((light.uv[0] - light.range) * width) - 1);
+            rect.y0 = std::max(0, (int)floorf((light.uv[1] - light.range) * height) - 1);
+            rect.x1 = std::min(width, (int)ceilf((light.uv[0] + light.range) * width) + 1);
+            rect.y1 = std::min(height, (int)ceilf((light.uv[1] + light.range) * height) + 1);
+        } else {
+            // 相机后方：不照亮任何像素
+            light.uv[0] = light.uv[1] = -1.0f;
+            light.range = 0.0f;
+        }
+        lightData.push_back(light);
+        rectData.push_back(rect);
+    }
+
+    // 2) 分块：计数排序成 CSR，先统计每块的光源数（截断到上限），再按光源顺序填入下标
+    tileCountX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tileCountY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    const std::size_t tileCount = (std::size_t)tileCountX * tileCountY;
+    tileRangeData.assign(tileCount * 2, 0);
+    for (const ScreenRect& rect : rectData) {
+        if (rect.empty()) continue;
+        for (int ty = rect.y0 / TILE_SIZE; ty <= (rect.y1 - 1) / TILE_SIZE; ++ty) {
+            for (int tx = rect.x0 / TILE_SIZE; tx <= (rect.x1 - 1) / TILE_SIZE; ++tx) {
+                uint32_t& n = tileRangeData[(ty * tileCountX + tx) * 2 + 1];
+                if (n < (uint32_t)MAX_LIGHTS_PER_TILE) ++n;
+                else ++dropped;
+            }
+        }
+    }
+    uint32_t offset = 0;
+    tileCursor.resize(tileCount);
+    for (std::size_t t = 0; t < tileCount; ++t) {
+        tileRangeData[t * 2] = offset;
+        tileCursor[t] = offset;
+        offset += tileRangeData[t * 2 + 1];
+    }
+    tileIndexData.resize(offset);
+    for (std::size_t l = 0; l < rectData.size(); ++l) {
+        const ScreenRect& rect = rectData[l];
+        if (rect.empty()) continue;
+        for (int ty = rect.y0 / TILE_SIZE; ty <= (rect.y1 - 1) / TILE_SIZE; ++ty) {
+            for (int tx = rect.x0 / TILE_SIZE; tx <= (rect.x1 - 1) / TILE_SIZE; ++tx) {
+                std::size_t t = (std::size_t)ty * tileCountX + tx;
+                if (tileCursor[t] < tileRangeData[t * 2] + tileRangeData[t * 2 + 1]) {
+                    tileIndexData[tileCursor[t]++] = (uint16_t)l;
+                }
+            }
+        }
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,196 @@
+#include "Core/MazeScene.h"
+#include "Math/MathTool.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Core {
+
+// 更大更复杂的迷宫
+const int mazeLayout[MAZE_HEIGHT][MAZE_WIDTH] = {
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+    {1,2,0,0,1,0,0,0,0,1,0,0,0,0,0,1}, // 起点在(1,1)
+    {1,0,1,0,1,0,1,1,0,1,0,1,1,1,0,1},
+    {1,0,1,0,0,0,0,1,0,0,0,1,0,0,0,1},
+    {1,0,1,1,1,1,0,1,1,1,0,1,0,1,1,1},
+    {1,0,0,0,0,0,0,0,0,1,0,0,0,1,0,1},
+    {1,1,1,0,1,1,1,1,0,1,1,1,0,1,0,1},
+    {1,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1},
+    {1,0,1,1,1,0,1,1,1,1,0,1,1,1,0,1},
+    {1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,1},
+    {1,1,1,1,0,1,1,0,1,1,1,1,0,1,0,1},
+    {1,0,0,0,0,0,0,0,1,0,0,0,0,1,0,1},
+    {1,0,1,1,1,1,1,0,1,0,1,1,0,0,0,1},
+    {1,0,0,0,0,0,1,0,0,0,1,0,0,1,0,1},
+    {1,0,1,1,1,0,0,0,1,0,0,0,1,0,3,1}, // 终点在(14,14)
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
+};
+
+MazeMeshes::MazeMeshes(bool icosphere) {
+    if (!icosphere) {
+        sphere.reset(new SphereMesh());
+        return;
+    }
+    std::vector<float> verts;
+    std::vector<unsigned short> idxs;
+    generateUVSphere(SPHERE_SECTORS, SPHERE_STACKS, verts, idxs);
+    sphere.reset(new IcosphereMesh(icosphereFrequencyFor(sphereSilhouetteError(verts, idxs, 0.5f))));
+}
+
+InstanceHandle buildMazeScene(InstanceStore& instances, MazeMeshes& meshes) {
+    instances.reserve(MAZE_WIDTH * MAZE_HEIGHT + 2);
+
+    InstanceHandle floorHandle = instances.create(&meshes.panel, LAYER_STATIC);
+    float floorPos[3] = {MAZE_HEIGHT / 2.f, MAZE_WIDTH / 2.f, -3.0f};
+    float floorRot[3] = {0, 3.14f / 2, 0}; // 只绕Y轴旋转
+    float floorScale[3] = {20, 20, 20};
+    float floorModel[16];
+    createModelMatrix1(floorModel, floorPos, floorRot, floorScale);
+    instances.setModelMatrix(floorHandle, floorModel);
+    instances.setColor(floorHandle, 0.0f, 0.0f, 0.0f, 1.0f); // 黑色地板
+
+    for (int y = 0; y < MAZE_HEIGHT; ++y) {
+        for (int x = 0; x < MAZE_WIDTH; ++x) {
+            if (mazeLayout[y][x] == 1) { // 是墙
+                float pos[3] = { (float)x, (float)y, 0.0f}; // y轴向下
+                float rot[3] = {0, 0, 0};
+                float scale[3] = {1, 1, 2};
+                float model[16];
+                createModelMatrix1(model, pos, rot, scale);
+                // 墙体实例也加入BlockMap
+                InstanceHandle wall = instances.create(&meshes.cube, LAYER_STATIC | LAYER_OCCLUDER);
+                instances.setModelMatrix(wall, model);
+                instances.setColor(wall, 0.0f, 0.0f, 0.0f, 1.0f);
+                instances.setEmissive(wall, 0.f, 0.f, 0.f, 0.0f);
+            } else if (mazeLayout[y][x] == 2 || mazeLayout[y][x] == 3) { // 起点/终点标记
+                // 黑色地板标记，起点微弱绿色发光，终点微弱红色发光
+                float pos[3] = { (float)x, (float)y, -0.5f}; // 稍微低一点
+                float rot[3] = {M_PI/2, 0, 0}; // 旋转90度让面板水平
+                float scale[3] = {0.8f, 0.8f, 0.1f};
+                float model[16];
+                createModelMatrix1(model, pos, rot, scale);
+                InstanceHandle marker = instances.create(&meshes.panel, LAYER_STATIC);
+                instances.setModelMatrix(marker, model);
+                instances.setColor(marker, 0.0f, 0.0f, 0.0f, 1.0f); // 黑色
+                if (mazeLayout[y][x] == 2) {
+                    instances.setEmissive(marker, 0.05f, 0.2f, 0.05f, 1.0f);
+                } else {
+                    instances.setEmissive(marker, 0.2f, 0.05f, 0.05f, 1.0f);
+                }
+            }
+        }
+    }
+
+    InstanceHandle player = instances.create(meshes.sphere.get(), LAYER_DYNAMIC | LAYER_RADIANCE);
+    float playerPos[3] = {MAZE_START_X, MAZE_START_Y, 0.0f}; // 玩家从起点开始
+    float playerModel[16];
+    mazePlayerModel(playerPos, playerModel);
+    instances.setModelMatrix(player, playerModel);
+    instances.setColor(player, 1.0f, 0.0f, 0.0f, 1.0f); // 红色球体
+    instances.setEmissive(player, 1.5f, 1.0f, 0.8f, 1.0f); // 更强的橙红色发光
+    return player;
+}
+
+void mazePlayerModel(const float pos[3], float model[16]) {
+    float p[3] = {pos[0], pos[1], pos[2]};
+    float rot[3] = {0, 0, 0};
+    float scale[3] = {0.3f, 0.3f, 0.3f}; // 球体半径为0.3
+    createModelMatrix1(model, p, rot, scale);
+}
+
+// meshes 中从 first 开始的分段共用一个模型矩阵
+static void placeMazeModel(const float boundsMin[3], const float boundsMax[3],
+                           const std::vector<std::unique_ptr<ModelMesh> >& meshes, size_t first,
+                           InstanceStore& instances) {
+    const float extent = std::max(boundsMax[0] - boundsMin[0], boundsMax[2] - boundsMin[2]);
+    const float s = 0.8f / std::max(extent, 1e-6f);
+    // 底面中心为支点；绕 X 轴 90 度：x -> x，y -> z，z -> -y
+    const float pivot[3] = {(boundsMin[0] + boundsMax[0]) * 0.5f, boundsMin[1], (boundsMin[2] + boundsMax[2]) * 0.5f};
+    float m[16] = {s, 0, 0, 0,
+                   0, 0, s, 0,
+                   0, -s, 0, 0,
+                   MAZE_EXIT_X - s * pivot[0], MAZE_EXIT_Y + s * pivot[2], -1.0f - s * pivot[1], 1};
+    for (size_t i = first; i < meshes.size(); ++i) {
+        InstanceHandle h = instances.create(meshes[i].get(), LAYER_STATIC | LAYER_OCCLUDER);
+        instances.setModelMatrix(h, m);
+        instances.setColor(h, 0.5f, 0.5f, 0.5f, 1.0f);
+        instances.setEmissive(h, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+}
+
+void addMazeModel(const ModelData& model, std::vector<std::unique_ptr<ModelMesh> >& meshes, InstanceStore& instances) {
+    const size_t first = meshes.size();
+    for (const ModelPart& part : model.parts) meshes.emplace_back(new ModelMesh(part));
+    placeMazeModel(model.boundsMin, model.boundsMax, meshes, first, instances);
+}
+
+void addMazeModel(const MeshCache& cache, std::vector<std::unique_ptr<ModelMesh> >& meshes, InstanceStore& instances,
+                  bool keepCpuCopy) {
+    const size_t first = meshes.size();
+    for (uint32_t i = 0; i < cache.partCount(); ++i) meshes.emplace_back(new ModelMesh(cache, i, keepCpuCopy));
+    placeMazeModel(cache.header().boundsMin, cache.header().boundsMax, meshes, first, instances);
+}
+
+std::vector<std::pair<int, int> > mazeSolutionPath() {
+    const int w = MAZE_WIDTH, h = MAZE_HEIGHT;
+    std::vector<int> parent(w * h, -1);
+    std::vector<int> queue;
+    const int start = (int)MAZE_START_Y * w + (int)MAZE_START_X;
+    const int exit = (int)MAZE_EXIT_Y * w + (int)MAZE_EXIT_X;
+    parent[start] = start;
+    queue.push_back(start);
+    for (size_t head = 0; head < queue.size() && parent[exit] < 0; ++head) {
+        const int cell = queue[head];
+        static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        for (int d = 0; d < 4; ++d) {
+            int x = cell % w + dirs[d][0], y = cell / w + dirs[d][1];
+            if (x < 0 || y < 0 || x >= w || y >= h || mazeLayout[y][x] == 1) continue;
+            if (parent[y * w + x] >= 0) continue;
+            parent[y * w + x] = cell;
+            queue.push_back(y * w + x);
+        }
+    }
+    std::vector<std::pair<int, int> > path;
+    if (parent[exit] < 0) {
+        path.push_back(std::make_pair(start % w, start / w));
+        return path;
+    }
+    for (int cell = exit; ; cell = parent[cell]) {
+        path.push_back(std::make_pair(cell % w, cell / w));
+        if (cell == start) break;
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void mazePathPosition(const std::vector<std::pair<int, int> >& path, float distance, float pos[3]) {
+    pos[2] = 0.0f;
+    if (path.empty()) {
+        pos[0] = MAZE_START_X;
+        pos[1] = MAZE_START_Y;
+        return;
+    }
+    const int segments = std::max(1, (int)path.size() - 1);
+    float s = fmodf(std::max(distance, 0.0f), 2.0f * segments);
+    if (s > segments) s = 2.0f * segments - s;
+    int i = std::min((int)s, (int)path.size() - 1);
+    int j = std::min(i + 1, (int)path.size() - 1);
+    float t = s - i;
+    pos[0] = path[i].first + (path[j].first - path[i].first) * t;
+    pos[1] = path[i].second + (path[j].second - path[i].second) * t;
+}
+
+void bakeMazeLights(const InstanceStore& instances, float orthoSize, LightBaker& baker) {
+    std::vector<uint8_t> occupancy(MAZE_WIDTH * MAZE_HEIGHT);
+    for (int y = 0; y < MAZE_HEIGHT; ++y) {
+        for (int x = 0; x < MAZE_WIDTH; ++x) {
+            occupancy[y * MAZE_WIDTH + x] = mazeLayout[y][x] == 1 ? 1 : 0;
+        }
+    }
+    baker.setGrid(occupancy.data(), MAZE_WIDTH, MAZE_HEIGHT, -0.5f, -0.5f, 1.0f);
+    baker.clearLights();
+    baker.addEmissiveInstances(instances, LAYER_STATIC, 0.2f * orthoSize, 0.8f);
+    baker.bake();
+}
+
+} // namespace Core
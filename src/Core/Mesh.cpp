@@ -1,7 +1,122 @@
 #include "Core/Mesh.h"
+#ifndef PI_HEADLESS
+#include "Core/GLState.h"
+#include "Core/GeometryArena.h"
+#endif
 #include <iostream>
 
 namespace Core {
 
+void Mesh::setupData(const float* verts, std::size_t vertexFloatCount,
+                     const unsigned short* idxs, std::size_t idxCount) {
+    indexCount = (GLsizei)idxCount;
+    vertices.assign(verts, verts + vertexFloatCount);
+    indices.assign(idxs, idxs + idxCount);
+    for (std::size_t v = 0; v + 5 < vertexFloatCount; v += 6) {
+        for (int k = 0; k < 3; ++k) {
+            if (v == 0 || verts[v + k] < aabbMin[k]) aabbMin[k] = verts[v + k];
+            if (v == 0 || verts[v + k] > aabbMax[k]) aabbMax[k] = verts[v + k];
+        }
+    }
 
-}
\ No newline at end of file
+#ifndef PI_HEADLESS
+    geometry = geometryArena().allocate(verts, (uint32_t)(vertexFloatCount / 6), idxs, (uint32_t)idxCount);
+#endif // PI_HEADLESS
+}
+
+void Mesh::setupEncoded(const uint8_t* data, std::size_t vertexCount, const VertexLayout& layout,
+                        const VertexEncoding& encoding, const float boundsMin[3], const float boundsMax[3],
+                        const unsigned short* idxs, std::size_t idxCount, bool keepCpuCopy) {
+    indexCount = (GLsizei)idxCount;
+    for (int k = 0; k < 3; ++k) {
+        aabbMin[k] = boundsMin[k];
+        aabbMax[k] = boundsMax[k];
+    }
+#ifdef PI_HEADLESS
+    keepCpuCopy = true; // 软件光栅只读 CPU 副本
+#else
+    GeometryArena& arena = geometryArena();
+    const bool sameLayout = arena.layout().position == layout.position && arena.layout().normal == layout.normal;
+    if (sameLayout) {
+        geometry = arena.allocateEncoded(data, (uint32_t)vertexCount, encoding, idxs, (uint32_t)idxCount);
+        if (!keepCpuCopy) return;
+    }
+#endif // PI_HEADLESS
+
+    // 解码：需要 CPU 副本，或缓存格式与 GeometryArena 不同须重新编码上传
+    const uint32_t stride = layout.stride();
+    std::vector<float> decoded(vertexCount * 6);
+    for (std::size_t v = 0; v < vertexCount; ++v) {
+        decodeVertex(data + v * stride, layout, encoding, &decoded[v * 6]);
+    }
+#ifndef PI_HEADLESS
+    if (!sameLayout) geometry = arena.allocate(decoded.data(), (uint32_t)vertexCount, idxs, (uint32_t)idxCount);
+#endif // PI_HEADLESS
+    if (keepCpuCopy) {
+        vertices.swap(decoded);
+        indices.assign(idxs, idxs + idxCount);
+    }
+}
+
+#ifdef PI_HEADLESS
+
+Mesh::~Mesh() {}
+void Mesh::bindGeometry() {}
+void Mesh::draw() {}
+void Mesh::drawInstanced(GLuint, GLintptr, GLsizei) {}
+
+#else
+
+Mesh::~Mesh() {
+    if (geometry != GeometryArena::INVALID_HANDLE) geometryArena().release(geometry);
+}
+
+// 所有网格共用 GeometryArena 的缓冲：桌面 GL 只需绑定共享 VAO；
+// GLES 的属性指针偏移到本网格的 baseVertex。压缩格式另外设置本网格的位置反量化常量
+void Mesh::bindGeometry() {
+    geometryArena().bind(geometry);
+}
+
+void Mesh::draw() {
+    bindGeometry();
+    const GeometryRange& r = geometryArena().range(geometry);
+    const void* firstIndex = (const void*)(uintptr_t)(r.firstIndex * sizeof(unsigned short));
+#ifdef USE_DESKTOP_GL
+    // 实例属性保存在共享 VAO 中，非实例化绘制前关闭
+    geometryArena().disableInstanceAttribs();
+    glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, firstIndex, (GLint)r.baseVertex);
+#else
+    glState().disableVertexAttribsFrom(INSTANCE_ATTRIB_FIRST);
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, firstIndex);
+#endif
+}
+
+void Mesh::drawInstanced(GLuint instanceVBO, GLintptr instanceOffset, GLsizei instanceCount) {
+    bindGeometry();
+
+    // 每实例属性：6 个连续 vec4，divisor = 1。绘制后不再还原：
+    // 非实例化绘制自行关闭这些属性（见 draw、StaticBatch::bindChunk），连续的实例化绘制可以跳过重复设置
+    GLStateCache& gl = glState();
+    const GLsizei stride = INSTANCE_DATA_FLOATS * sizeof(float);
+    gl.bindArrayBuffer(instanceVBO);
+    for (int i = 0; i < INSTANCE_ATTRIB_VEC4_COUNT; ++i) {
+        GLuint loc = INSTANCE_ATTRIB_FIRST + i;
+        gl.vertexAttribPointer(loc, 4, stride, instanceOffset + i * 4 * sizeof(float));
+        gl.enableVertexAttrib(loc);
+        gl.vertexAttribDivisor(loc, 1);
+    }
+
+    const GeometryRange& r = geometryArena().range(geometry);
+    const void* firstIndex = (const void*)(uintptr_t)(r.firstIndex * sizeof(unsigned short));
+#ifdef USE_DESKTOP_GL
+    geometryArena().markInstanceAttribsEnabled();
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, firstIndex, instanceCount,
+                                      (GLint)r.baseVertex);
+#else
+    glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, firstIndex, instanceCount);
+#endif
+}
+
+#endif // PI_HEADLESS
+
+}
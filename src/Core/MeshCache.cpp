@@ -0,0 +1,257 @@
+#include "Core/MeshCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Core {
+
+static const char MESH_CACHE_MAGIC[4] = {'P', 'I', 'M', 'C'};
+static const uint64_t BLOB_ALIGNMENT = 16;
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t alignUp(uint64_t offset) {
+    return (offset + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+}
+
+uint64_t meshSourceHash(const std::string& sourcePath) {
+    struct stat st;
+    if (stat(sourcePath.c_str(), &st) != 0) return 0;
+    const uint64_t size = (uint64_t)st.st_size;
+    int64_t mtime[2] = {(int64_t)st.st_mtime, 0};
+#ifdef __linux__
+    mtime[1] = (int64_t)st.st_mtim.tv_nsec; // 同一秒内修改也能区分
+#endif
+    uint64_t hash = fnv1a(14695981039346656037ull, &size, sizeof(size));
+    hash = fnv1a(hash, mtime, sizeof(mtime));
+    return hash ? hash : 1;
+}
+
+std::string meshCachePath(const std::string& sourcePath, const VertexLayout& layout) {
+    return sourcePath + "." + vertexLayoutName(layout) + ".pimesh";
+}
+
+// 补零到 offset
+static bool padTo(FILE* f, uint64_t& written, uint64_t offset) {
+    static const uint8_t zeros[BLOB_ALIGNMENT] = {};
+    while (written < offset) {
+        const size_t n = (size_t)std::min<uint64_t>(offset - written, BLOB_ALIGNMENT);
+        if (fwrite(zeros, 1, n, f) != n) return false;
+        written += n;
+    }
+    return true;
+}
+
+bool writeMeshCache(const std::string& cachePath, uint64_t sourceHash, const VertexLayout& layout,
+                    const ModelData& model) {
+    const uint32_t stride = layout.stride();
+    MeshCacheHeader header = {};
+    memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.sourceHash = sourceHash;
+    header.positionFormat = layout.position;
+    header.normalFormat = layout.normal;
+    header.vertexStride = (uint16_t)stride;
+    header.partCount = (uint32_t)model.parts.size();
+    for (int k = 0; k < 3; ++k) {
+        header.boundsMin[k] = model.boundsMin[k];
+        header.boundsMax[k] = model.boundsMax[k];
+    }
+    header.triangles = model.triangles;
+    header.faceCorners = model.faceCorners;
+    header.uniqueVertices = model.uniqueVertices;
+    header.acmrBefore = model.acmrBefore;
+    header.acmrAfter = model.acmrAfter;
+
+    // 先排好各数据块的位置，分段表在编码后回填
+    std::vector<MeshCachePart> table(model.parts.size());
+    uint64_t cursor = sizeof(MeshCacheHeader) + table.size() * sizeof(MeshCachePart);
+    for (size_t i = 0; i < model.parts.size(); ++i) {
+        const ModelPart& src = model.parts[i];
+        MeshCachePart& p = table[i];
+        memset(&p, 0, sizeof(p));
+        p.vertexCount = (uint32_t)(src.vertices.size() / 6);
+        p.indexCount = (uint32_t)src.indices.size();
+        p.vertexOffset = cursor = alignUp(cursor);
+        cursor += (uint64_t)p.vertexCount * stride;
+        p.indexOffset = cursor = alignUp(cursor);
+        cursor += (uint64_t)p.indexCount * sizeof(unsigned short);
+    }
+
+    const std::string tempPath = cachePath + ".tmp";
+    FILE* f = fopen(tempPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && !table.empty()) ok = fwrite(table.data(), sizeof(MeshCachePart), table.size(), f) == table.size();
+    uint64_t written = sizeof(MeshCacheHeader) + table.size() * sizeof(MeshCachePart);
+    std::vector<uint8_t> encoded;
+    for (size_t i = 0; ok && i < model.parts.size(); ++i) {
+        const ModelPart& src = model.parts[i];
+        MeshCachePart& p = table[i];
+        encoded.resize((size_t)p.vertexCount * stride);
+        VertexEncoding e = encodeVertices(src.vertices.data(), p.vertexCount, layout, encoded.data());
+        for (int k = 0; k < 3; ++k) {
+            p.positionScale[k] = e.positionScale[k];
+            p.positionBias[k] = e.positionBias[k];
+            p.boundsMin[k] = p.boundsMax[k] = p.vertexCount > 0 ? src.vertices[k] : 0.0f;
+        }
+        p.maxPositionError = e.maxPositionError;
+        p.maxNormalError = e.maxNormalError;
+        for (uint32_t v = 1; v < p.vertexCount; ++v) {
+            for (int k = 0; k < 3; ++k) {
+                p.boundsMin[k] = std::min(p.boundsMin[k], src.vertices[v * 6 + k]);
+                p.boundsMax[k] = std::max(p.boundsMax[k], src.vertices[v * 6 + k]);
+            }
+        }
+
+        ok = padTo(f, written, p.vertexOffset) && fwrite(encoded.data(), 1, encoded.size(), f) == encoded.size();
+        written += encoded.size();
+        const size_t indexBytes = src.indices.size() * sizeof(unsigned short);
+        ok = ok && padTo(f, written, p.indexOffset) && fwrite(src.indices.data(), 1, indexBytes, f) == indexBytes;
+        written += indexBytes;
+    }
+    // 回填分段表
+    if (ok && !table.empty()) {
+        ok = fseek(f, (long)sizeof(MeshCacheHeader), SEEK_SET) == 0 &&
+             fwrite(table.data(), sizeof(MeshCachePart), table.size(), f) == table.size();
+    }
+    ok = fclose(f) == 0 && ok;
+    if (ok) {
+#ifdef _WIN32
+        remove(cachePath.c_str()); // Windows 的 rename 不覆盖已有文件
+#endif
+        ok = rename(tempPath.c_str(), cachePath.c_str()) == 0;
+    }
+    if (!ok) remove(tempPath.c_str());
+    return ok;
+}
+
+bool MeshCache::open(const std::string& cachePath, uint64_t sourceHash, const VertexLayout& layout) {
+    close();
+    if (sourceHash == 0) return false;
+#ifdef _WIN32
+    FILE* f = fopen(cachePath.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    const long fileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (fileSize > 0) {
+        buffer.resize((size_t)fileSize);
+        if (fread(buffer.data(), 1, buffer.size(), f) == buffer.size()) {
+            bytes = buffer.data();
+            length = buffer.size();
+        }
+    }
+    fclose(f);
+    if (!bytes) return false;
+#else
+    const int fd = ::open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // 映射不依赖文件描述符
+    if (mapped == MAP_FAILED) return false;
+#ifdef MADV_WILLNEED
+    // 顶点 / 索引块随后按顺序全部读取，让内核提前预读（SD 卡上随机缺页很慢）
+    madvise(mapped, (size_t)st.st_size, MADV_WILLNEED);
+#endif
+    bytes = static_cast<const uint8_t*>(mapped);
+    length = (size_t)st.st_size;
+#endif
+    if (!validate(sourceHash, layout)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::validate(uint64_t sourceHash, const VertexLayout& layout) {
+    if (length < sizeof(MeshCacheHeader)) return false;
+    memcpy(&head, bytes, sizeof(head));
+    if (memcmp(head.magic, MESH_CACHE_MAGIC, sizeof(head.magic)) != 0 || head.version != MESH_CACHE_VERSION ||
+        head.sourceHash != sourceHash || head.positionFormat != layout.position ||
+        head.normalFormat != layout.normal || head.vertexStride != layout.stride()) {
+        return false;
+    }
+    const uint64_t tableEnd = sizeof(MeshCacheHeader) + (uint64_t)head.partCount * sizeof(MeshCachePart);
+    if (head.partCount == 0 || tableEnd > length) return false;
+    parts = reinterpret_cast<const MeshCachePart*>(bytes + sizeof(MeshCacheHeader));
+    for (uint32_t i = 0; i < head.partCount; ++i) {
+        const MeshCachePart& p = parts[i];
+        // 16 位索引只能寻址 65536 个顶点
+        if (p.vertexCount > 65536 || p.vertexOffset % BLOB_ALIGNMENT != 0 || p.indexOffset % BLOB_ALIGNMENT != 0 ||
+            p.vertexOffset < tableEnd || p.indexOffset < tableEnd ||
+            p.vertexOffset + (uint64_t)p.vertexCount * head.vertexStride > length ||
+            p.indexOffset + (uint64_t)p.indexCount * sizeof(unsigned short) > length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MeshCache::close() {
+#ifdef _WIN32
+    buffer.clear();
+    buffer.shrink_to_fit();
+#else
+    if (bytes) munmap(const_cast<uint8_t*>(bytes), length);
+#endif
+    bytes = nullptr;
+    length = 0;
+    parts = nullptr;
+    head = MeshCacheHeader();
+}
+
+VertexLayout MeshCache::layout() const {
+    VertexLayout l;
+    l.position = (PositionFormat)head.positionFormat;
+    l.normal = (NormalFormat)head.normalFormat;
+    return l;
+}
+
+VertexEncoding MeshCache::encoding(uint32_t i) const {
+    const MeshCachePart& p = parts[i];
+    VertexEncoding e;
+    for (int k = 0; k < 3; ++k) {
+        e.positionScale[k] = p.positionScale[k];
+        e.positionBias[k] = p.positionBias[k];
+    }
+    e.maxPositionError = p.maxPositionError;
+    e.maxNormalError = p.maxNormalError;
+    return e;
+}
+
+std::future<ModelImport> importObjModelAsync(const std::string& sourcePath, const std::string& cachePath,
+                                             const VertexLayout& layout) {
+    return std::async(std::launch::async, [sourcePath, cachePath, layout]() {
+        ModelImport result;
+        // 指纹取导入前的状态：导入期间源文件被改写时，下次启动不会误用旧缓存
+        const uint64_t sourceHash = meshSourceHash(sourcePath);
+        if (!loadObjModel(sourcePath, result.model) || sourceHash == 0) return result;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        result.cacheWritten = writeMeshCache(cachePath, sourceHash, layout, result.model);
+        result.cacheWriteMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    });
+}
+
+} // namespace Core
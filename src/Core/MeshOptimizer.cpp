@@ -0,0 +1,192 @@
+#include "Core/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Core {
+
+float vertexCacheMissRatio(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize) {
+    if (indexCount < 3) return 0.0f;
+    // 时间戳只在未命中时前进：与最近一次载入相差不超过 cacheSize 即仍在 FIFO 中
+    std::vector<uint32_t> loadedAt(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t v = indices[i];
+        if (time - loadedAt[v] > cacheSize) {
+            loadedAt[v] = time++;
+            ++misses;
+        }
+    }
+    return (float)misses / (float)(indexCount / 3);
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize,
+                         std::vector<uint32_t>* clusterStarts) {
+    const size_t triCount = indices.size() / 3;
+    if (clusterStarts) clusterStarts->clear();
+    if (triCount == 0) return;
+
+    // 顶点 -> 三角形邻接表（CSR），live 为尚未输出的相邻三角形数
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i) ++live[indices[i]];
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + live[v];
+    std::vector<uint32_t> adjacency(triCount * 3);
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triCount; ++t) {
+            for (int k = 0; k < 3; ++k) adjacency[cursor[indices[t * 3 + k]]++] = (uint32_t)t;
+        }
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<uint8_t> emitted(triCount, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> out;
+    out.reserve(triCount * 3);
+    deadEnd.reserve(triCount * 3);
+    uint32_t time = cacheSize + 1;
+    uint32_t scan = 0;
+    int64_t fan = 0;
+    bool jumped = true;
+
+    while (fan >= 0) {
+        if (jumped && clusterStarts && (clusterStarts->empty() || clusterStarts->back() != out.size() / 3)) {
+            clusterStarts->push_back((uint32_t)(out.size() / 3));
+        }
+        // 输出以 fan 为中心的全部剩余三角形
+        candidates.clear();
+        for (uint32_t k = offsets[fan]; k < offsets[fan + 1]; ++k) {
+            uint32_t t = adjacency[k];
+            if (emitted[t]) continue;
+            for (int c = 0; c < 3; ++c) {
+                uint32_t v = indices[t * 3 + c];
+                out.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+            }
+            emitted[t] = 1;
+        }
+
+        // 下一个中心：仍有剩余三角形、且把它们全部输出后自身仍在缓存中的候选里，在缓存中最久的一个
+        int64_t next = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) continue;
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize) priority = time - cacheTime[v];
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+        jumped = next < 0;
+        if (jumped) {
+            // 死胡同：先回溯最近输出过的顶点，再按编号顺序扫描
+            while (!deadEnd.empty() && next < 0) {
+                uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) next = v;
+            }
+            while (next < 0 && scan < vertexCount) {
+                if (live[scan] > 0) next = scan;
+                else ++scan;
+            }
+        }
+        fan = next;
+    }
+    indices.swap(out);
+}
+
+void optimizeOverdraw(const float* vertices, std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusterStarts) {
+    const size_t triCount = indices.size() / 3;
+    if (clusterStarts.size() < 2) return;
+
+    struct Cluster {
+        uint32_t first, count;
+        float centroid[3], normal[3];
+        float area;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters(clusterStarts.size());
+    float meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        Cluster& cl = clusters[c];
+        cl.first = clusterStarts[c];
+        cl.count = (uint32_t)((c + 1 < clusters.size() ? clusterStarts[c + 1] : triCount) - cl.first);
+        memset(cl.centroid, 0, sizeof(cl.centroid));
+        memset(cl.normal, 0, sizeof(cl.normal));
+        cl.area = 0.0f;
+        for (uint32_t t = cl.first; t < cl.first + cl.count; ++t) {
+            const float* a = vertices + indices[t * 3 + 0] * 6;
+            const float* b = vertices + indices[t * 3 + 1] * 6;
+            const float* d = vertices + indices[t * 3 + 2] * 6;
+            float e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            float e1[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+            float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+            float area = 0.5f * sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; ++k) {
+                cl.centroid[k] += area * (a[k] + b[k] + d[k]) / 3.0f;
+                cl.normal[k] += n[k]; // 叉积长度即两倍面积，天然按面积加权
+            }
+            cl.area += area;
+        }
+        for (int k = 0; k < 3; ++k) meshCentroid[k] += cl.centroid[k];
+        meshArea += cl.area;
+        if (cl.area > 0.0f) {
+            for (int k = 0; k < 3; ++k) cl.centroid[k] /= cl.area;
+        }
+    }
+    if (meshArea <= 0.0f) return;
+    for (int k = 0; k < 3; ++k) meshCentroid[k] /= meshArea;
+
+    for (Cluster& cl : clusters) {
+        float len = sqrtf(cl.normal[0] * cl.normal[0] + cl.normal[1] * cl.normal[1] + cl.normal[2] * cl.normal[2]);
+        cl.sortKey = 0.0f;
+        if (len > 0.0f) {
+            for (int k = 0; k < 3; ++k) cl.sortKey += (cl.centroid[k] - meshCentroid[k]) * cl.normal[k] / len;
+        }
+    }
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> out;
+    out.reserve(indices.size());
+    for (const Cluster& cl : clusters) {
+        out.insert(out.end(), indices.begin() + cl.first * 3, indices.begin() + (cl.first + cl.count) * 3);
+    }
+    indices.swap(out);
+}
+
+MeshOrderStats optimizeMeshOrder(std::vector<float>& vertices, std::vector<unsigned short>& indices) {
+    MeshOrderStats stats;
+    const uint32_t vertexCount = (uint32_t)(vertices.size() / 6);
+    std::vector<uint32_t> wide(indices.begin(), indices.end());
+    stats.acmrBefore = vertexCacheMissRatio(wide.data(), wide.size(), vertexCount, VERTEX_CACHE_SIZE);
+    std::vector<uint32_t> clusterStarts;
+    optimizeVertexCache(wide, vertexCount, VERTEX_CACHE_SIZE, &clusterStarts);
+    optimizeOverdraw(vertices.data(), wide, clusterStarts);
+    stats.acmrAfter = vertexCacheMissRatio(wide.data(), wide.size(), vertexCount, VERTEX_CACHE_SIZE);
+
+    // 顶点按首次使用重新编号，未被引用的顶点丢弃
+    std::vector<uint32_t> remap(vertexCount, 0xFFFFFFFFu);
+    std::vector<float> reordered;
+    reordered.reserve(vertices.size());
+    for (size_t i = 0; i < wide.size(); ++i) {
+        const uint32_t v = wide[i];
+        if (remap[v] == 0xFFFFFFFFu) {
+            remap[v] = (uint32_t)(reordered.size() / 6);
+            reordered.insert(reordered.end(), vertices.begin() + v * 6, vertices.begin() + v * 6 + 6);
+        }
+        indices[i] = (unsigned short)remap[v];
+    }
+    vertices.swap(reordered);
+    return stats;
+}
+
+} // namespace Core
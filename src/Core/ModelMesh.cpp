@@ -0,0 +1,179 @@
+#include "Core/ModelMesh.h"
+#include "Core/MeshCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "../tiny_obj_loader.h"
+
+namespace Core {
+
+// 每段最多 65535 个顶点，索引 0xFFFF 不使用
+static const uint32_t MAX_PART_VERTICES = 65535;
+static const uint32_t UNMAPPED = 0xFFFFFFFFu;
+
+// 沿三角形顺序切段，段内顶点按首次使用重新编号（顶点读取也按顺序进行）
+static void splitIntoParts(const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+                           std::vector<ModelPart>& parts) {
+    std::vector<uint32_t> local(vertices.size() / 6, UNMAPPED);
+    std::vector<uint32_t> touched;
+    parts.clear();
+    parts.emplace_back();
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+        uint32_t added = (local[a] == UNMAPPED) + (local[b] == UNMAPPED) + (local[c] == UNMAPPED);
+        if (parts.back().vertices.size() / 6 + added > MAX_PART_VERTICES) {
+            for (uint32_t v : touched) local[v] = UNMAPPED;
+            touched.clear();
+            parts.emplace_back();
+        }
+        ModelPart& part = parts.back();
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = indices[t + k];
+            if (local[v] == UNMAPPED) {
+                local[v] = (uint32_t)(part.vertices.size() / 6);
+                part.vertices.insert(part.vertices.end(), vertices.begin() + v * 6, vertices.begin() + v * 6 + 6);
+                touched.push_back(v);
+            }
+            part.indices.push_back((unsigned short)local[v]);
+        }
+    }
+}
+
+bool loadObjModel(const std::string& path, ModelData& out) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point begin = Clock::now();
+    out = ModelData();
+
+    tinyobj::ObjReaderConfig config;
+    config.triangulate = true;
+    config.vertex_color = false;
+    tinyobj::ObjReader reader;
+    if (!reader.ParseFromFile(path, config)) {
+        out.error = reader.Error();
+        while (!out.error.empty() && (out.error.back() == '\n' || out.error.back() == '\r')) out.error.pop_back();
+        if (out.error.empty()) out.error = "cannot read " + path;
+        return false;
+    }
+    const tinyobj::attrib_t& attrib = reader.GetAttrib();
+    const std::vector<tinyobj::shape_t>& shapes = reader.GetShapes();
+    const size_t positionCount = attrib.vertices.size() / 3;
+    const size_t normalCount = attrib.normals.size() / 3;
+
+    // 缺少法线的面：按位置累加面积加权的面法线，得到平滑法线
+    std::vector<float> smoothNormals;
+    for (const tinyobj::shape_t& shape : shapes) {
+        const std::vector<tinyobj::index_t>& idx = shape.mesh.indices;
+        for (size_t f = 0, base = 0; f < shape.mesh.num_face_vertices.size(); base += shape.mesh.num_face_vertices[f++]) {
+            if (shape.mesh.num_face_vertices[f] != 3) continue;
+            const tinyobj::index_t* corner = &idx[base];
+            if (corner[0].normal_index >= 0 && corner[1].normal_index >= 0 && corner[2].normal_index >= 0) continue;
+            if (smoothNormals.empty()) smoothNormals.assign(positionCount * 3, 0.0f);
+            bool valid = true;
+            for (int k = 0; k < 3; ++k) valid = valid && corner[k].vertex_index >= 0 && (size_t)corner[k].vertex_index < positionCount;
+            if (!valid) continue;
+            const float* a = &attrib.vertices[corner[0].vertex_index * 3];
+            const float* b = &attrib.vertices[corner[1].vertex_index * 3];
+            const float* c = &attrib.vertices[corner[2].vertex_index * 3];
+            float e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            float e1[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+            for (int k = 0; k < 3; ++k) {
+                for (int j = 0; j < 3; ++j) smoothNormals[corner[k].vertex_index * 3 + j] += n[j];
+            }
+        }
+    }
+
+    // (位置索引, 法线索引 + 1) -> 去重后的顶点编号
+    std::unordered_map<uint64_t, uint32_t> unique;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    size_t cornerCount = 0;
+    for (const tinyobj::shape_t& shape : shapes) cornerCount += shape.mesh.indices.size();
+    unique.reserve(cornerCount);
+    indices.reserve(cornerCount);
+
+    for (const tinyobj::shape_t& shape : shapes) {
+        const std::vector<tinyobj::index_t>& idx = shape.mesh.indices;
+        for (size_t f = 0, base = 0; f < shape.mesh.num_face_vertices.size(); base += shape.mesh.num_face_vertices[f++]) {
+            if (shape.mesh.num_face_vertices[f] != 3) continue;
+            const tinyobj::index_t* corner = &idx[base];
+            uint32_t tri[3];
+            bool valid = true;
+            for (int k = 0; k < 3 && valid; ++k) {
+                const int vi = corner[k].vertex_index;
+                const int ni = corner[k].normal_index < (int)normalCount ? corner[k].normal_index : -1;
+                if (vi < 0 || (size_t)vi >= positionCount) {
+                    valid = false;
+                    break;
+                }
+                const uint64_t key = ((uint64_t)(uint32_t)vi << 32) | (uint32_t)(ni + 1);
+                auto inserted = unique.insert(std::make_pair(key, (uint32_t)(vertices.size() / 6)));
+                if (inserted.second) {
+                    float n[3] = {0.0f, 0.0f, 1.0f};
+                    const float* src = ni >= 0 ? &attrib.normals[ni * 3] : (smoothNormals.empty() ? nullptr : &smoothNormals[vi * 3]);
+                    if (src) {
+                        float len = sqrtf(src[0] * src[0] + src[1] * src[1] + src[2] * src[2]);
+                        if (len > 0.0f) {
+                            for (int j = 0; j < 3; ++j) n[j] = src[j] / len;
+                        }
+                    }
+                    for (int j = 0; j < 3; ++j) vertices.push_back(attrib.vertices[vi * 3 + j]);
+                    for (int j = 0; j < 3; ++j) vertices.push_back(n[j]);
+                }
+                tri[k] = inserted.first->second;
+            }
+            // 退化三角形不输出
+            if (!valid || tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) continue;
+            indices.insert(indices.end(), tri, tri + 3);
+        }
+    }
+    if (indices.empty()) {
+        out.error = path + ": no triangles";
+        return false;
+    }
+
+    const uint32_t vertexCount = (uint32_t)(vertices.size() / 6);
+    out.triangles = (uint32_t)(indices.size() / 3);
+    out.faceCorners = (uint32_t)indices.size();
+    out.uniqueVertices = vertexCount;
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        for (int k = 0; k < 3; ++k) {
+            const float p = vertices[v * 6 + k];
+            if (v == 0 || p < out.boundsMin[k]) out.boundsMin[k] = p;
+            if (v == 0 || p > out.boundsMax[k]) out.boundsMax[k] = p;
+        }
+    }
+
+    out.acmrBefore = vertexCacheMissRatio(indices.data(), indices.size(), vertexCount, VERTEX_CACHE_SIZE);
+    std::vector<uint32_t> clusterStarts;
+    optimizeVertexCache(indices, vertexCount, VERTEX_CACHE_SIZE, &clusterStarts);
+    optimizeOverdraw(vertices.data(), indices, clusterStarts);
+    out.acmrAfter = vertexCacheMissRatio(indices.data(), indices.size(), vertexCount, VERTEX_CACHE_SIZE);
+
+    splitIntoParts(vertices, indices, out.parts);
+    out.loadMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    return true;
+}
+
+std::future<ModelData> loadObjModelAsync(const std::string& path) {
+    return std::async(std::launch::async, [path]() {
+        ModelData data;
+        loadObjModel(path, data);
+        return data;
+    });
+}
+
+ModelMesh::ModelMesh(const ModelPart& part) {
+    setupData(part.vertices.data(), part.vertices.size(), part.indices.data(), part.indices.size());
+}
+
+ModelMesh::ModelMesh(const MeshCache& cache, uint32_t part, bool keepCpuCopy) {
+    const MeshCachePart& p = cache.part(part);
+    setupEncoded(cache.vertexData(part), p.vertexCount, cache.layout(), cache.encoding(part), p.boundsMin, p.boundsMax,
+                 cache.indexData(part), p.indexCount, keepCpuCopy);
+}
+
+} // namespace Core
@@ -5,6 +5,15 @@
 #include <glad/glad.h>
 #else
 #include <GLES2/gl2.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_OPENGL_ES3_BIT
+#define EGL_OPENGL_ES3_BIT 0x00000040
 #endif
 
 namespace Platform {
@@ -12,6 +21,13 @@ namespace Platform {
 static SDL_Window* window = nullptr;
 static SDL_GLContext glContext = nullptr;
 
+#ifndef USE_DESKTOP_GL
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLSurface eglSurface = EGL_NO_SURFACE;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+#endif
+static bool offscreen = false;
+
 
 
 bool initWindow(int width, int height) {
@@ -64,6 +80,69 @@ bool initWindow(int width, int height) {
     return true;
 }
 
+#ifndef USE_DESKTOP_GL
+// 先尝试 Mesa surfaceless 平台（不需要 X11/Wayland/DRM 主节点），失败时退回默认显示
+static bool initEGLDisplay() {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (eglDisplay != EGL_NO_DISPLAY && eglInitialize(eglDisplay, nullptr, nullptr)) return true;
+    }
+    eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    return eglDisplay != EGL_NO_DISPLAY && eglInitialize(eglDisplay, nullptr, nullptr);
+}
+#endif
+
+bool initOffscreen(int width, int height) {
+#ifdef USE_DESKTOP_GL
+    (void)width;
+    (void)height;
+    std::cerr << "Offscreen mode requires an OpenGL ES / EGL build" << std::endl;
+    return false;
+#else
+    if (!initEGLDisplay()) {
+        std::cerr << "eglInitialize failed: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+
+    // 有 pbuffer 配置时创建与屏幕同尺寸的 pbuffer 作为默认帧缓冲，否则不带表面（EGL_KHR_surfaceless_context）
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configCount) && configCount > 0) {
+        const EGLint surfaceAttribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+        eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttribs);
+    } else {
+        config = nullptr;
+    }
+
+    const EGLint contextAttribs[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_NONE};
+    eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+        std::cerr << "EGL context creation failed: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        shutdown();
+        return false;
+    }
+    offscreen = true;
+    std::cout << "Offscreen EGL context: " << glGetString(GL_RENDERER)
+              << (eglSurface != EGL_NO_SURFACE ? " (pbuffer)" : " (surfaceless)") << std::endl;
+    return true;
+#endif
+}
+
+bool isOffscreen() {
+    return offscreen;
+}
+
 void pollEvents(bool &running, InputState &in) {
     SDL_Event ev;
     while (SDL_PollEvent(&ev)) {
@@ -89,10 +168,24 @@ void pollEvents(bool &running) {
 void swapBuffers() {
     if (window) {
         SDL_GL_SwapWindow(window);
+    } else if (offscreen) {
+        glFinish();
     }
 }
 
 void shutdown() {
+#ifndef USE_DESKTOP_GL
+    if (eglDisplay != EGL_NO_DISPLAY) {
+        eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (eglContext != EGL_NO_CONTEXT) eglDestroyContext(eglDisplay, eglContext);
+        if (eglSurface != EGL_NO_SURFACE) eglDestroySurface(eglDisplay, eglSurface);
+        eglTerminate(eglDisplay);
+        eglDisplay = EGL_NO_DISPLAY;
+        eglContext = EGL_NO_CONTEXT;
+        eglSurface = EGL_NO_SURFACE;
+    }
+#endif
+    offscreen = false;
     if (glContext) SDL_GL_DeleteContext(glContext);
     if (window) SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,117 @@
+#include "Core/Profiler.h"
+#include "Core/TraceRecorder.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace Core {
+
+static const char* passNames[PROFILE_PASS_COUNT] = {
+    "beginFrame", "radiance", "blockMap+JFA", "GI", "static", "dynamic", "PPGI", "finish"
+};
+
+void PassProfiler::Series::add(uint32_t sampleFrame, double ms) {
+    if (sampleFrame == lastFrame && !values.empty()) {
+        int last = (next + WINDOW - 1) % WINDOW;
+        values[last] += ms;
+        return;
+    }
+    lastFrame = sampleFrame;
+    if ((int)values.size() < WINDOW) {
+        values.push_back(ms);
+    } else {
+        values[next] = ms;
+    }
+    next = (next + 1) % WINDOW;
+}
+
+PassStats PassProfiler::Series::stats() const {
+    PassStats s;
+    s.samples = (int)values.size();
+    if (values.empty()) return s;
+    std::vector<double> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) sum += v;
+    s.avg = sum / sorted.size();
+    // 最近秩：第 ceil(p * n) 个样本
+    auto percentile = [&sorted](double p) {
+        size_t rank = (size_t)(p * sorted.size() + 0.999999);
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+    s.p50 = percentile(0.50);
+    s.p95 = percentile(0.95);
+    s.p99 = percentile(0.99);
+    return s;
+}
+
+PassProfiler::PassProfiler() {
+    frameStart = Clock::now();
+    for (int i = 0; i < PROFILE_PASS_COUNT; ++i) passStart[i] = frameStart;
+}
+
+void PassProfiler::beginFrame() {
+    if (!active) return;
+    Clock::time_point now = Clock::now();
+    if (frameStarted) {
+        frames.add(frame, std::chrono::duration<double, std::milli>(now - frameStart).count());
+        ++frame;
+    }
+    frameStarted = true;
+    frameStart = now;
+    if (gpuTimer) gpuTimer->collect(*this);
+}
+
+void PassProfiler::beginPass(int pass) {
+    if (!active) return;
+    if (gpuTimer) gpuTimer->begin(pass, frame);
+    passStart[pass] = Clock::now();
+}
+
+void PassProfiler::endPass(int pass) {
+    if (!active) return;
+    Clock::time_point now = Clock::now();
+    cpu[pass].add(frame, std::chrono::duration<double, std::milli>(now - passStart[pass]).count());
+    if (trace) trace->record(passNames[pass], "render", passStart[pass], now, trace->frame());
+    if (gpuTimer) gpuTimer->end(pass);
+}
+
+void PassProfiler::addGpuSample(int pass, uint32_t sampleFrame, double ms) {
+    gpu[pass].add(sampleFrame, ms);
+}
+
+PassStats PassProfiler::cpuStats(int pass) const {
+    return cpu[pass].stats();
+}
+
+PassStats PassProfiler::gpuStats(int pass) const {
+    return gpu[pass].stats();
+}
+
+PassStats PassProfiler::frameStats() const {
+    return frames.stats();
+}
+
+const char* PassProfiler::passName(int pass) {
+    return pass >= 0 && pass < PROFILE_PASS_COUNT ? passNames[pass] : "?";
+}
+
+void PassProfiler::print() const {
+    printf("  %-14s %31s | %s\n", "pass (ms)", "CPU avg / p50 / p95 / p99", "GPU avg / p50 / p95 / p99");
+    for (int p = 0; p < PROFILE_PASS_COUNT; ++p) {
+        PassStats c = cpu[p].stats();
+        if (c.samples == 0) continue;
+        PassStats g = gpu[p].stats();
+        printf("  %-14s %7.3f %7.3f %7.3f %7.3f |", passNames[p], c.avg, c.p50, c.p95, c.p99);
+        if (g.samples > 0) {
+            printf(" %7.3f %7.3f %7.3f %7.3f\n", g.avg, g.p50, g.p95, g.p99);
+        } else {
+            printf(" %7s\n", "-");
+        }
+    }
+    PassStats f = frames.stats();
+    if (f.samples > 0) {
+        printf("  %-14s %7.3f %7.3f %7.3f %7.3f | (%d frames)\n", "frame", f.avg, f.p50, f.p95, f.p99, f.samples);
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,74 @@
+#include "Core/RenderQueue.h"
+#include <cstring>
+
+namespace Core {
+
+static const int DEPTH_SHIFT = 24;
+static const int MESH_SHIFT = 48;
+static const uint64_t INSTANCE_MASK = (1ull << DEPTH_SHIFT) - 1;
+// 低 3 个字节是实例下标，只作为负载，不参与排序
+static const int FIRST_SORT_BYTE = 3;
+
+void RenderQueue::build(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices) {
+    clear();
+    keys.reserve(indices.size());
+    const float* models = instances.modelMatrices();
+    const uint16_t* meshIds = instances.meshIds();
+    for (uint32_t idx : indices) {
+        const float* m = models + idx * 16;
+        const Mesh* mesh = instances.mesh(meshIds[idx]);
+        const float* localMin = mesh->boundsMin();
+        const float* localMax = mesh->boundsMax();
+        float c[3], world[3];
+        for (int k = 0; k < 3; ++k) c[k] = (localMin[k] + localMax[k]) * 0.5f;
+        for (int r = 0; r < 3; ++r) world[r] = m[12 + r] + m[r] * c[0] + m[4 + r] * c[1] + m[8 + r] * c[2];
+        // 列主序：裁剪空间 w 为 vp 第 3 行与 (world, 1) 的点积
+        float w = vp[3] * world[0] + vp[7] * world[1] + vp[11] * world[2] + vp[15];
+        push(idx, meshIds[idx], w);
+    }
+    sort();
+}
+
+void RenderQueue::clear() {
+    keys.clear();
+    sorted.clear();
+}
+
+void RenderQueue::push(uint32_t instance, uint16_t mesh, float depth) {
+    // 非负浮点数的位模式与数值同序，取高 24 位（符号位恒为 0）
+    if (!(depth > 0.0f)) depth = 0.0f;
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    keys.push_back(((uint64_t)mesh << MESH_SHIFT) | ((uint64_t)(bits >> 8) << DEPTH_SHIFT) |
+                   (instance & INSTANCE_MASK));
+}
+
+void RenderQueue::sort() {
+    const size_t n = keys.size();
+    if (n > 1) {
+        uint32_t counts[8][256];
+        memset(counts, 0, sizeof(counts));
+        for (uint64_t key : keys) {
+            for (int b = FIRST_SORT_BYTE; b < 8; ++b) ++counts[b][(key >> (b * 8)) & 0xFF];
+        }
+        scratch.resize(n);
+        for (int b = FIRST_SORT_BYTE; b < 8; ++b) {
+            uint32_t* count = counts[b];
+            const int shift = b * 8;
+            // 所有键在这个字节上相同：本趟不改变顺序
+            if (count[(keys[0] >> shift) & 0xFF] == n) continue;
+            uint32_t running = 0;
+            for (int d = 0; d < 256; ++d) {
+                uint32_t c = count[d];
+                count[d] = running;
+                running += c;
+            }
+            for (uint64_t key : keys) scratch[count[(key >> shift) & 0xFF]++] = key;
+            keys.swap(scratch);
+        }
+    }
+    sorted.resize(n);
+    for (size_t i = 0; i < n; ++i) sorted[i] = (uint32_t)(keys[i] & INSTANCE_MASK);
+}
+
+} // namespace Core
@@ -1,31 +1,73 @@
 #include "Core/Renderer.h"
 #include "Math/MathTool.h"
+#include "Math/MathSIMD.h"
+#include "Core/GeometryArena.h"
 #include <SDL.h>
 #ifdef USE_DESKTOP_GL
 #include <glad/glad.h>
 #else
-#include <GLES2/gl2.h>
+#include <GLES3/gl3.h>
 #endif
 #include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <string>
 
 
 
 using namespace Core;
 
-
+// std140 uniform 块，布局与 Renderer::FrameConstants / ObjectConstants 一致。
+// 成员显式 highp，使顶点与片元阶段的声明完全相同
+#define FRAME_BLOCK_GLSL \
+    "layout(std140) uniform FrameBlock {\n" \
+    "    highp mat4 u_vpMatrix;\n" \
+    "    highp vec3 u_lightDir;\n" \
+    "    highp vec2 u_screenSize;\n" \
+    "};\n"
+#define OBJECT_BLOCK_GLSL \
+    "layout(std140) uniform ObjectBlock {\n" \
+    "    highp mat4 u_mvpMatrix;\n" \
+    "    highp mat4 u_modelMatrix;\n" \
+    "    highp vec4 u_color;\n" \
+    "    highp vec4 u_emissive;\n" \
+    "};\n"
+// 网格顶点属性与解码，对应 GeometryArena 的 VertexLayout；MESH_* 宏由 meshShaderSource 插入。
+// 压缩位置为 int16 / half，需要 highp；反量化常量位于 POSITION_SCALE_ATTRIB / POSITION_BIAS_ATTRIB
+#define MESH_VERTEX_GLSL \
+    "layout(location = 0) in highp vec3 a_position;\n" \
+    "layout(location = 1) in vec3 a_normal;\n" \
+    "layout(location = 8) in highp vec3 a_positionScale;\n" \
+    "layout(location = 9) in highp vec3 a_positionBias;\n" \
+    "highp vec3 meshPosition() {\n" \
+    "#if MESH_POSITION_DEQUANT\n" \
+    "    return a_position * a_positionScale + a_positionBias;\n" \
+    "#else\n" \
+    "    return a_position;\n" \
+    "#endif\n" \
+    "}\n" \
+    "vec3 meshNormal() {\n" \
+    "#if MESH_OCT_NORMALS\n" \
+    "    vec3 n = vec3(a_normal.xy, 1.0 - abs(a_normal.x) - abs(a_normal.y));\n" \
+    "    float t = max(-n.z, 0.0);\n" \
+    "    n.x += n.x >= 0.0 ? -t : t;\n" \
+    "    n.y += n.y >= 0.0 ? -t : t;\n" \
+    "    return normalize(n);\n" \
+    "#else\n" \
+    "    return a_normal;\n" \
+    "#endif\n" \
+    "}\n"
 
 static const char* vertexShaderSrc = R"(
 #version 300 es
 precision mediump float;
-in vec3 a_position;
-in vec3 a_normal;
-uniform mat4 u_mvpMatrix;
-uniform mat4 u_modelMatrix;
+)" MESH_VERTEX_GLSL OBJECT_BLOCK_GLSL R"(
 out vec3 v_normal;
 out vec2 TexCoord;
 void main() {
-    gl_Position = u_mvpMatrix * vec4(a_position, 1.0);
-    v_normal = mat3(transpose(inverse(u_modelMatrix))) * a_normal;
+    gl_Position = u_mvpMatrix * vec4(meshPosition(), 1.0);
+    v_normal = mat3(transpose(inverse(u_modelMatrix))) * meshNormal();
     TexCoord = (gl_Position.xy / gl_Position.w);
 }
 )";
@@ -35,11 +77,8 @@ static const char* fragmentShaderSrc = R"(
 precision mediump float;
 out vec4 fragColor;
 in vec3 v_normal;
-uniform vec4 u_color;
-uniform vec3 u_lightDir;
-uniform vec4 u_emissive; // 新增自发光
+)" FRAME_BLOCK_GLSL OBJECT_BLOCK_GLSL R"(
 uniform sampler2D radianceTex;
-uniform vec2 u_screenSize; // 屏幕分辨率
 in vec2 TexCoord;
 void main() {
     float NdotL = dot(normalize(v_normal), normalize(-u_lightDir));
@@ -61,14 +100,74 @@ void main() {
 }
 )";
 
+// 实例化版本：model/color/emissive 来自每实例属性，VP 来自每帧的 FrameBlock
+static const char* instancedVertexShaderSrc = R"(
+#version 300 es
+precision highp float;
+)" MESH_VERTEX_GLSL R"(
+layout(location = 2) in mat4 a_instanceModel; // 占用 location 2~5
+layout(location = 6) in vec4 a_instanceColor;
+layout(location = 7) in vec4 a_instanceEmissive;
+)" FRAME_BLOCK_GLSL R"(
+out vec3 v_normal;
+out vec4 v_color;
+out vec4 v_emissive;
+void main() {
+    gl_Position = u_vpMatrix * a_instanceModel * vec4(meshPosition(), 1.0);
+    v_normal = mat3(transpose(inverse(a_instanceModel))) * meshNormal();
+    v_color = a_instanceColor;
+    v_emissive = a_instanceEmissive;
+}
+)";
 
-static const char* blockShaderSrc = R"(
+static const char* instancedFragmentShaderSrc = R"(
 #version 300 es
 precision mediump float;
+out vec4 fragColor;
+in vec3 v_normal;
+in vec4 v_color;
+in vec4 v_emissive;
+)" FRAME_BLOCK_GLSL R"(
+uniform sampler2D radianceTex;
+void main() {
+    float NdotL = dot(normalize(v_normal), normalize(-u_lightDir));
+    float diff = clamp(NdotL * 0.5 + 0.5, 0.0, 1.0);
+    vec3 diffuse = diff * v_color.rgb;
+
+    vec2 uv = gl_FragCoord.xy / u_screenSize;
+    vec3 ambient = vec3(0.05, 0.05, 0.08);
+    vec3 color = diffuse * 0.6 + v_emissive.rgb + ambient;
+    color += texture(radianceTex, uv).rgb; // 叠加全局光照
+    fragColor = vec4(color, v_color.a);
+}
+)";
+
+// 静态合批版本：顶点已在世界空间，颜色/自发光为顶点属性，片元着色器与实例化版本共用
+static const char* staticBatchVertexShaderSrc = R"(
+#version 300 es
+precision highp float;
 layout(location = 0) in vec3 a_position;
-uniform mat4 u_mvpMatrix;
+layout(location = 1) in vec3 a_normal;
+layout(location = 2) in vec4 a_color;
+layout(location = 3) in vec4 a_emissive;
+)" FRAME_BLOCK_GLSL R"(
+out vec3 v_normal;
+out vec4 v_color;
+out vec4 v_emissive;
+void main() {
+    gl_Position = u_vpMatrix * vec4(a_position, 1.0);
+    v_normal = a_normal;
+    v_color = a_color;
+    v_emissive = a_emissive;
+}
+)";
+
+static const char* blockShaderSrc = R"(
+#version 300 es
+precision mediump float;
+)" MESH_VERTEX_GLSL OBJECT_BLOCK_GLSL R"(
 void main() {
-    gl_Position = u_mvpMatrix * vec4(a_position, 1.0);
+    gl_Position = u_mvpMatrix * vec4(meshPosition(), 1.0);
 }
 )";
 
@@ -109,17 +208,16 @@ void main() {
 const char* radianceVertexShaderSrc = R"(
 #version 300 es
 precision mediump float;
-layout(location = 0) in vec3 a_position;
-uniform mat4 u_mvpMatrix;
+)" MESH_VERTEX_GLSL OBJECT_BLOCK_GLSL R"(
 void main() {
-    gl_Position = u_mvpMatrix * vec4(a_position, 1.0);
+    gl_Position = u_mvpMatrix * vec4(meshPosition(), 1.0);
 }
 )";
 const char* radianceFragmentShaderSrc = R"(
 #version 300 es
 precision mediump float;
 out vec4 FragColor;
-uniform vec4 u_emissive;
+)" OBJECT_BLOCK_GLSL R"(
 void main() {
     FragColor = u_emissive;
     //FragColor.a = 0.0; // 透明度为0
@@ -208,119 +306,138 @@ void main() {
 }
 )";
 
-const char* radianceDiffuseCascadeFragmentShaderSrc = R"(
+// Radiance Cascades：级联 i 的探针间距为 RC_PROBE_SPACING * 2^i，方向数为 4^(i+1)，
+// 只追踪区间 [r0*(4^i-1)/3, r0*(4^(i+1)-1)/3)。每级纹理按方向分块（2^(i+1) x 2^(i+1) 块，
+// 每块一张探针网格），各级大小基本相同。由粗到细逐级追踪并合并上一级：
+// 区间内的辐射 + 透射率 * 上一级 4 个子方向在当前探针位置的双线性插值
+const char* radianceCascadeFragmentShaderSrc = R"(
 #version 300 es
-precision mediump float;
+precision highp float;
+precision highp int;
 
-in vec2 TexCoord;
 out vec4 FragColor;
 
-uniform sampler2D radianceTex;
-uniform sampler2D blockMapTex;
-uniform vec2    texelSize;
+uniform highp usampler2D distanceTex;      // 遮挡物距离场
+uniform highp usampler2D sceneDistanceTex; // 遮挡物 + 发光体距离场，球面追踪不会跨过二者
+uniform sampler2D radianceTex;             // 自发光（a 为覆盖率）
+uniform sampler2D upperTex;           // 已合并的上一级（更粗）级联
+uniform vec2 u_giSize;
+uniform ivec2 u_probeCount;           // 本级每个方向块的探针数
+uniform int u_tiles;                  // 本级方向块每行个数，方向数 = u_tiles^2
+uniform float u_probeSpacing;
+uniform vec2 u_interval;              // 追踪区间 [start, end)，GI 像素
+uniform bool u_hasUpper;
+uniform ivec2 u_upperProbeCount;
+uniform float u_upperSpacing;
+
+const int MAX_ITER = 24;              // 靠近墙体或发光体时步长变小，迭代上限
+const float PI = 3.141592653589793;
+
+float fieldDistance(highp usampler2D field, ivec2 ip) {
+    uvec2 seed = texelFetch(field, ip, 0).xy;
+    if (seed.x == 65535u) return 1e6;
+    return length(vec2(seed) - vec2(ip));
+}
+
+void main() {
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    ivec2 tile = texel / u_probeCount;
+    ivec2 probe = texel - tile * u_probeCount;
+    int dirIndex = tile.y * u_tiles + tile.x;
+    float angle = (float(dirIndex) + 0.5) * 2.0 * PI / float(u_tiles * u_tiles);
+    vec2 dir = vec2(cos(angle), sin(angle));
+    vec2 origin = (vec2(probe) + 0.5) * u_probeSpacing;
+
+    // 区间内前向合成：radiance += T * 自发光，T *= 1 - 覆盖率；碰到墙或出屏则不透明
+    vec3 radiance = vec3(0.0);
+    float transmittance = 1.0;
+    float t = u_interval.x;
+    for (int i = 0; i < MAX_ITER; ++i) {
+        if (t >= u_interval.y || transmittance < 0.01) break;
+        vec2 p = origin + dir * t;
+        if (p.x < 0.0 || p.y < 0.0 || p.x >= u_giSize.x || p.y >= u_giSize.y) {
+            transmittance = 0.0;
+            break;
+        }
+        ivec2 ip = ivec2(p);
+        float d = fieldDistance(sceneDistanceTex, ip);
+        if (d < 1.0) {
+            if (fieldDistance(distanceTex, ip) < 1.0) {
+                transmittance = 0.0;
+                break;
+            }
+            vec4 emission = texelFetch(radianceTex, ip, 0);
+            radiance += transmittance * emission.rgb;
+            transmittance *= 1.0 - clamp(emission.a, 0.0, 1.0);
+            d = 1.0;
+        }
+        t += d;
+    }
 
-uniform float att_c;  // 通常取 1.0
-uniform float att_l;  // 0.7 ~ 1.8
-uniform float att_q;  // 1.8 ~ 2.5
+    if (u_hasUpper && transmittance > 0.0) {
+        vec2 q = clamp(origin / u_upperSpacing - 0.5, vec2(0.0), vec2(u_upperProbeCount - 1));
+        vec2 upperSize = vec2(textureSize(upperTex, 0));
+        int upperTiles = u_tiles * 2;
+        vec3 upper = vec3(0.0);
+        for (int k = 0; k < 4; ++k) {
+            int upperDir = dirIndex * 4 + k;
+            ivec2 upperTile = ivec2(upperDir - (upperDir / upperTiles) * upperTiles, upperDir / upperTiles);
+            upper += texture(upperTex, (vec2(upperTile * u_upperProbeCount) + q + 0.5) / upperSize).rgb;
+        }
+        radiance += transmittance * upper * 0.25;
+    }
+    FragColor = vec4(radiance, transmittance);
+}
+)";
 
-const int   STEPS1      = 16;
-const float DECAY1      = 0.95;
-const int   STEPS2      = 16;
-const float DECAY2      = 0.90;
-const float SPLIT_ANGLE = 22.5;        // 子射线偏转角度
-const float PI          = 3.141592653589793;
+// 由级联 0 得到每个 GI 像素的辐照度：4 个相邻探针双线性插值（落在墙内的探针不参与），
+// 每个探针平均 4 个方向
+const char* radianceCascadeGatherFragmentShaderSrc = R"(
+#version 300 es
+precision highp float;
+precision highp int;
 
-// 预先定义的四个对角线角度
-const float baseAngles[4] = float[4](45.0, 135.0, 225.0, 315.0);
+out vec4 FragColor;
 
-// 角度转弧度
-float rad(float deg) {
-    return deg * PI / 180.0;
+uniform highp usampler2D distanceTex;
+uniform sampler2D cascadeTex;
+uniform ivec2 u_probeCount;
+uniform float u_probeSpacing;
+uniform float u_intensity;
+
+float wallDistance(vec2 p) {
+    ivec2 ip = ivec2(p);
+    uvec2 seed = texelFetch(distanceTex, ip, 0).xy;
+    if (seed.x == 65535u) return 1e6;
+    return length(vec2(seed) - vec2(ip));
 }
 
-void main(){
-    vec3 accum = vec3(0.0);
-    if(texture(blockMapTex, TexCoord).r > 0.5)
-    {
-        FragColor = vec4(accum, 1.0);
+void main() {
+    vec2 pixel = gl_FragCoord.xy;
+    if (wallDistance(pixel) < 0.5) {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
         return;
     }
-    
 
-    // 第一级命中标记与距离
-    bool  hit1[4]    = bool[4](false, false, false, false);
-    float hitDist[4] = float[4](0.0,  0.0,   0.0,   0.0);
-
-    // —— 第一级对角线采样 —— 
-    float w1 = 1.0;
-    for(int i = 1; i <= STEPS1; ++i){
-        //w1 *= DECAY1;
-        float dist = float(i);
-        for(int d = 0; d < 4; ++d){
-            if(hit1[d]) continue;
-            float ang = rad(baseAngles[d]);
-            vec2 dir = vec2(cos(ang), sin(ang));
-            vec2 uv  = TexCoord + dir * texelSize * dist;
-
-            // 出屏或阻挡
-            if(uv.x < 0.0 || uv.x > 1.0 ||
-               uv.y < 0.0 || uv.y > 1.0 ||
-               texture(blockMapTex, uv).r > 0.5) {
-                hit1[d]    = true;
-                hitDist[d] = dist;
-                continue;
-            }
-            vec3 col = texture(radianceTex, uv).rgb;
-            if(length(col) > 0.01) {
-                float att = 1.0/(att_c + att_l*dist + att_q*dist*dist);
-                accum      += w1 * col * att;
-                hit1[d]     = true;
-                hitDist[d]  = dist;
-            }
-        }
-    }
-    for (int d = 0; d < 4; ++d) {
-        //hit1[d] = true;
-        hitDist[d] = 12.0; // 模拟第一级命中
-    }
-
-
-    // —— 第二级：在每个命中方向上分叉两条子射线 —— 
-    for(int d = 0; d < 4; ++d) {
-        //if(hit1[d]) continue;  // 只有真正命中一级才分叉
-        float baseAng = baseAngles[d];
-
-        for(int sgn = -1; sgn <= 1; sgn += 2) {
-            float childAng = baseAng + float(sgn)*SPLIT_ANGLE;
-            vec2 dir = vec2(cos(rad(childAng)), sin(rad(childAng)));
-
-            float w2 = 0.5;
-            int startI = int(hitDist[d]) + 1;
-            int endI   = startI + STEPS2;
-            for(int i = startI; i <= endI; ++i) {
-                float dist = float(i);
-                // 计算屏幕步进
-                float stepSize = mix(1.0, 3.0, dist/float(endI)); 
-                vec2 uv = TexCoord + dir * texelSize * dist * stepSize;
-                // 出界或被阻挡，才停止
-                if(uv.x<0.||uv.x>1.||uv.y<0.||uv.y>1. ||
-                texture(blockMapTex,uv).r>0.5) {
-                    break;
-                }
-
-                vec3 col = texture(radianceTex,uv).rgb;
-                if(length(col) > 0.01) {
-                    float att = 1.0/(att_c + att_l*dist + att_q*dist*dist);
-                    accum += w2 * col * att;
-                    // **不再 break**，让它再往后采，给你一道“光尾”
-                    break;
-                }
-                
-            }
+    vec2 q = pixel / u_probeSpacing - 0.5;
+    ivec2 base = ivec2(floor(q));
+    vec2 f = q - vec2(base);
+    vec3 accum = vec3(0.0);
+    float weightSum = 0.0;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            ivec2 probe = clamp(base + ivec2(x, y), ivec2(0), u_probeCount - 1);
+            float w = (x == 0 ? 1.0 - f.x : f.x) * (y == 0 ? 1.0 - f.y : f.y);
+            if (wallDistance((vec2(probe) + 0.5) * u_probeSpacing) < 0.5) w *= 0.001;
+            vec3 probeRadiance = texelFetch(cascadeTex, probe, 0).rgb
+                               + texelFetch(cascadeTex, probe + ivec2(u_probeCount.x, 0), 0).rgb
+                               + texelFetch(cascadeTex, probe + ivec2(0, u_probeCount.y), 0).rgb
+                               + texelFetch(cascadeTex, probe + u_probeCount, 0).rgb;
+            accum += w * probeRadiance * 0.25;
+            weightSum += w;
         }
     }
-
-    FragColor = vec4(accum, 1.0);
+    FragColor = vec4(accum / max(weightSum, 1e-4) * u_intensity, 1.0);
 }
 )";
 
@@ -347,9 +464,45 @@ uniform sampler2D u_radiance;  // 自发光贴图
 uniform float u_intensity;     // 发光强度
 void main() {
     vec4 sceneCol = texture(u_scene, vUV);
-    vec4 glowCol  = texture(u_radiance, vUV) * u_intensity;
+    vec3 glowCol  = texture(u_radiance, vUV).rgb * u_intensity; // a 通道为时域 GI 的可见性，不参与叠加
     // 线性叠加，可根据需求改为其它混合模式
-    FragColor = sceneCol + glowCol;
+    FragColor = vec4(sceneCol.rgb + glowCol, sceneCol.a);
+}
+)";
+
+// 低分辨率 GI 的双边上采样：取双线性的 4 个低分辨率样本，
+// 与当前像素遮挡状态（全分辨率 blockMap）不同的样本几乎不参与，避免光穿墙、墙边发暗
+const char* giUpsampleFragmentShaderSrc = R"(
+#version 300 es
+precision highp float;
+
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D giTex;        // 低分辨率 GI
+uniform sampler2D blockMapTex;  // 全分辨率遮挡图
+uniform vec2 giSize;            // 低分辨率 GI 尺寸（像素）
+
+void main() {
+    float centerBlock = step(0.5, texture(blockMapTex, TexCoord).r);
+    vec2 pos = TexCoord * giSize - 0.5;
+    vec2 base = floor(pos);
+    vec2 f = pos - base;
+    vec2 halfTexel = 0.5 / giSize;
+
+    vec3 accum = vec3(0.0);
+    float weightSum = 0.0;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            vec2 tapUV = clamp((base + vec2(float(x), float(y)) + 0.5) / giSize, halfTexel, 1.0 - halfTexel);
+            float w = (x == 0 ? 1.0 - f.x : f.x) * (y == 0 ? 1.0 - f.y : f.y);
+            float tapBlock = step(0.5, texture(blockMapTex, tapUV).r);
+            w *= 1.0 - 0.999 * abs(centerBlock - tapBlock);
+            accum += w * texture(giTex, tapUV).rgb;
+            weightSum += w;
+        }
+    }
+    FragColor = vec4(accum / max(weightSum, 1e-4), 1.0);
 }
 )";
 
@@ -414,83 +567,217 @@ void main() {
 }
 )";
 
-// 简化的SDF GI着色器 - 使用预计算的屏幕坐标
+// 跳跃泛洪（JFA）距离场：种子通道把遮挡像素（可选再加上发光像素）写成自身坐标，其余写 65535（无种子）
+const char* jfaSeedFragmentShaderSrc = R"(
+#version 300 es
+precision highp float;
+
+in vec2 TexCoord;
+layout(location = 0) out uvec2 seedOut;
+
+uniform sampler2D blockMapTex;
+uniform sampler2D radianceTex;
+uniform bool u_seedEmitters;        // Radiance Cascades 的场景距离场：发光体也作为种子
+
+void main() {
+    bool seed = texture(blockMapTex, TexCoord).r > 0.5 ||
+                (u_seedEmitters && texture(radianceTex, TexCoord).a > 0.0);
+    seedOut = seed ? uvec2(gl_FragCoord.xy) : uvec2(65535u);
+}
+)";
+
+// JFA 单步：在 3x3 邻域（间隔 u_step 像素）中取离当前像素最近的种子
+const char* jfaStepFragmentShaderSrc = R"(
+#version 300 es
+precision highp float;
+precision highp int;
+
+layout(location = 0) out uvec2 seedOut;
+
+uniform highp usampler2D seedTex;
+uniform int u_step;
+uniform ivec2 u_size;
+
+void main() {
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    uvec2 best = uvec2(65535u);
+    float bestDist = 1e20;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            ivec2 q = p + ivec2(x, y) * u_step;
+            if (any(lessThan(q, ivec2(0))) || any(greaterThanEqual(q, u_size))) continue;
+            uvec2 seed = texelFetch(seedTex, q, 0).xy;
+            if (seed.x == 65535u) continue;
+            vec2 dv = vec2(seed) - vec2(p);
+            float d = dot(dv, dv);
+            if (d < bestDist) {
+                bestDist = d;
+                best = seed;
+            }
+        }
+    }
+    seedOut = best;
+}
+)";
+
+// SDF GI着色器 - 多光源版本：光源由 CPU 分块（TiledLightList），每个像素只遍历所在块的光源列表，
+// 对每个光源在 JFA 距离场上做球面追踪判断可见性；静态光源预先烘焙在光照贴图中，只采样一次。
+// 时域模式下每帧只追踪交错相位上的像素，其余像素复用重投影后的历史可见性：a 通道按光源下标 & 3
+// 分 4 个槽位，每槽 2 位（已知, 可见），同一像素上槽位冲突的光源标记为未知、下次重新追踪；
+// 移动过的光源同样只追踪当前相位，其余像素的历史位与随光源平移后的历史像素一致时才复用，
+// 停下后 interleave 帧内各相位都按新位置追踪一次；衰减按当前光源位置重新计算，因此光照范围不会滞后
 const char* sdfGIFragmentShaderSrc = R"(
 #version 300 es
-precision mediump float;
+precision highp float;
+precision highp int;
 
 in vec2 TexCoord;
 out vec4 FragColor;
 
-uniform sampler2D blockMapTex;
+uniform highp usampler2D distanceTex;   // JFA 结果：最近遮挡像素坐标，65535 表示无遮挡
 uniform vec2 texelSize;
-uniform vec2 u_playerScreenPos;    // 预计算的玩家屏幕坐标
-uniform float u_lightRange;       // 光照范围（屏幕空间）
+
+uniform highp sampler2D lightTex;       // 第 i 列：(uv, range, moved) / (color, 0) / (上一次的 uv, 0, 0)
+uniform highp usampler2D tileTex;       // 每块 (offset, count)
+uniform highp usampler2D lightIndexTex; // 各块光源下标，按 LIGHT_INDEX_WIDTH 折行
+uniform int u_tileSize;
+
+uniform sampler2D staticLightmap;   // CPU 烘焙的静态光源辐照度（世界 XY）
+uniform mat3 u_screenToLightmap;    // 屏幕UV -> 贴图UV（地面 z=0 的单应变换）
+uniform int u_useLightmap;
+
+uniform sampler2D historyTex;     // 上一次的结果，a 通道：可见性位
+uniform mat3 u_reprojection;      // 当前屏幕UV -> 上一次屏幕UV（地面 z=0 的单应变换）
+uniform int u_interleave;         // 每帧追踪 1/u_interleave 的像素，<= 1 时全部追踪
+uniform int u_phase;              // 本帧追踪的交错相位
+
+const int MAX_TILE_LIGHTS = 16;
+const int LIGHT_INDEX_WIDTH = 1024;
+
+// 到最近遮挡像素的距离（像素）
+float wallDistance(vec2 uv) {
+    ivec2 p = ivec2(uv / texelSize);
+    uvec2 seed = texelFetch(distanceTex, p, 0).xy;
+    if (seed.x == 65535u) return 1e6;
+    return length(vec2(seed) - vec2(p));
+}
+
+bool tracedThisFrame() {
+    if (u_interleave <= 1) return true;
+    ivec2 p = ivec2(gl_FragCoord.xy) & 1;
+    int index = u_interleave == 2 ? (p.x + p.y) & 1 : p.x + 2 * p.y;
+    return index == u_phase;
+}
+
+// 当前屏幕UV 重投影到上一次的屏幕UV，w <= 0 表示无对应位置
+vec3 reproject(vec2 uv) {
+    vec3 h = u_reprojection * vec3(uv, 1.0);
+    return h.z > 0.0 ? vec3(h.xy / h.z, 1.0) : vec3(0.0);
+}
+
+// 上一次屏幕UV 处的历史可见性位，越界时全部槽位未知
+uint historyBitsAt(vec2 prevUV) {
+    if (prevUV.x < 0.0 || prevUV.x >= 1.0 || prevUV.y < 0.0 || prevUV.y >= 1.0) return 0u;
+    return uint(texelFetch(historyTex, ivec2(prevUV / texelSize), 0).a * 255.0 + 0.5);
+}
+
+// 本像素的历史可见性位，无可用历史时全部槽位未知
+uint historyBits() {
+    vec3 h = reproject(TexCoord);
+    return h.z > 0.0 ? historyBitsAt(h.xy) : 0u;
+}
+
+// 移动过的光源：历史中与光源相对位置相同的像素（上一次的光源位置 + 当前像素相对光源的偏移）
+uint movedHistoryBits(int index, vec2 lightUV) {
+    vec3 h = reproject(TexCoord);
+    vec3 l = reproject(lightUV);
+    if (h.z <= 0.0 || l.z <= 0.0) return 0u;
+    vec2 previousLight = texelFetch(lightTex, ivec2(index, 2), 0).xy;
+    return historyBitsAt(previousLight + h.xy - l.xy);
+}
+
+// 球面追踪：每步前进到最近墙体的距离，空旷区域几步即可到达光源，不会跨过薄墙
+float traceVisibility(vec2 lightUV) {
+    vec2 pixelToLight = (lightUV - TexCoord) / texelSize;
+    float pixelDistance = length(pixelToLight);
+    vec2 dir = pixelToLight / max(pixelDistance, 1e-4);
+    const int maxSteps = 24;
+    float t = 1.0;
+    for (int i = 0; i < maxSteps; i++) {
+        if (t >= pixelDistance - 1.0) break;
+        float d = wallDistance(TexCoord + dir * t * texelSize);
+        if (d < 1.0) return 0.0;
+        t += d;
+    }
+    return 1.0;
+}
 
 void main() {
     // 检查当前像素是否在墙壁中
-    if (texture(blockMapTex, TexCoord).r > 0.5) {
-        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
-        return;
-    }
-    
-    // 计算到玩家的屏幕空间距离
-    vec2 toPlayer = u_playerScreenPos - TexCoord;
-    float screenDistance = length(toPlayer);
-    
-    // 如果玩家不在屏幕内或距离太远，则不产生光照
-    if (u_playerScreenPos.x < 0.0 || u_playerScreenPos.x > 1.0 || 
-        u_playerScreenPos.y < 0.0 || u_playerScreenPos.y > 1.0 ||
-        screenDistance > u_lightRange) {
-        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+    if (wallDistance(TexCoord) < 0.5) {
+        FragColor = vec4(0.0);
         return;
     }
-    
-    // 使用光线步进进行遮挡检测 - 减少步数提高性能
-    vec2 lightDirection = normalize(toPlayer);
-    vec2 currentPos = TexCoord;
-    const int maxSteps = 16; // 减少从32到16
-    float stepSize = screenDistance / float(maxSteps);
-    bool occluded = false;
-    
-    for(int i = 1; i < maxSteps; i++) {
-        currentPos += lightDirection * stepSize;
-        
-        // 检查是否到达光源位置
-        if(length(currentPos - u_playerScreenPos) < stepSize * 2.0) {
-            break;
+
+    uvec2 range = texelFetch(tileTex, ivec2(gl_FragCoord.xy) / u_tileSize, 0).xy;
+    uint history = tracedThisFrame() ? 0u : historyBits();
+    uint bits = 0u;
+    uint usedSlots = 0u;
+    vec3 lighting = vec3(0.0);
+    if (u_useLightmap != 0) {
+        vec3 m = u_screenToLightmap * vec3(TexCoord, 1.0);
+        vec2 mapUV = m.xy / m.z;
+        if (m.z > 0.0 && all(greaterThanEqual(mapUV, vec2(0.0))) && all(lessThanEqual(mapUV, vec2(1.0)))) {
+            lighting = texture(staticLightmap, mapUV).rgb;
         }
-        
-        // 检查是否被阻挡
-        if(currentPos.x < 0.0 || currentPos.x > 1.0 || 
-           currentPos.y < 0.0 || currentPos.y > 1.0 ||
-           texture(blockMapTex, currentPos).r > 0.5) {
-            occluded = true;
-            break;
+    }
+
+    for (int k = 0; k < MAX_TILE_LIGHTS; k++) {
+        if (uint(k) >= range.y) break;
+        int entry = int(range.x) + k;
+        int index = int(texelFetch(lightIndexTex, ivec2(entry % LIGHT_INDEX_WIDTH, entry / LIGHT_INDEX_WIDTH), 0).x);
+        vec4 light = texelFetch(lightTex, ivec2(index, 0), 0);
+        float screenDistance = length(light.xy - TexCoord);
+        if (screenDistance >= light.z) continue;
+
+        int shift = (index & 3) * 2;
+        uint slot = (history >> uint(shift)) & 3u;
+        // 移动过的光源（light.w）：本像素的历史位按旧位置追踪，只有与随光源平移后的历史像素一致时才复用，
+        // 不一致说明靠近阴影边界，重新追踪
+        if (light.w != 0.0 && slot >= 2u && ((movedHistoryBits(index, light.xy) >> uint(shift)) & 3u) != slot) slot = 0u;
+        float visibility = slot >= 2u ? float(slot & 1u) : traceVisibility(light.xy);
+        if ((usedSlots & (1u << uint(index & 3))) != 0u) {
+            bits &= ~(3u << uint(shift)); // 槽位冲突：留给下一次重新追踪
+        } else {
+            bits |= (2u | uint(visibility)) << uint(shift);
+            usedSlots |= 1u << uint(index & 3);
         }
+
+        // 更平滑的二次衰减，让光照更集中
+        float attenuation = smoothstep(0.0, 1.0, 1.0 - screenDistance / light.z);
+        lighting += visibility * attenuation * attenuation * texelFetch(lightTex, ivec2(index, 1), 0).rgb;
     }
-    
-    if (occluded) {
-        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
-        return;
+
+    // 极低的环境光，只加在被照亮的像素上，营造黑暗氛围
+    if (any(greaterThan(lighting, vec3(0.0)))) {
+        lighting += vec3(0.005, 0.005, 0.01);
     }
-    
-    // 计算光照衰减（基于屏幕距离） - 更平滑的衰减
-    float attenuation = 1.0 - (screenDistance / u_lightRange);
-    attenuation = smoothstep(0.0, 1.0, attenuation); // 使用smoothstep让衰减更平滑
-    attenuation = attenuation * attenuation; // 二次衰减，让光照更集中
-    
-    // 适度的光照强度，让玩家能够看清周围
-    vec3 lightColor = vec3(1.2, 0.6, 0.3) * attenuation; // 稍微提高一点让区分更明显
-    
-    // 极低的环境光，营造黑暗氛围
-    vec3 ambient = vec3(0.005, 0.005, 0.01); // 极低的环境光，几乎全黑
-    
-    FragColor = vec4(lightColor + ambient, 1.0);
+    FragColor = vec4(lighting, float(bits) / 255.0);
 }
 )";
 
 
+// 在 #version 行之后插入当前网格顶点格式对应的 MESH_* 宏（见 MESH_VERTEX_GLSL）
+static std::string meshShaderSource(const char* src) {
+    const VertexLayout& layout = geometryArena().layout();
+    std::string out(src);
+    size_t lineEnd = out.find('\n', out.find("#version"));
+    out.insert(lineEnd + 1, std::string("#define MESH_POSITION_DEQUANT ") +
+                                (layout.position == POSITION_SNORM16 ? "1" : "0") +
+                                "\n#define MESH_OCT_NORMALS " + (layout.octNormals() ? "1" : "0") + "\n");
+    return out;
+}
+
 bool Renderer::compileShaders() {
     auto compile = [&](unsigned int type, const char* src) {
         unsigned int sh = glCreateShader(type);
@@ -505,7 +792,8 @@ bool Renderer::compileShaders() {
         }
         return sh;
     };
-    unsigned int vs = compile(GL_VERTEX_SHADER, vertexShaderSrc);
+    const std::string sceneVS = meshShaderSource(vertexShaderSrc);
+    unsigned int vs = compile(GL_VERTEX_SHADER, sceneVS.c_str());
     unsigned int fs = compile(GL_FRAGMENT_SHADER, fragmentShaderSrc);
     if (!vs || !fs) return false;
     shaderProgram = glCreateProgram();
@@ -545,7 +833,9 @@ bool Renderer::compileShaders() {
     {
             // 顶点
         unsigned int rvs = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(rvs, 1, &radianceVertexShaderSrc, nullptr);
+        const std::string radianceVS = meshShaderSource(radianceVertexShaderSrc);
+        const char* radianceVSPtr = radianceVS.c_str();
+        glShaderSource(rvs, 1, &radianceVSPtr, nullptr);
         glCompileShader(rvs);
         // 检查编译
         int ok;
@@ -573,7 +863,9 @@ bool Renderer::compileShaders() {
     //block
     {
         unsigned int bvs = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(bvs, 1, &blockShaderSrc, nullptr);
+        const std::string blockVS = meshShaderSource(blockShaderSrc);
+        const char* blockVSPtr = blockVS.c_str();
+        glShaderSource(bvs, 1, &blockVSPtr, nullptr);
         glCompileShader(bvs);
         // 检查编译...
 
@@ -630,14 +922,143 @@ bool Renderer::compileShaders() {
         }
         
         // 缓存SDF GI相关的uniform位置
-        loc_playerScreenPos = glGetUniformLocation(radianceDiffuseShaderProgram, "u_playerScreenPos");
         loc_texelSize = glGetUniformLocation(radianceDiffuseShaderProgram, "texelSize");
-        loc_lightRange = glGetUniformLocation(radianceDiffuseShaderProgram, "u_lightRange");
+        loc_lightTex = glGetUniformLocation(radianceDiffuseShaderProgram, "lightTex");
+        loc_lightTileTex = glGetUniformLocation(radianceDiffuseShaderProgram, "tileTex");
+        loc_lightIndexTex = glGetUniformLocation(radianceDiffuseShaderProgram, "lightIndexTex");
+        loc_tileSize = glGetUniformLocation(radianceDiffuseShaderProgram, "u_tileSize");
+        loc_staticLightmap = glGetUniformLocation(radianceDiffuseShaderProgram, "staticLightmap");
+        loc_screenToLightmap = glGetUniformLocation(radianceDiffuseShaderProgram, "u_screenToLightmap");
+        loc_useLightmap = glGetUniformLocation(radianceDiffuseShaderProgram, "u_useLightmap");
+        loc_distanceTex = glGetUniformLocation(radianceDiffuseShaderProgram, "distanceTex");
+        loc_historyTex = glGetUniformLocation(radianceDiffuseShaderProgram, "historyTex");
+        loc_reprojection = glGetUniformLocation(radianceDiffuseShaderProgram, "u_reprojection");
+        loc_interleave = glGetUniformLocation(radianceDiffuseShaderProgram, "u_interleave");
+        loc_phase = glGetUniformLocation(radianceDiffuseShaderProgram, "u_phase");
 
         glDeleteShader(dvs);
         glDeleteShader(dfs);
     }
 
+    // instanced scene shader
+    {
+        const std::string instancedVS = meshShaderSource(instancedVertexShaderSrc);
+        unsigned int ivs = compile(GL_VERTEX_SHADER, instancedVS.c_str());
+        unsigned int ifs = compile(GL_FRAGMENT_SHADER, instancedFragmentShaderSrc);
+        if (ivs && ifs) {
+            instancedShaderProgram = glCreateProgram();
+            glAttachShader(instancedShaderProgram, ivs);
+            glAttachShader(instancedShaderProgram, ifs);
+            glLinkProgram(instancedShaderProgram);
+            int linkOk;
+            glGetProgramiv(instancedShaderProgram, GL_LINK_STATUS, &linkOk);
+            if (!linkOk) {
+                char buf[512];
+                glGetProgramInfoLog(instancedShaderProgram, 512, nullptr, buf);
+                std::cerr << "Instanced shader link error: " << buf << std::endl;
+                glDeleteProgram(instancedShaderProgram);
+                instancedShaderProgram = 0;
+            }
+        }
+        if (ivs) glDeleteShader(ivs);
+        if (ifs) glDeleteShader(ifs);
+    }
+
+    // static batch shader
+    {
+        unsigned int bvs = compile(GL_VERTEX_SHADER, staticBatchVertexShaderSrc);
+        unsigned int bfs = compile(GL_FRAGMENT_SHADER, instancedFragmentShaderSrc);
+        if (bvs && bfs) {
+            staticBatchShaderProgram = glCreateProgram();
+            glAttachShader(staticBatchShaderProgram, bvs);
+            glAttachShader(staticBatchShaderProgram, bfs);
+            glLinkProgram(staticBatchShaderProgram);
+            int linkOk;
+            glGetProgramiv(staticBatchShaderProgram, GL_LINK_STATUS, &linkOk);
+            if (!linkOk) {
+                char buf[512];
+                glGetProgramInfoLog(staticBatchShaderProgram, 512, nullptr, buf);
+                std::cerr << "Static batch shader link error: " << buf << std::endl;
+                glDeleteProgram(staticBatchShaderProgram);
+                staticBatchShaderProgram = 0;
+            }
+        }
+        if (bvs) glDeleteShader(bvs);
+        if (bfs) glDeleteShader(bfs);
+    }
+
+    // 全屏 quad 后处理程序：顶点着色器共用 quadVertexShaderSrc
+    auto buildQuadProgram = [&](const char* fsSrc, const char* name) {
+        unsigned int qvs = compile(GL_VERTEX_SHADER, quadVertexShaderSrc);
+        unsigned int qfs = compile(GL_FRAGMENT_SHADER, fsSrc);
+        unsigned int program = 0;
+        if (qvs && qfs) {
+            program = glCreateProgram();
+            glAttachShader(program, qvs);
+            glAttachShader(program, qfs);
+            glLinkProgram(program);
+            int linkOk;
+            glGetProgramiv(program, GL_LINK_STATUS, &linkOk);
+            if (!linkOk) {
+                char buf[512];
+                glGetProgramInfoLog(program, 512, nullptr, buf);
+                std::cerr << name << " shader link error: " << buf << std::endl;
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        if (qvs) glDeleteShader(qvs);
+        if (qfs) glDeleteShader(qfs);
+        return program;
+    };
+
+    // GI bilateral upsample shader
+    giUpsampleShaderProgram = buildQuadProgram(giUpsampleFragmentShaderSrc, "GI upsample");
+    if (giUpsampleShaderProgram) {
+        loc_up_giTex = glGetUniformLocation(giUpsampleShaderProgram, "giTex");
+        loc_up_blockMapTex = glGetUniformLocation(giUpsampleShaderProgram, "blockMapTex");
+        loc_up_giSize = glGetUniformLocation(giUpsampleShaderProgram, "giSize");
+    }
+
+    // jump-flood distance field shaders
+    jfaSeedShaderProgram = buildQuadProgram(jfaSeedFragmentShaderSrc, "JFA seed");
+    jfaStepShaderProgram = buildQuadProgram(jfaStepFragmentShaderSrc, "JFA step");
+    if (jfaSeedShaderProgram) {
+        loc_jfa_blockMapTex = glGetUniformLocation(jfaSeedShaderProgram, "blockMapTex");
+        loc_jfa_radianceTex = glGetUniformLocation(jfaSeedShaderProgram, "radianceTex");
+        loc_jfa_seedEmitters = glGetUniformLocation(jfaSeedShaderProgram, "u_seedEmitters");
+    }
+    if (jfaStepShaderProgram) {
+        loc_jfa_seedTex = glGetUniformLocation(jfaStepShaderProgram, "seedTex");
+        loc_jfa_step = glGetUniformLocation(jfaStepShaderProgram, "u_step");
+        loc_jfa_size = glGetUniformLocation(jfaStepShaderProgram, "u_size");
+    }
+
+    // radiance cascades
+    cascadeShaderProgram = buildQuadProgram(radianceCascadeFragmentShaderSrc, "Radiance cascade");
+    cascadeGatherShaderProgram = buildQuadProgram(radianceCascadeGatherFragmentShaderSrc, "Radiance cascade gather");
+    if (cascadeShaderProgram) {
+        loc_rc_distanceTex = glGetUniformLocation(cascadeShaderProgram, "distanceTex");
+        loc_rc_radianceTex = glGetUniformLocation(cascadeShaderProgram, "radianceTex");
+        loc_rc_upperTex = glGetUniformLocation(cascadeShaderProgram, "upperTex");
+        loc_rc_giSize = glGetUniformLocation(cascadeShaderProgram, "u_giSize");
+        loc_rc_probeCount = glGetUniformLocation(cascadeShaderProgram, "u_probeCount");
+        loc_rc_tiles = glGetUniformLocation(cascadeShaderProgram, "u_tiles");
+        loc_rc_probeSpacing = glGetUniformLocation(cascadeShaderProgram, "u_probeSpacing");
+        loc_rc_interval = glGetUniformLocation(cascadeShaderProgram, "u_interval");
+        loc_rc_sceneDistanceTex = glGetUniformLocation(cascadeShaderProgram, "sceneDistanceTex");
+        loc_rc_hasUpper = glGetUniformLocation(cascadeShaderProgram, "u_hasUpper");
+        loc_rc_upperProbeCount = glGetUniformLocation(cascadeShaderProgram, "u_upperProbeCount");
+        loc_rc_upperSpacing = glGetUniformLocation(cascadeShaderProgram, "u_upperSpacing");
+    }
+    if (cascadeGatherShaderProgram) {
+        loc_rcg_distanceTex = glGetUniformLocation(cascadeGatherShaderProgram, "distanceTex");
+        loc_rcg_cascadeTex = glGetUniformLocation(cascadeGatherShaderProgram, "cascadeTex");
+        loc_rcg_probeCount = glGetUniformLocation(cascadeGatherShaderProgram, "u_probeCount");
+        loc_rcg_probeSpacing = glGetUniformLocation(cascadeGatherShaderProgram, "u_probeSpacing");
+        loc_rcg_intensity = glGetUniformLocation(cascadeGatherShaderProgram, "u_intensity");
+    }
+
     {
         unsigned int ppgivs = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(ppgivs, 1, &ppgiVertexShaderSrc, nullptr);
@@ -659,17 +1080,57 @@ bool Renderer::compileShaders() {
     return true;
 }
 
+// 解析 GL_VERSION（"3.3.0 ..." 或 "OpenGL ES 3.1 ..."），主版本 >= 3 即支持实例化
+static bool queryInstancingSupport() {
+    const char* version = (const char*)glGetString(GL_VERSION);
+    if (!version) return false;
+    const char* esPrefix = "OpenGL ES ";
+    if (strncmp(version, esPrefix, strlen(esPrefix)) == 0) version += strlen(esPrefix);
+    int major = 0;
+    if (sscanf(version, "%d", &major) != 1) return false;
+    return major >= 3;
+}
+
+// 着色器未声明（或编译器优化掉）该块时跳过
+static void bindUniformBlock(GLuint program, const char* name, GLuint binding) {
+    if (!program) return;
+    GLuint index = glGetUniformBlockIndex(program, name);
+    if (index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, binding);
+}
+
 bool Renderer::init() {
     if (!compileShaders()) return false;
 
+    instancingSupported = instancedShaderProgram != 0 && queryInstancingSupport();
+    if (instancingSupported) {
+        loc_inst_radianceTex = glGetUniformLocation(instancedShaderProgram, "radianceTex");
+        glGenBuffers(1, &instanceVBO);
+    }
+    std::cout << "Instanced rendering: " << (instancingSupported ? "enabled" : "disabled") << std::endl;
+    passProfiler.setGpuTimer(gpuTimers.init() ? &gpuTimers : nullptr);
+    std::cout << "GPU pass timers: " << (gpuTimers.supported() ? "enabled" : "unavailable") << std::endl;
+    if (staticBatchShaderProgram) {
+        loc_batch_radianceTex = glGetUniformLocation(staticBatchShaderProgram, "radianceTex");
+    }
+
+    // uniform 块绑定点：FrameBlock -> 0，ObjectBlock -> 1
+    bindUniformBlock(shaderProgram, "FrameBlock", FRAME_BLOCK_BINDING);
+    bindUniformBlock(shaderProgram, "ObjectBlock", OBJECT_BLOCK_BINDING);
+    bindUniformBlock(instancedShaderProgram, "FrameBlock", FRAME_BLOCK_BINDING);
+    bindUniformBlock(staticBatchShaderProgram, "FrameBlock", FRAME_BLOCK_BINDING);
+    bindUniformBlock(radianceShaderProgram, "ObjectBlock", OBJECT_BLOCK_BINDING);
+    bindUniformBlock(blockMapShaderProgram, "ObjectBlock", OBJECT_BLOCK_BINDING);
+    bool uniformRingReady = uniformRing.init(64 * 1024);
+    frameConstantsOffset = -1;
+    std::cout << "Uniform buffer ring: " << (uniformRingReady ? "enabled" : "unavailable") << std::endl;
+    if (!uniformRingReady) return false;
+
     // Cache uniform locations for performance
-    loc_mvpMatrix = glGetUniformLocation(shaderProgram, "u_mvpMatrix");
-    loc_modelMatrix = glGetUniformLocation(shaderProgram, "u_modelMatrix");
-    loc_color = glGetUniformLocation(shaderProgram, "u_color");
-    loc_emissive = glGetUniformLocation(shaderProgram, "u_emissive");
-    loc_lightDir = glGetUniformLocation(shaderProgram, "u_lightDir");
     loc_radianceTex = glGetUniformLocation(shaderProgram, "radianceTex");
-    loc_screenSize = glGetUniformLocation(shaderProgram, "u_screenSize");
+    loc_quad_screenTex = glGetUniformLocation(quadShaderProgram, "screenTex");
+    loc_ppgi_scene = glGetUniformLocation(ppgiShaderProgram, "u_scene");
+    loc_ppgi_radiance = glGetUniformLocation(ppgiShaderProgram, "u_radiance");
+    loc_ppgi_intensity = glGetUniformLocation(ppgiShaderProgram, "u_intensity");
     
     // 缓存SDF GI相关的uniform位置 - 注意这里应该等radianceDiffuseShaderProgram创建后再设置
     // 暂时先注释掉，稍后在radianceDiffuseShaderProgram创建后设置
@@ -731,8 +1192,10 @@ bool Renderer::init() {
 #endif
 
 
-    // Blur FBO
+    // Blur FBO：[0] 为 GI 分辨率的扩散结果，[1] 为上采样后的全分辨率结果
     int width = 800, height = 600;
+    giWidth = std::max(1, width / giDivisor);
+    giHeight = std::max(1, height / giDivisor);
     for (int i = 0; i < 2; ++i) {
         // 生成并绑定 FBO
         glGenFramebuffers(1, &blurFBO[i]);
@@ -741,7 +1204,7 @@ bool Renderer::init() {
         // 生成纹理
         glGenTextures(1, &blurTex[i]);
         glBindTexture(GL_TEXTURE_2D, blurTex[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height,
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, i == 0 ? giWidth : width, i == 0 ? giHeight : height,
                     0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -765,7 +1228,7 @@ bool Renderer::init() {
 
     glGenTextures(1, &radianceTex);
     glBindTexture(GL_TEXTURE_2D, radianceTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 800, 600, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, giWidth, giHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, radianceTex, 0);
@@ -805,14 +1268,19 @@ bool Renderer::init() {
     }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+    createDistanceFieldTargets();
+    createGIHistoryTarget();
+    createRadianceCascadeTargets();
 
+    // 以上创建代码直接调用 GL，之后的逐帧绑定从未知状态开始
+    glState().invalidate();
     return true;
 }
 
 void Renderer::resize(int w, int h) {
     screenWidth = w;
     screenHeight = h;
-    glViewport(0, 0, w, h);
+    glState().viewport(0, 0, w, h);
 }
 
 void Renderer::reinitializeFBOs(int width, int height) {
@@ -839,7 +1307,11 @@ void Renderer::reinitializeFBOs(int width, int height) {
         glDeleteTextures(2, blurTex);
     }
 
-    // 重新创建所有FBO和纹理，使用新的分辨率
+    // 重新创建所有FBO和纹理，使用新的分辨率；GI 链路使用按 giDivisor 缩小的分辨率
+    fboWidth = width;
+    fboHeight = height;
+    giWidth = std::max(1, width / giDivisor);
+    giHeight = std::max(1, height / giDivisor);
     // Scene FBO
     glGenFramebuffers(1, &sceneFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
@@ -871,7 +1343,8 @@ void Renderer::reinitializeFBOs(int width, int height) {
 
         glGenTextures(1, &blurTex[i]);
         glBindTexture(GL_TEXTURE_2D, blurTex[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, i == 0 ? giWidth : width, i == 0 ? giHeight : height,
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -888,7 +1361,7 @@ void Renderer::reinitializeFBOs(int width, int height) {
 
     glGenTextures(1, &radianceTex);
     glBindTexture(GL_TEXTURE_2D, radianceTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, giWidth, giHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, radianceTex, 0);
@@ -923,32 +1396,48 @@ void Renderer::reinitializeFBOs(int width, int height) {
         std::cerr << "ppgi FBO not complete!" << std::endl;
     }
 
+    // JFA 距离场（GI 分辨率）；blockMap 纹理已重建，内容需要重绘
+    createDistanceFieldTargets();
+    createGIHistoryTarget();
+    createRadianceCascadeTargets();
+    blockMapValid = false;
+    radianceValid = false;
+    giDiffuseValid = false;
+
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    std::cout << "FBOs reinitialized for resolution: " << width << "x" << height << std::endl;
+    glState().invalidate();
+    std::cout << "FBOs reinitialized for resolution: " << width << "x" << height
+              << " (GI " << giWidth << "x" << giHeight << ")" << std::endl;
 }
 
 void Renderer::render(const float mvp[16], const float model[16]) {
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram,"u_mvpMatrix"),1,GL_FALSE,mvp);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram,"u_modelMatrix"),1,GL_FALSE,model);
-    glUniform4f(glGetUniformLocation(shaderProgram,"u_color"),1.f,1.f,1.f,1.0f);
-    glUniform3f(glGetUniformLocation(shaderProgram, "u_lightDir"), 1.0f, 1.0f, 1.0f); // 你想要的光方向
+    glState().useProgram(shaderProgram);
+    const float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float lightDir[3] = {1.0f, 1.0f, 1.0f}; // 你想要的光方向
+    ObjectConstants object = {};
+    memcpy(object.mvp, mvp, sizeof(object.mvp));
+    memcpy(object.model, model, sizeof(object.model));
+    memcpy(object.color, white, sizeof(object.color));
+    bindFrameConstants(frameConstants.vp, lightDir);
+    bindObjectConstants(uploadObjectConstants(object));
 
     Cube.draw(); // 使用 CubeMesh 类来绘制立方体
 }
 
 void Renderer::render(const float vp[16], const std::vector<float*>& modelMatrices) {
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
-    glUseProgram(shaderProgram);
-    glUniform4f(glGetUniformLocation(shaderProgram,"u_color"),1.f,1.f,1.f,1.0f);
-    glUniform3f(glGetUniformLocation(shaderProgram, "u_lightDir"), 1.0f, 1.0f, 1.0f);
+    glState().useProgram(shaderProgram);
+    const float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float lightDir[3] = {1.0f, 1.0f, 1.0f};
+    bindFrameConstants(vp, lightDir);
 
-    float mvp[16];
+    ObjectConstants object = {};
+    memcpy(object.color, white, sizeof(object.color));
     for (auto model : modelMatrices) {
-        multiplyMatrices(vp, model, mvp); // mvp = vp * model
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram,"u_mvpMatrix"),1,GL_FALSE,mvp);
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram,"u_modelMatrix"),1,GL_FALSE,model);
+        multiplyMatrices(vp, model, object.mvp); // mvp = vp * model
+        memcpy(object.model, model, sizeof(object.model));
+        bindObjectConstants(uploadObjectConstants(object));
         Cube.draw();
         // Panel.draw(); // 如果需要绘制面板，可以在这里调用
     }
@@ -956,368 +1445,952 @@ void Renderer::render(const float vp[16], const std::vector<float*>& modelMatric
 void Core::Renderer::renderPanel(const float vp[16], const float model[16])
 {
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glUseProgram(shaderProgram);
-    glUniform4f(glGetUniformLocation(shaderProgram,"u_color"),1.f,1.f,1.f,1.0f);
-    glUniform3f(glGetUniformLocation(shaderProgram, "u_lightDir"), 0.2f, 0.6f, 0.8f);
-
-    float mvp[16];
-    multiplyMatrices(vp, model, mvp); // mvp = vp * model
+    glState().useProgram(shaderProgram);
+    const float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float lightDir[3] = {0.2f, 0.6f, 0.8f};
+    bindFrameConstants(vp, lightDir);
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram,"u_mvpMatrix"),1,GL_FALSE,mvp);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram,"u_modelMatrix"),1,GL_FALSE,model);
+    ObjectConstants object = {};
+    multiplyMatrices(vp, model, object.mvp); // mvp = vp * model
+    memcpy(object.model, model, sizeof(object.model));
+    memcpy(object.color, white, sizeof(object.color));
+    bindObjectConstants(uploadObjectConstants(object));
 
     Panel.draw(); // 使用 PanelMesh 类来绘制面板
 }
 
-void Renderer::renderEmissiveToRadianceFBO(const float vp[16], const std::vector<Instance*>& instances) {
-    glBindFramebuffer(GL_FRAMEBUFFER, radianceFBO);
-    glViewport(0, 0, screenWidth, screenHeight);
+void Renderer::renderEmissiveToRadianceFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_RADIANCE);
+    collectInstances(vp, instances, layerMask, passIndices);
+
+    // 各发光体的屏幕矩形；静态发光体与 VP 不变时只重绘动态发光体新旧位置的并集
+    const unsigned int* layers = instances.layers();
+    passRects.resize(passIndices.size());
+    ScreenRect dynamicRect;
+    for (size_t i = 0; i < passIndices.size(); ++i) {
+        float boundsMin[3], boundsMax[3];
+        instanceWorldBounds(instances, passIndices[i], boundsMin, boundsMax);
+        passRects[i] = projectBounds(vp, boundsMin, boundsMax, giWidth, giHeight);
+        if (!(layers[passIndices[i]] & LAYER_STATIC)) dynamicRect.unite(passRects[i]);
+    }
+    ScreenRect dirty = ScreenRect::full(giWidth, giHeight);
+    if (radianceValid && radianceStore == &instances && radianceStaticVersion == instances.staticVersion() &&
+        radianceMask == layerMask && memcmp(radianceVP, vp, sizeof(radianceVP)) == 0) {
+        dirty = radianceDynamicRect;
+        dirty.unite(dynamicRect);
+    }
+    radianceValid = true;
+    memcpy(radianceVP, vp, sizeof(radianceVP));
+    radianceStore = &instances;
+    radianceStaticVersion = instances.staticVersion();
+    radianceMask = layerMask;
+    radianceDynamicRect = dynamicRect;
+    if (dirty.empty()) return;
+    ++radianceVersion;
+
+    glState().bindFramebuffer(radianceFBO);
+    glState().viewport(0, 0, giWidth, giHeight);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(dirty.x0, dirty.y0, dirty.x1 - dirty.x0, dirty.y1 - dirty.y0);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     //glDisable(GL_DEPTH_TEST); 
 
-    std::cout << "Rendering " << instances.size() << " emissive instances" << std::endl;
+    glState().useProgram(radianceShaderProgram);
 
-    glUseProgram(radianceShaderProgram);
-
-    GLint locMVP = glGetUniformLocation(radianceShaderProgram, "u_mvpMatrix");
-    GLint locEmissive = glGetUniformLocation(radianceShaderProgram, "u_emissive");
-
-    //glBindVertexArray(vao);
-    for (const auto& inst : instances) {
-        float mvp[16];
-        multiplyMatrices(vp, inst->modelMatrix, mvp);
-        glUniformMatrix4fv(glGetUniformLocation(radianceShaderProgram, "u_mvpMatrix"), 1, GL_FALSE, mvp);
-        glUniform4fv(glGetUniformLocation(radianceShaderProgram, "u_emissive"), 1, inst->emissive);
-        std::cout << "Emissive: " << inst->emissive[0] << ", " << inst->emissive[1] << ", " << inst->emissive[2] << ", " << inst->emissive[3] << std::endl;
-        inst->mesh->draw();
+    const float* mvps = instanceMVPs(vp, instances, passIndices);
+    emissiveIndices.clear();
+    for (size_t i = 0; i < passIndices.size(); ++i) {
+        if (passRects[i].overlaps(dirty)) emissiveIndices.push_back(passIndices[i]);
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    renderQueue.build(vp, instances, emissiveIndices);
+    const std::vector<uint32_t>& order = renderQueue.order();
+    GLintptr objectBase = uploadObjectConstants(mvps, instances, order);
+    const GLintptr objectStride = uniformRing.stride(sizeof(ObjectConstants));
+    for (size_t i = 0; i < order.size(); ++i) {
+        uint32_t idx = order[i];
+        bindObjectConstants(objectBase + (GLintptr)i * objectStride);
+        instances.mesh(instances.meshIds()[idx])->draw();
+    }
+    glDisable(GL_SCISSOR_TEST);
 }
 
-void Renderer::renderBlockMap(const float vp[16], const std::vector<Instance*>& instances) {
-    glBindFramebuffer(GL_FRAMEBUFFER, blockMapFBO);
-    glViewport(0, 0, screenWidth, screenHeight);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glUseProgram(blockMapShaderProgram);
+void Renderer::renderBlockMap(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_BLOCKMAP);
+    collectInstances(vp, instances, layerMask, passIndices);
 
-    GLint locMVP = glGetUniformLocation(blockMapShaderProgram, "u_mvpMatrix");
+    // 遮挡物全为静态且 VP 未变时，上一次的 blockMap（以及由它生成的距离场）仍然有效
+    bool occludersStatic = true;
+    const unsigned int* layers = instances.layers();
+    for (uint32_t idx : passIndices) {
+        if (!(layers[idx] & LAYER_STATIC)) {
+            occludersStatic = false;
+            break;
+        }
+    }
+    if (blockMapValid && occludersStatic && blockMapStore == &instances &&
+        blockMapStaticVersion == instances.staticVersion() && blockMapMask == layerMask &&
+        memcmp(blockMapVP, vp, sizeof(blockMapVP)) == 0) {
+        return;
+    }
 
-    for (const auto& inst : instances) {
-        float mvp[16];
-        multiplyMatrices(vp, inst->modelMatrix, mvp);
-        glUniformMatrix4fv(locMVP, 1, GL_FALSE, mvp);
-        inst->mesh->draw();
+    glState().bindFramebuffer(blockMapFBO);
+    glState().viewport(0, 0, screenWidth, screenHeight);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glState().useProgram(blockMapShaderProgram);
+
+    const float* mvps = instanceMVPs(vp, instances, passIndices);
+    renderQueue.build(vp, instances, passIndices);
+    const std::vector<uint32_t>& order = renderQueue.order();
+    GLintptr objectBase = uploadObjectConstants(mvps, instances, order);
+    const GLintptr objectStride = uniformRing.stride(sizeof(ObjectConstants));
+    for (size_t i = 0; i < order.size(); ++i) {
+        bindObjectConstants(objectBase + (GLintptr)i * objectStride);
+        instances.mesh(instances.meshIds()[order[i]])->draw();
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    blockMapValid = occludersStatic;
+    memcpy(blockMapVP, vp, sizeof(blockMapVP));
+    blockMapStore = &instances;
+    blockMapStaticVersion = instances.staticVersion();
+    blockMapMask = layerMask;
+    distanceFieldValid = false;
 }
 
-void Core::Renderer::renderDiffuseFBO(const float vp[16], const std::vector<Instance *> &instances)
+// 级联 0 的探针间距与第一段区间长度（GI 像素）
+static const int RC_PROBE_SPACING = 2;
+static const float RC_INTERVAL0 = 4.0f;
+
+// Radiance Cascades 版本：radianceTex 中的所有发光体经多级级联传播，墙体由距离场遮挡。
+// 每个 GI 像素的开销与光线长度无关，级数随屏幕尺寸按 log4 增长
+void Core::Renderer::renderDiffuseFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask)
 {
-    // std::cout << "Rendering diffuse FBO..." << std::endl; // 移除调试输出
+    ProfileScope scope(passProfiler, PROFILE_GI);
     while (glGetError() != GL_NO_ERROR);
-
-    // 1) 绑定 FBO & 清屏
-    glBindFramebuffer(GL_FRAMEBUFFER, blurFBO[0]);
-    glViewport(0, 0, screenWidth, screenHeight);
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    // 2) 用扩散 Shader
-    glUseProgram(radianceDiffuseShaderProgram);
-
-    // 3) 绑定 Quad VAO
+    if (!cascadeShaderProgram || !cascadeGatherShaderProgram || cascadeCount == 0) return;
+
+    // 1) blockMap 变化后重建距离场；发光体与距离场都未变化时沿用上一次的结果
+    if (!distanceFieldValid) buildDistanceField();
+    if (cascadesValid && cascadeRadianceVersion == radianceVersion && cascadeFieldVersion == distanceFieldVersion) return;
+    cascadesValid = true;
+    cascadeRadianceVersion = radianceVersion;
+    cascadeFieldVersion = distanceFieldVersion;
+
+    // 2) 遮挡物 + 发光体的场景距离场：级联追踪在空旷处大步前进，不会跨过小发光体
+    unsigned int sceneDistanceTex = runJumpFlood(sceneJfaFBO, sceneJfaTex, true);
+    glState().bindTexture(0, distanceFieldTex);
+    glState().bindTexture(1, radianceTex);
+    glState().bindTexture(3, sceneDistanceTex);
+
+    // 3) 由粗到细逐级追踪，每级合并已完成的上一级
+    glState().useProgram(cascadeShaderProgram);
 #ifdef USE_GLES2
     bindQuadVertexAttributes();
 #else
-    glBindVertexArray(quadVAO);
+    glState().bindVertexArray(quadVAO);
 #endif
-
-    // 4) 绑定纹理 & 设置 uniform
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, radianceTex);
-    glUniform1i(glGetUniformLocation(radianceDiffuseShaderProgram, "radianceTex"), 0);
-
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, blockMapTex);
-    glUniform1i(glGetUniformLocation(radianceDiffuseShaderProgram, "blockMapTex"), 1);
-
-    glUniform2f(glGetUniformLocation(radianceDiffuseShaderProgram, "texelSize"),
-                1.0f/(float)screenWidth, 1.0f/(float)screenHeight);
-
-#ifndef USE_GLES2
-    // 只在桌面版设置复杂衰减参数
-    GLint loc_c  = glGetUniformLocation(radianceDiffuseShaderProgram, "att_c");
-    GLint loc_l  = glGetUniformLocation(radianceDiffuseShaderProgram, "att_l");
-    GLint loc_q  = glGetUniformLocation(radianceDiffuseShaderProgram, "att_q");
-
-    float kc = 0.5f;   // 常数衰减
-    float kl = 0.2f;   // 线性衰减
-    float kq = 0.00f;   // 二次衰减
-    glUniform1f(loc_c, kc);
-    glUniform1f(loc_l, kl);
-    glUniform1f(loc_q, kq);
-#endif
-
-    // 5) 绘制 Quad
+    glState().uniform1i(loc_rc_distanceTex, 0);
+    glState().uniform1i(loc_rc_radianceTex, 1);
+    glState().uniform1i(loc_rc_upperTex, 2);
+    glState().uniform1i(loc_rc_sceneDistanceTex, 3);
+    glState().uniform2f(loc_rc_giSize, (float)giWidth, (float)giHeight);
+    for (int i = cascadeCount - 1; i >= 0; --i) {
+        int tiles = 2 << i;
+        bool hasUpper = i + 1 < cascadeCount;
+        glState().bindFramebuffer(cascadeFBO[i]);
+        glState().viewport(0, 0, cascadeProbeCount[i][0] * tiles, cascadeProbeCount[i][1] * tiles);
+        glState().bindTexture(2, hasUpper ? cascadeTex[i + 1] : 0);
+        glState().uniform2i(loc_rc_probeCount, cascadeProbeCount[i][0], cascadeProbeCount[i][1]);
+        glState().uniform1i(loc_rc_tiles, tiles);
+        glState().uniform1f(loc_rc_probeSpacing, (float)(RC_PROBE_SPACING << i));
+        glState().uniform2f(loc_rc_interval, RC_INTERVAL0 * (float)((1 << 2 * i) - 1) / 3.0f,
+                    RC_INTERVAL0 * (float)((1 << 2 * (i + 1)) - 1) / 3.0f);
+        glState().uniform1i(loc_rc_hasUpper, hasUpper ? 1 : 0);
+        if (hasUpper) {
+            glState().uniform2i(loc_rc_upperProbeCount, cascadeProbeCount[i + 1][0], cascadeProbeCount[i + 1][1]);
+            glState().uniform1f(loc_rc_upperSpacing, (float)(RC_PROBE_SPACING << (i + 1)));
+        }
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+    glState().bindTexture(2, 0);
+
+    // 4) 级联 0 收集为每像素辐照度，写入 blurTex[0]
+    glState().bindFramebuffer(blurFBO[0]);
+    glState().viewport(0, 0, giWidth, giHeight);
+    glState().useProgram(cascadeGatherShaderProgram);
+    glState().bindTexture(1, cascadeTex[0]);
+    glState().uniform1i(loc_rcg_distanceTex, 0);
+    glState().uniform1i(loc_rcg_cascadeTex, 1);
+    glState().uniform2i(loc_rcg_probeCount, cascadeProbeCount[0][0], cascadeProbeCount[0][1]);
+    glState().uniform1f(loc_rcg_probeSpacing, (float)RC_PROBE_SPACING);
+    glState().uniform1f(loc_rcg_intensity, cascadeIntensity);
     glDrawArrays(GL_TRIANGLES, 0, 6);
 
-    // 6) 恢复默认 FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // 5) 上采样到全分辨率；该通道整屏重绘，SDF 版本的增量缓存随之失效
+    upsampleGI(ScreenRect::full(giWidth, giHeight));
+    giDiffuseValid = false;
 
-    // 7) 检查错误
+    // 6) 检查错误
     GLenum err = glGetError();
     if (err != GL_NO_ERROR)
-        std::cerr << "renderDiffuseFBO error: 0x" 
+        std::cerr << "renderDiffuseFBO (radiance cascades) error: 0x" 
                   << std::hex << err << std::dec << std::endl;
 }
 
-// SDF GI版本的renderDiffuseFBO函数 - 使用简化的坐标转换
-void Core::Renderer::renderDiffuseFBO(const float vp[16], const std::vector<Instance *> &instances,
-                                     const float playerWorldPos[3], const float viewProjectionMatrix[16])
+// 地面 z=0 上的屏幕重投影：当前屏幕UV -> 上一次屏幕UV 的 3x3 单应矩阵（列主序）。
+// VP 限制在 z=0 平面时为 (X, Y, 1) -> (x, y, w) 的单应，嵌入 4x4 后复用 invertMatrix
+static void floorReprojection(const float curVP[16], const float prevVP[16], float out[9]) {
+    auto planeMatrix = [](const float vp[16], float m[16]) {
+        createIdentityMatrix(m);
+        m[0] = vp[0]; m[1] = vp[1]; m[3] = vp[3];
+        m[4] = vp[4]; m[5] = vp[5]; m[7] = vp[7];
+        m[12] = vp[12]; m[13] = vp[13]; m[15] = vp[15];
+    };
+    float cur[16], prev[16], curInv[16];
+    planeMatrix(curVP, cur);
+    planeMatrix(prevVP, prev);
+    if (!invertMatrix(cur, curInv)) {
+        out[0] = 1.0f; out[1] = 0.0f; out[2] = 0.0f;
+        out[3] = 0.0f; out[4] = 1.0f; out[5] = 0.0f;
+        out[6] = 0.0f; out[7] = 0.0f; out[8] = 1.0f;
+        return;
+    }
+    // uv -> ndc，ndc -> uv
+    float uvToNdc[16], ndcToUv[16], tmp[16], r[16];
+    createIdentityMatrix(uvToNdc);
+    uvToNdc[0] = 2.0f; uvToNdc[5] = 2.0f; uvToNdc[12] = -1.0f; uvToNdc[13] = -1.0f;
+    createIdentityMatrix(ndcToUv);
+    ndcToUv[0] = 0.5f; ndcToUv[5] = 0.5f; ndcToUv[12] = 0.5f; ndcToUv[13] = 0.5f;
+    multiplyMatrices(curInv, uvToNdc, tmp);
+    multiplyMatrices(prev, tmp, r);
+    multiplyMatrices(ndcToUv, r, tmp);
+    out[0] = tmp[0];  out[1] = tmp[1];  out[2] = tmp[3];
+    out[3] = tmp[4];  out[4] = tmp[5];  out[5] = tmp[7];
+    out[6] = tmp[12]; out[7] = tmp[13]; out[8] = tmp[15];
+}
+
+void Core::Renderer::setStaticLightmap(const LightBaker& baker) {
+    if (!staticLightmapTex) {
+        glGenTextures(1, &staticLightmapTex);
+        glState().bindTexture(0, staticLightmapTex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glState().bindTexture(0, staticLightmapTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, baker.mapWidth(), baker.mapHeight(), 0, GL_RGB, GL_FLOAT,
+                 baker.irradiance().data());
+    baker.worldToMapUV(staticLightmapScale, staticLightmapOffset);
+    giDiffuseValid = false;
+}
+
+void Core::Renderer::setLightParameters(float baseRange, float intensity) {
+    sdfLights.setLightParameters(baseRange, intensity);
+    giDiffuseValid = false;
+}
+
+// SDF GI：多光源分块着色
+void Core::Renderer::renderSDFLightsFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask)
 {
+    ProfileScope scope(passProfiler, PROFILE_GI);
     while (glGetError() != GL_NO_ERROR);
 
-    // 1) 使用简化的坐标转换方法：直接从MVP矩阵获取变换后位置
-    float playerModel[16];
-    float playerMVP[16];
-    
-    // 创建玩家的模型矩阵（只有位移，无旋转缩放）
-    for (int i = 0; i < 16; i++) playerModel[i] = 0.0f;
-    playerModel[0] = playerModel[5] = playerModel[10] = playerModel[15] = 1.0f; // 单位矩阵
-    playerModel[12] = playerWorldPos[0]; // X位移
-    playerModel[13] = playerWorldPos[1]; // Y位移
-    playerModel[14] = playerWorldPos[2]; // Z位移
-    
-    // MVP变换
-    multiplyMatrices(viewProjectionMatrix, playerModel, playerMVP);
-    
-    // 直接取MVP矩阵的位移部分（第4列）作为裁剪空间坐标
-    float playerClipSpace[4];
-    for (int i = 0; i < 4; i++) {
-        playerClipSpace[i] = playerMVP[12 + i];
-    }
-    
-    // 透视除法得到NDC坐标
-    float playerNDC[2];
-    if (playerClipSpace[3] != 0.0f) {
-        playerNDC[0] = playerClipSpace[0] / playerClipSpace[3];
-        playerNDC[1] = playerClipSpace[1] / playerClipSpace[3];
+    // 1) 收集自发光实例并按屏幕块分箱
+    sdfLights.build(vp, instances, layerMask, giWidth, giHeight);
+    const std::vector<ScreenLight>& lights = sdfLights.lights();
+    const std::vector<ScreenRect>& lightRects = sdfLights.lightRects();
+
+    // 2) blockMap 变化后重建距离场
+    if (!distanceFieldValid) buildDistanceField();
+    cascadesValid = false; // blurTex[0] 将被 SDF 结果覆盖
+
+    // 3) 脏区域：着色器在所有光源半径外输出常量，距离场不变时只需重绘变化光源的新旧矩形；
+    //    光源数变化时下标整体错位，历史可见性槽位失效，重绘所有光源矩形；
+    //    数目不变时移动过的光源单独标记并记下上一次的位置，着色器用相对光源位置相同的历史像素校验可见性。
+    //    时域模式下变化区域在之后 interleave - 1 帧继续追踪补齐其余相位，只保留最近 interleave 帧的区域，
+    //    持续移动的光源不会把沿途经过的区域全部累积进来
+    bool temporal = giTemporalInterleave > 1;
+    ScreenRect changed;
+    bool lightsChanged = lights.size() != drawnLights.size();
+    movedLights.assign(lights.size(), lightsChanged ? 1 : 0);
+    movedLightsFrom.resize(lights.size() * 2);
+    if (lightsChanged) {
+        for (const ScreenRect& r : drawnLightRects) changed.unite(r);
+        for (const ScreenRect& r : lightRects) changed.unite(r);
+        giHistoryValid = false;
     } else {
-        playerNDC[0] = playerNDC[1] = 0.0f;
+        for (std::size_t i = 0; i < lights.size(); ++i) {
+            if (memcmp(&lights[i], &drawnLights[i], sizeof(ScreenLight)) != 0) {
+                movedLights[i] = lights[i].uv[0] != drawnLights[i].uv[0] || lights[i].uv[1] != drawnLights[i].uv[1];
+                movedLightsFrom[i * 2] = drawnLights[i].uv[0];
+                movedLightsFrom[i * 2 + 1] = drawnLights[i].uv[1];
+                changed.unite(drawnLightRects[i]);
+                changed.unite(lightRects[i]);
+                lightsChanged = true;
+            }
+        }
     }
-    
-    // 转换为屏幕UV坐标 [0, 1]
-    float playerScreenUV[2] = {
-        (playerNDC[0] + 1.0f) * 0.5f,
-        (playerNDC[1] + 1.0f) * 0.5f
-    };
+    ScreenRect dirty = ScreenRect::full(giWidth, giHeight);
+    if (giDiffuseValid && giDiffuseFieldVersion == distanceFieldVersion) dirty = changed;
+    if (temporal) {
+        ScreenRect current = dirty;
+        for (int k = 1; k < giTemporalInterleave; ++k) dirty.unite(giDiffuseRecent[(giDiffuseFrame - k) & 3]);
+        // 历史无效时本帧全部追踪，之前的区域也一并收敛
+        if (!giHistoryValid) {
+            for (ScreenRect& r : giDiffuseRecent) r = ScreenRect();
+            current = ScreenRect();
+        }
+        giDiffuseRecent[giDiffuseFrame & 3] = current;
+        ++giDiffuseFrame;
+    }
+    giDiffuseValid = true;
+    giDiffuseFieldVersion = distanceFieldVersion;
+    drawnLights = lights;
+    drawnLightRects = lightRects;
+    if (dirty.empty()) return;
+
+    // 时域模式：上一次的结果成为历史，写入另一张缓冲；
+    // 该缓冲还缺少上一次重绘的区域，一并补上
+    if (temporal) {
+        ScreenRect target = dirty;
+        target.unite(giDiffuseLastDrawn);
+        giDiffuseLastDrawn = dirty;
+        dirty = target;
+        std::swap(blurFBO[0], giHistoryFBO);
+        std::swap(blurTex[0], giHistoryTex);
+    }
+    uploadLightList();
 
-    // 2) 绑定 FBO & 清屏
-    glBindFramebuffer(GL_FRAMEBUFFER, blurFBO[0]);
-    glViewport(0, 0, screenWidth, screenHeight);
+    // 4) 绑定 FBO & 清除脏区域
+    glState().bindFramebuffer(blurFBO[0]);
+    glState().viewport(0, 0, giWidth, giHeight);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(dirty.x0, dirty.y0, dirty.x1 - dirty.x0, dirty.y1 - dirty.y0);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    // 3) 用SDF扩散 Shader
-    glUseProgram(radianceDiffuseShaderProgram);
-
-    // 4) 绑定 Quad VAO
+    // 5) 用SDF扩散 Shader，绑定 Quad VAO、距离场、历史与光源列表纹理
+    glState().useProgram(radianceDiffuseShaderProgram);
 #ifdef USE_GLES2
     bindQuadVertexAttributes();
 #else
-    glBindVertexArray(quadVAO);
+    glState().bindVertexArray(quadVAO);
 #endif
-
-    // 5) 绑定纹理
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, blockMapTex);
-    glUniform1i(glGetUniformLocation(radianceDiffuseShaderProgram, "blockMapTex"), 0);
-
-    // 6) 设置SDF GI相关的uniform变量
-    if (loc_playerScreenPos != -1) {
-        glUniform2f(loc_playerScreenPos, playerScreenUV[0], playerScreenUV[1]);
-    }
+    glState().bindTexture(0, distanceFieldTex);
+    glState().uniform1i(loc_distanceTex, 0);
+    glState().bindTexture(1, giHistoryTex);
+    glState().uniform1i(loc_historyTex, 1);
+    glState().bindTexture(2, lightTex);
+    glState().uniform1i(loc_lightTex, 2);
+    glState().bindTexture(3, lightTileTex);
+    glState().uniform1i(loc_lightTileTex, 3);
+    glState().bindTexture(4, lightIndexTex);
+    glState().uniform1i(loc_lightIndexTex, 4);
+    glState().bindTexture(5, staticLightmapTex);
+    glState().uniform1i(loc_staticLightmap, 5);
+    float screenToLightmap[9];
+    screenToLightmapUV(vp, staticLightmapScale, staticLightmapOffset, screenToLightmap);
+    glState().uniformMatrix3fv(loc_screenToLightmap, screenToLightmap);
+    glState().uniform1i(loc_useLightmap, staticLightmapTex ? 1 : 0);
+
+    // 历史无效（首帧、FBO 重建、刚开启时域模式、光源数变化）时本帧全部追踪
+    int interleave = (temporal && giHistoryValid) ? giTemporalInterleave : 1;
+    static const int phaseOrder4[4] = {0, 3, 1, 2}; // 2x2 交错按对角顺序轮换
+    int phase = interleave == 4 ? phaseOrder4[giTemporalFrame % 4] : (int)(giTemporalFrame % 2);
+    ++giTemporalFrame;
+    float reprojection[9];
+    floorReprojection(vp, giHistoryValid ? giHistoryVP : vp, reprojection);
+    glState().uniform1i(loc_interleave, interleave);
+    glState().uniform1i(loc_phase, phase);
+    glState().uniformMatrix3fv(loc_reprojection, reprojection);
+
+    // 6) 设置SDF GI相关的uniform变量并绘制 Quad
     if (loc_texelSize != -1) {
-        glUniform2f(loc_texelSize, 1.0f/(float)screenWidth, 1.0f/(float)screenHeight);
+        glState().uniform2f(loc_texelSize, 1.0f/(float)giWidth, 1.0f/(float)giHeight);
     }
-    if (loc_lightRange != -1) {
-        // 极大幅缩小光照范围，让效果更加微妙和局部化
-        float lightRange = 0.08f; // 从0.15缩小到0.08，让光照范围更小
-        
-        // 根据玩家位置调整光照范围，实现平滑过渡
-        if (playerScreenUV[0] >= 0.0f && playerScreenUV[0] <= 1.0f && 
-            playerScreenUV[1] >= 0.0f && playerScreenUV[1] <= 1.0f) {
-            // 玩家在屏幕内，使用基础光照范围
-            lightRange = 0.08f;
-        } else {
-            // 玩家在屏幕外，快速衰减光照
-            float distFromScreen = 0.0f;
-            if (playerScreenUV[0] < 0.0f) distFromScreen = std::max(distFromScreen, -playerScreenUV[0]);
-            if (playerScreenUV[0] > 1.0f) distFromScreen = std::max(distFromScreen, playerScreenUV[0] - 1.0f);
-            if (playerScreenUV[1] < 0.0f) distFromScreen = std::max(distFromScreen, -playerScreenUV[1]);
-            if (playerScreenUV[1] > 1.0f) distFromScreen = std::max(distFromScreen, playerScreenUV[1] - 1.0f);
-            
-            // 更快的衰减：距离一点就快速减弱
-            lightRange = 0.08f * std::max(0.0f, 1.0f - distFromScreen * 8.0f); // 增加衰减速度
-        }
-        lightRange = 0.2;
-        glUniform1f(loc_lightRange, lightRange);
-    }
-
-    // 7) 绘制 Quad
+    glState().uniform1i(loc_tileSize, TiledLightList::TILE_SIZE);
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    memcpy(giHistoryVP, vp, sizeof(giHistoryVP));
+    giHistoryValid = temporal;
 
-    // 8) 恢复默认 FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // 7) 上采样脏区域到全分辨率
+    upsampleGI(dirty);
+    glDisable(GL_SCISSOR_TEST);
 
-    // 9) 检查错误
+    // 8) 检查错误
     GLenum err = glGetError();
     if (err != GL_NO_ERROR)
-        std::cerr << "renderDiffuseFBO (SDF GI) error: 0x" 
+        std::cerr << "renderSDFLightsFBO error: 0x" 
                   << std::hex << err << std::dec << std::endl;
 }
 
 #ifdef USE_GLES2
 void Core::Renderer::bindQuadVertexAttributes() {
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    GLStateCache& gl = glState();
+    gl.bindArrayBuffer(quadVBO);
+    gl.vertexAttribPointer(0, 2, 4 * sizeof(float), 0);
+    gl.enableVertexAttrib(0);
+    gl.vertexAttribPointer(1, 2, 4 * sizeof(float), 2 * sizeof(float));
+    gl.enableVertexAttrib(1);
+    gl.disableVertexAttribsFrom(2);
 }
 #endif
 
-void Core::Renderer::renderStaticInstances(const float vp[16], const std::vector<Core::Instance*>& instances) {
+void Core::Renderer::renderStaticInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_STATIC);
     // 渲染到场景FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
-    glViewport(0, 0, screenWidth, screenHeight);
+    glState().bindFramebuffer(sceneFBO);
+    glState().viewport(0, 0, screenWidth, screenHeight);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    
-    glUseProgram(shaderProgram);
-    
-    // 设置光照方向
-    float lightDir[3] = {-1.0f, -1.0f, -1.0f};
-    glUniform3fv(loc_lightDir, 1, lightDir);
-    
-    // 绑定radiance纹理
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, radianceTex);
-    glUniform1i(loc_radianceTex, 0);
-    
-    // 设置屏幕尺寸
-    glUniform2f(loc_screenSize, (float)screenWidth, (float)screenHeight);
-    
-    for (const auto& inst : instances) {
-        float mvp[16];
-        multiplyMatrices(vp, inst->getModelMatrix(), mvp);
-        
-        glUniformMatrix4fv(loc_mvpMatrix, 1, GL_FALSE, mvp);
-        glUniformMatrix4fv(loc_modelMatrix, 1, GL_FALSE, inst->getModelMatrix());
-        
-        const float* color = inst->getColor();
-        glUniform4fv(loc_color, 1, color);
-        
-        const float* emissive = inst->getEmissive();
-        glUniform4fv(loc_emissive, 1, emissive);
-        
-        inst->mesh->draw();
+
+    if (staticBatchingEnabled && staticBatchShaderProgram) {
+        drawStaticBatch(vp, instances, layerMask);
+    } else {
+        drawSceneInstances(vp, instances, layerMask);
+    }
+}
+
+void Core::Renderer::setStaticBatchingEnabled(bool enabled) {
+    staticBatchingEnabled = enabled;
+    if (!enabled) {
+        staticBatch.release();
+        staticBatchStore = nullptr;
     }
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void Core::Renderer::renderDynamicInstances(const float vp[16], const std::vector<Core::Instance*>& instances) {
+// 合批数据只在静态实例集合变化（staticVersion 变化）或掩码变化时重新烘焙
+void Core::Renderer::drawStaticBatch(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    if (staticBatchStore != &instances || staticBatchVersion != instances.staticVersion() ||
+        staticBatchMask != layerMask) {
+        staticBatch.build(instances, layerMask);
+        staticBatchStore = &instances;
+        staticBatchVersion = instances.staticVersion();
+        staticBatchMask = layerMask;
+        std::cout << "Static batch rebuilt: " << staticBatch.triangleCount() << " triangles, "
+                  << staticBatch.removedTriangleCount() << " interior triangles removed, "
+                  << staticBatch.drawCallCount() << " draw call(s)" << std::endl;
+    }
+    if (staticBatch.empty()) return;
+
+    glState().useProgram(staticBatchShaderProgram);
+    float lightDir[3] = {-1.0f, -1.0f, -1.0f};
+    bindFrameConstants(vp, lightDir);
+    glState().bindTexture(0, radianceTex);
+    glState().uniform1i(loc_batch_radianceTex, 0);
+
+    staticBatch.draw();
+}
+
+void Core::Renderer::renderDynamicInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_DYNAMIC);
     // 渲染到场景FBO（不清空，在静态对象之上叠加动态对象）
-    glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
-    glViewport(0, 0, screenWidth, screenHeight);
+    glState().bindFramebuffer(sceneFBO);
+    glState().viewport(0, 0, screenWidth, screenHeight);
     // 不清空缓冲区，继续在sceneFBO上绘制
+
+    drawSceneInstances(vp, instances, layerMask);
+}
+
+void Core::Renderer::setCullingEnabled(bool enabled) {
+    cullingEnabled = enabled;
+}
+
+void Core::Renderer::setCullingGrid(float originX, float originY, float cellSize) {
+    cullingGrid.setGrid(originX, originY, cellSize);
+}
+
+// 按层掩码收集实例下标：开启裁剪时只返回与 vp 视锥相交的实例，否则线性扫描连续的层数组
+void Core::Renderer::collectInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask, std::vector<uint32_t>& out) {
+    if (cullingEnabled) {
+        cullingGrid.query(vp, instances, layerMask, out);
+        return;
+    }
+    out.clear();
+    const unsigned int* layers = instances.layers();
+    for (uint32_t i = 0; i < (uint32_t)instances.size(); ++i) {
+        if (layers[i] & layerMask) out.push_back(i);
+    }
+}
+
+void Core::Renderer::beginFrame(const float vp[16], uint32_t vpVersion, const InstanceStore& instances) {
+    passProfiler.beginFrame();
+    glState().newFrame();
+    ProfileScope scope(passProfiler, PROFILE_BEGIN_FRAME);
+    transformCache.update(vp, vpVersion, instances);
+}
+
+// 返回按实例下标寻址的 MVP 数组（第 idx 个实例位于 [idx * 16]）。
+// 与 beginFrame 的 VP 相同时直接使用缓存，否则只为 indices 中的实例临时计算
+const float* Core::Renderer::instanceMVPs(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices) {
+    if (transformCache.isValidFor(vp, instances)) {
+        return transformCache.mvps();
+    }
+    mvpResults.resize(instances.size() * 16);
+    for (uint32_t idx : indices) {
+        multiplyMatricesSIMD(vp, instances.modelMatrices() + idx * 16, &mvpResults[idx * 16]);
+    }
+    return mvpResults.data();
+}
+
+void Core::Renderer::drawSceneInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    collectInstances(vp, instances, layerMask, passIndices);
+    if (passIndices.empty()) return;
+    if (instancingSupported) {
+        drawInstancesInstanced(vp, instances, passIndices);
+    } else {
+        drawInstancesImmediate(vp, instances, passIndices);
+    }
+}
+
+void Core::Renderer::drawInstancesImmediate(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices) {
+    glState().useProgram(shaderProgram);
     
-    glUseProgram(shaderProgram);
-    
-    // 设置光照方向
+    // 设置光照方向与屏幕尺寸（FrameBlock）
     float lightDir[3] = {-1.0f, -1.0f, -1.0f};
-    glUniform3fv(loc_lightDir, 1, lightDir);
+    bindFrameConstants(vp, lightDir);
     
     // 绑定radiance纹理
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, radianceTex);
-    glUniform1i(loc_radianceTex, 0);
-    
-    // 设置屏幕尺寸
-    glUniform2f(loc_screenSize, (float)screenWidth, (float)screenHeight);
+    glState().bindTexture(0, radianceTex);
+    glState().uniform1i(loc_radianceTex, 0);
     
-    for (const auto& inst : instances) {
-        float mvp[16];
-        multiplyMatrices(vp, inst->getModelMatrix(), mvp);
-        
-        glUniformMatrix4fv(loc_mvpMatrix, 1, GL_FALSE, mvp);
-        glUniformMatrix4fv(loc_modelMatrix, 1, GL_FALSE, inst->getModelMatrix());
-        
-        const float* color = inst->getColor();
-        glUniform4fv(loc_color, 1, color);
-        
-        const float* emissive = inst->getEmissive();
-        glUniform4fv(loc_emissive, 1, emissive);
-        
-        inst->mesh->draw();
+    // 按网格、由近到远排序；全部实例的 ObjectBlock 一次上传，逐个绘制只切换绑定区间
+    renderQueue.build(vp, instances, indices);
+    const std::vector<uint32_t>& order = renderQueue.order();
+    const float* mvps = instanceMVPs(vp, instances, indices);
+    GLintptr objectBase = uploadObjectConstants(mvps, instances, order);
+    const GLintptr objectStride = uniformRing.stride(sizeof(ObjectConstants));
+    for (size_t i = 0; i < order.size(); ++i) {
+        bindObjectConstants(objectBase + (GLintptr)i * objectStride);
+        instances.mesh(instances.meshIds()[order[i]])->draw();
+    }
+}
+
+// 帧常量与上次上传的内容相同、且所在存储未被 orphan 时，只需（由状态缓存判断是否）重新绑定
+void Core::Renderer::bindFrameConstants(const float vp[16], const float lightDir[3]) {
+    FrameConstants frame = {};
+    memcpy(frame.vp, vp, sizeof(frame.vp));
+    memcpy(frame.lightDir, lightDir, sizeof(frame.lightDir));
+    frame.screenSize[0] = (float)screenWidth;
+    frame.screenSize[1] = (float)screenHeight;
+    if (frameConstantsOffset < 0 || frameConstantsGeneration != uniformRing.generation() ||
+        memcmp(&frame, &frameConstants, sizeof(frame)) != 0) {
+        frameConstants = frame;
+        frameConstantsOffset = uniformRing.upload(&frameConstants, sizeof(frameConstants));
+        frameConstantsGeneration = uniformRing.generation();
+    }
+    glState().bindUniformBufferRange(FRAME_BLOCK_BINDING, uniformRing.buffer(),
+                                     frameConstantsOffset, sizeof(FrameConstants));
+}
+
+GLintptr Core::Renderer::uploadObjectConstants(const float* mvps, const InstanceStore& instances, const std::vector<uint32_t>& indices) {
+    if (indices.empty()) return 0;
+    const std::size_t stride = (std::size_t)uniformRing.stride(sizeof(ObjectConstants));
+    objectUploadData.resize(indices.size() * stride);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        uint32_t idx = indices[i];
+        ObjectConstants* dst = reinterpret_cast<ObjectConstants*>(&objectUploadData[i * stride]);
+        memcpy(dst->mvp,      mvps + idx * 16,                      sizeof(dst->mvp));
+        memcpy(dst->model,    instances.modelMatrices() + idx * 16, sizeof(dst->model));
+        memcpy(dst->color,    instances.colors() + idx * 4,         sizeof(dst->color));
+        memcpy(dst->emissive, instances.emissives() + idx * 4,      sizeof(dst->emissive));
+    }
+    // 最后一条记录只需 sizeof(ObjectConstants) 字节
+    GLsizeiptr bytes = (GLsizeiptr)((indices.size() - 1) * stride + sizeof(ObjectConstants));
+    uint32_t generation = uniformRing.generation();
+    GLintptr offset = uniformRing.upload(objectUploadData.data(), bytes);
+    // 本次上传触发了 orphan：已绑定的帧常量区间随旧存储失效，立即重传
+    if (generation != uniformRing.generation() && frameConstantsOffset >= 0) {
+        bindFrameConstants(frameConstants.vp, frameConstants.lightDir);
+    }
+    return offset;
+}
+
+GLintptr Core::Renderer::uploadObjectConstants(const ObjectConstants& constants) {
+    uint32_t generation = uniformRing.generation();
+    GLintptr offset = uniformRing.upload(&constants, sizeof(constants));
+    if (generation != uniformRing.generation() && frameConstantsOffset >= 0) {
+        bindFrameConstants(frameConstants.vp, frameConstants.lightDir);
+    }
+    return offset;
+}
+
+void Core::Renderer::bindObjectConstants(GLintptr offset) {
+    glState().bindUniformBufferRange(OBJECT_BLOCK_BINDING, uniformRing.buffer(), offset, sizeof(ObjectConstants));
+}
+
+void Core::Renderer::drawInstancesInstanced(const float vp[16], const InstanceStore& instances, const std::vector<uint32_t>& indices) {
+    // 1) 排序：同一网格的实例连续，组内由近到远
+    renderQueue.build(vp, instances, indices);
+    const std::vector<uint32_t>& order = renderQueue.order();
+    const uint16_t* meshIds = instances.meshIds();
+
+    // 2) 按排序结果写入每实例数据：model(16) + color(4) + emissive(4)
+    instanceData.resize(order.size() * INSTANCE_DATA_FLOATS);
+    for (size_t i = 0; i < order.size(); ++i) {
+        uint32_t idx = order[i];
+        float* dst = &instanceData[i * INSTANCE_DATA_FLOATS];
+        memcpy(dst,      instances.modelMatrices() + idx * 16, 16 * sizeof(float));
+        memcpy(dst + 16, instances.colors() + idx * 4,         4 * sizeof(float));
+        memcpy(dst + 20, instances.emissives() + idx * 4,      4 * sizeof(float));
+    }
+
+    // 3) 一次性上传：先 orphan 旧存储（容量只增不减），再整体更新
+    GLsizeiptr bytes = (GLsizeiptr)(instanceData.size() * sizeof(float));
+    glState().bindArrayBuffer(instanceVBO);
+    instanceVBOSize = std::max(instanceVBOSize, bytes);
+    glBufferData(GL_ARRAY_BUFFER, instanceVBOSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instanceData.data());
+
+    // 4) 每帧常量只设置一次
+    glState().useProgram(instancedShaderProgram);
+    float lightDir[3] = {-1.0f, -1.0f, -1.0f};
+    bindFrameConstants(vp, lightDir);
+    glState().bindTexture(0, radianceTex);
+    glState().uniform1i(loc_inst_radianceTex, 0);
+
+    // 5) 每段连续的同网格实例一次 draw call
+    const GLintptr stride = INSTANCE_DATA_FLOATS * sizeof(float);
+    size_t first = 0;
+    while (first < order.size()) {
+        uint16_t mesh = meshIds[order[first]];
+        size_t last = first + 1;
+        while (last < order.size() && meshIds[order[last]] == mesh) ++last;
+        instances.mesh(mesh)->drawInstanced(instanceVBO, (GLintptr)first * stride, (GLsizei)(last - first));
+        first = last;
     }
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Core::Renderer::renderPPGI() {
-    glBindFramebuffer(GL_FRAMEBUFFER, postprocessingFBO_GI);
-    glViewport(0, 0, screenWidth, screenHeight);
+    ProfileScope scope(passProfiler, PROFILE_PPGI);
+    glState().bindFramebuffer(postprocessingFBO_GI);
+    glState().viewport(0, 0, screenWidth, screenHeight);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glUseProgram(ppgiShaderProgram);
+    glState().useProgram(ppgiShaderProgram);
 
 #ifdef USE_GLES2
     bindQuadVertexAttributes();
 #else
-    glBindVertexArray(quadVAO);
+    glState().bindVertexArray(quadVAO);
 #endif
 
     // 绑定场景纹理
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, sceneColorTex);
-    glUniform1i(glGetUniformLocation(ppgiShaderProgram, "u_scene"), 0);
+    glState().bindTexture(0, sceneColorTex);
+    glState().uniform1i(loc_ppgi_scene, 0);
 
-    // 绑定radiance纹理
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, blurTex[0]);
-    glUniform1i(glGetUniformLocation(ppgiShaderProgram, "u_radiance"), 1);
+    // 绑定radiance纹理（降分辨率时为上采样后的结果）
+    glState().bindTexture(1, giDivisor > 1 ? blurTex[1] : blurTex[0]);
+    glState().uniform1i(loc_ppgi_radiance, 1);
 
     // 设置强度
-    glUniform1f(glGetUniformLocation(ppgiShaderProgram, "u_intensity"), 1.0f);
+    glState().uniform1f(loc_ppgi_intensity, 1.0f);
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void Core::Renderer::setGITemporalInterleave(int interleave) {
+    interleave = interleave >= 4 ? 4 : (interleave >= 2 ? 2 : 1);
+    if (interleave == giTemporalInterleave) return;
+    giTemporalInterleave = interleave;
+    giHistoryValid = false;
+    giDiffuseValid = false;
+}
+
+void Core::Renderer::setGIResolutionDivisor(int divisor) {
+    divisor = divisor >= 4 ? 4 : (divisor >= 2 ? 2 : 1);
+    if (divisor == giDivisor) return;
+    giDivisor = divisor;
+    if (sceneFBO) reinitializeFBOs(fboWidth, fboHeight);
+}
+
+// 低分辨率扩散结果（blurTex[0]）双边上采样到全分辨率的 blurTex[1]，
+// 只处理 giRect（GI 分辨率像素）对应的区域，外扩一个 GI 纹素的双线性邻域
+void Core::Renderer::upsampleGI(const ScreenRect& giRect) {
+    if (giDivisor <= 1 || !giUpsampleShaderProgram || giRect.empty()) return;
+
+    ScreenRect rect;
+    rect.x0 = std::max(0, (giRect.x0 - 1) * giDivisor);
+    rect.y0 = std::max(0, (giRect.y0 - 1) * giDivisor);
+    rect.x1 = std::min(fboWidth, (giRect.x1 + 1) * giDivisor);
+    rect.y1 = std::min(fboHeight, (giRect.y1 + 1) * giDivisor);
+
+    glState().bindFramebuffer(blurFBO[1]);
+    glState().viewport(0, 0, fboWidth, fboHeight);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glState().useProgram(giUpsampleShaderProgram);
+
+#ifdef USE_GLES2
+    bindQuadVertexAttributes();
+#else
+    glState().bindVertexArray(quadVAO);
+#endif
+
+    glState().bindTexture(0, blurTex[0]);
+    glState().uniform1i(loc_up_giTex, 0);
+    glState().bindTexture(1, blockMapTex);
+    glState().uniform1i(loc_up_blockMapTex, 1);
+    glState().uniform2f(loc_up_giSize, (float)giWidth, (float)giHeight);
 
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    glDisable(GL_SCISSOR_TEST);
+}
+
+// JFA 读写目标：RG16UI 为 ES 3.0 必须支持的可渲染格式，整数纹理只能用最近点采样
+void Core::Renderer::createDistanceFieldTargets() {
+    if (jfaFBO[0]) {
+        glDeleteFramebuffers(2, jfaFBO);
+        glDeleteTextures(2, jfaTex);
+    }
+    for (int i = 0; i < 2; ++i) {
+        glGenFramebuffers(1, &jfaFBO[i]);
+        glBindFramebuffer(GL_FRAMEBUFFER, jfaFBO[i]);
+        glGenTextures(1, &jfaTex[i]);
+        glBindTexture(GL_TEXTURE_2D, jfaTex[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16UI, giWidth, giHeight, 0, GL_RG_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, jfaTex[i], 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "JFA FBO " << i << " not complete!" << std::endl;
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    distanceFieldTex = jfaTex[0];
+    distanceFieldValid = false;
+}
+
+// 时域 GI 的历史缓冲，与 blurTex[0] 同为 GI 分辨率
+void Core::Renderer::createGIHistoryTarget() {
+    if (giHistoryFBO) {
+        glDeleteFramebuffers(1, &giHistoryFBO);
+        glDeleteTextures(1, &giHistoryTex);
+    }
+    glGenFramebuffers(1, &giHistoryFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, giHistoryFBO);
+    glGenTextures(1, &giHistoryTex);
+    glBindTexture(GL_TEXTURE_2D, giHistoryTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, giWidth, giHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, giHistoryTex, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "GI history FBO not complete!" << std::endl;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    giHistoryValid = false;
+}
+
+// 光源列表纹理：与着色器中的 LIGHT_INDEX_WIDTH 一致
+static const int LIGHT_INDEX_WIDTH = 1024;
+
+void Core::Renderer::uploadLightList() {
+    if (!lightTex) {
+        unsigned int* textures[3] = {&lightTex, &lightTileTex, &lightIndexTex};
+        for (unsigned int* tex : textures) {
+            glGenTextures(1, tex);
+            glState().bindTexture(0, *tex);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+        glState().bindTexture(0, lightTex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, TiledLightList::MAX_LIGHTS, 3, 0, GL_RGBA, GL_FLOAT, nullptr);
+        lightTileTexSize[0] = lightTileTexSize[1] = 0;
+        lightIndexRows = 0;
+    }
+
+    // 光源：第 0 行 (uv, range, moved)，第 1 行 (color, 0)，第 2 行 (上一次的 uv, 0, 0)，只对移动过的光源有意义
+    const std::vector<ScreenLight>& lights = sdfLights.lights();
+    const int lightCount = (int)lights.size();
+    lightUploadData.assign(lightCount * 12, 0.0f);
+    for (int i = 0; i < lightCount; ++i) {
+        float* pos = &lightUploadData[i * 4];
+        float* color = &lightUploadData[(lightCount + i) * 4];
+        float* from = &lightUploadData[(lightCount * 2 + i) * 4];
+        const bool moved = i < (int)movedLights.size() && movedLights[i];
+        pos[0] = lights[i].uv[0];
+        pos[1] = lights[i].uv[1];
+        pos[2] = lights[i].range;
+        pos[3] = moved ? 1.0f : 0.0f;
+        color[0] = lights[i].color[0];
+        color[1] = lights[i].color[1];
+        color[2] = lights[i].color[2];
+        if (moved) {
+            from[0] = movedLightsFrom[i * 2];
+            from[1] = movedLightsFrom[i * 2 + 1];
+        }
+    }
+    glState().bindTexture(0, lightTex);
+    if (lightCount > 0) {
+        for (int row = 0; row < 3; ++row) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, lightCount, 1, GL_RGBA, GL_FLOAT,
+                            lightUploadData.data() + row * lightCount * 4);
+        }
+    }
+
+    // 分块 (offset, count)
+    const int tilesX = sdfLights.tilesX(), tilesY = sdfLights.tilesY();
+    glState().bindTexture(0, lightTileTex);
+    if (lightTileTexSize[0] != tilesX || lightTileTexSize[1] != tilesY) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, tilesX, tilesY, 0, GL_RG_INTEGER, GL_UNSIGNED_INT,
+                     sdfLights.tileRanges().data());
+        lightTileTexSize[0] = tilesX;
+        lightTileTexSize[1] = tilesY;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tilesX, tilesY, GL_RG_INTEGER, GL_UNSIGNED_INT,
+                        sdfLights.tileRanges().data());
+    }
+
+    // 光源下标：整行部分一次上传，末尾不足一行的部分单独上传
+    const std::vector<uint16_t>& indices = sdfLights.tileIndices();
+    const int indexCount = (int)indices.size();
+    const int rows = std::max(1, (indexCount + LIGHT_INDEX_WIDTH - 1) / LIGHT_INDEX_WIDTH);
+    glState().bindTexture(0, lightIndexTex);
+    if (rows > lightIndexRows) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, LIGHT_INDEX_WIDTH, rows, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+        lightIndexRows = rows;
+    }
+    const int fullRows = indexCount / LIGHT_INDEX_WIDTH;
+    const int tail = indexCount - fullRows * LIGHT_INDEX_WIDTH;
+    if (fullRows > 0) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LIGHT_INDEX_WIDTH, fullRows, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+                        indices.data());
+    }
+    if (tail > 0) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRows, tail, 1, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+                        indices.data() + fullRows * LIGHT_INDEX_WIDTH);
+    }
+}
+
+// Radiance Cascades 各级目标：级数取区间覆盖 GI 屏幕对角线所需的最少级数，
+// 每级探针数减半、方向数 x4，纹理大小基本不变；另有一对 JFA 纹理生成场景距离场
+void Core::Renderer::createRadianceCascadeTargets() {
+    if (cascadeCount) {
+        glDeleteFramebuffers(cascadeCount, cascadeFBO);
+        glDeleteTextures(cascadeCount, cascadeTex);
+        glDeleteFramebuffers(2, sceneJfaFBO);
+        glDeleteTextures(2, sceneJfaTex);
+    }
+    for (int i = 0; i < 2; ++i) {
+        glGenFramebuffers(1, &sceneJfaFBO[i]);
+        glBindFramebuffer(GL_FRAMEBUFFER, sceneJfaFBO[i]);
+        glGenTextures(1, &sceneJfaTex[i]);
+        glBindTexture(GL_TEXTURE_2D, sceneJfaTex[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16UI, giWidth, giHeight, 0, GL_RG_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneJfaTex[i], 0);
+    }
+    float diagonal = sqrtf((float)(giWidth * giWidth + giHeight * giHeight));
+    cascadeCount = 1;
+    while (cascadeCount < MAX_RADIANCE_CASCADES &&
+           RC_INTERVAL0 * (float)((1 << 2 * cascadeCount) - 1) / 3.0f < diagonal) {
+        ++cascadeCount;
+    }
+    for (int i = 0; i < cascadeCount; ++i) {
+        int spacing = RC_PROBE_SPACING << i;
+        int tiles = 2 << i;
+        cascadeProbeCount[i][0] = (giWidth + spacing - 1) / spacing;
+        cascadeProbeCount[i][1] = (giHeight + spacing - 1) / spacing;
+        glGenFramebuffers(1, &cascadeFBO[i]);
+        glBindFramebuffer(GL_FRAMEBUFFER, cascadeFBO[i]);
+        glGenTextures(1, &cascadeTex[i]);
+        glBindTexture(GL_TEXTURE_2D, cascadeTex[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cascadeProbeCount[i][0] * tiles, cascadeProbeCount[i][1] * tiles,
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cascadeTex[i], 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Radiance cascade FBO " << i << " not complete!" << std::endl;
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    cascadesValid = false;
+}
+
+// 跳跃泛洪：种子通道后按步长 N/2, N/4, ..., 1 做 log2(N) 次泛洪，
+// 最后再补一次步长 1（JFA+1），修正大步长阶段漏掉的少量最近种子。返回结果所在的纹理
+unsigned int Core::Renderer::runJumpFlood(unsigned int fbo[2], unsigned int tex[2], bool seedEmitters) {
+    glState().viewport(0, 0, giWidth, giHeight);
+#ifdef USE_GLES2
+    bindQuadVertexAttributes();
+#else
+    glState().bindVertexArray(quadVAO);
+#endif
+
+    glState().bindFramebuffer(fbo[0]);
+    glState().useProgram(jfaSeedShaderProgram);
+    glState().bindTexture(1, radianceTex);
+    glState().bindTexture(0, blockMapTex);
+    glState().uniform1i(loc_jfa_blockMapTex, 0);
+    glState().uniform1i(loc_jfa_radianceTex, 1);
+    glState().uniform1i(loc_jfa_seedEmitters, seedEmitters ? 1 : 0);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glState().useProgram(jfaStepShaderProgram);
+    glState().uniform1i(loc_jfa_seedTex, 0);
+    glState().uniform2i(loc_jfa_size, giWidth, giHeight);
+    int step = 1;
+    while (step * 2 < std::max(giWidth, giHeight)) step *= 2;
+    int src = 0;
+    bool extraPass = true;
+    while (step >= 1) {
+        glState().bindFramebuffer(fbo[1 - src]);
+        glState().bindTexture(0, tex[src]);
+        glState().uniform1i(loc_jfa_step, step);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        src = 1 - src;
+        if (step == 1 && extraPass) {
+            extraPass = false;
+        } else {
+            step /= 2;
+        }
+    }
+    return tex[src];
+}
+
+// 由 blockMap 生成遮挡物距离场
+void Core::Renderer::buildDistanceField() {
+    if (!jfaSeedShaderProgram || !jfaStepShaderProgram) return;
+    distanceFieldTex = runJumpFlood(jfaFBO, jfaTex, false);
+    distanceFieldValid = true;
+    ++distanceFieldVersion;
 }
 
 void Core::Renderer::OneFrameRenderFinish(bool usePostProcessing) {
+    ProfileScope scope(passProfiler, PROFILE_FINISH);
+    finishedWithPostProcessing = usePostProcessing;
     // 将最终结果渲染到屏幕
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, screenWidth, screenHeight);
+    glState().bindFramebuffer(0);
+    glState().viewport(0, 0, screenWidth, screenHeight);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
-    glUseProgram(quadShaderProgram);
+    glState().useProgram(quadShaderProgram);
     
 #ifdef USE_GLES2
     bindQuadVertexAttributes();
 #else
-    glBindVertexArray(quadVAO);
+    glState().bindVertexArray(quadVAO);
 #endif
 
-    glActiveTexture(GL_TEXTURE0);
     // 根据是否使用后处理选择纹理
-    if (usePostProcessing) {
-        glBindTexture(GL_TEXTURE_2D, postprocessingTex_GI);
-    } else {
-        glBindTexture(GL_TEXTURE_2D, sceneColorTex);
-    }
-    glUniform1i(glGetUniformLocation(quadShaderProgram, "screenTex"), 0);
+    glState().bindTexture(0, usePostProcessing ? postprocessingTex_GI : sceneColorTex);
+    glState().uniform1i(loc_quad_screenTex, 0);
     
     glDrawArrays(GL_TRIANGLES, 0, 6);
 }
 
+void Core::Renderer::readPixels(std::vector<uint8_t>& rgba, int& width, int& height) {
+    width = fboWidth;
+    height = fboHeight;
+    rgba.resize((size_t)width * height * 4);
+    glState().bindFramebuffer(finishedWithPostProcessing ? postprocessingFBO_GI : sceneFBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+}
+
 void Core::Renderer::shutdown() {
     // 清理资源
     if (shaderProgram) glDeleteProgram(shaderProgram);
@@ -1326,6 +2399,15 @@ void Core::Renderer::shutdown() {
     if (radianceDiffuseShaderProgram) glDeleteProgram(radianceDiffuseShaderProgram);
     if (blockMapShaderProgram) glDeleteProgram(blockMapShaderProgram);
     if (ppgiShaderProgram) glDeleteProgram(ppgiShaderProgram);
+    if (giUpsampleShaderProgram) glDeleteProgram(giUpsampleShaderProgram);
+    if (jfaSeedShaderProgram) glDeleteProgram(jfaSeedShaderProgram);
+    if (jfaStepShaderProgram) glDeleteProgram(jfaStepShaderProgram);
+    if (cascadeShaderProgram) glDeleteProgram(cascadeShaderProgram);
+    if (cascadeGatherShaderProgram) glDeleteProgram(cascadeGatherShaderProgram);
+    if (instancedShaderProgram) glDeleteProgram(instancedShaderProgram);
+    if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
+    if (staticBatchShaderProgram) glDeleteProgram(staticBatchShaderProgram);
+    staticBatch.release();
     
     if (sceneFBO) glDeleteFramebuffers(1, &sceneFBO);
     if (sceneColorTex) glDeleteTextures(1, &sceneColorTex);
@@ -1342,9 +2424,34 @@ void Core::Renderer::shutdown() {
     
     glDeleteFramebuffers(2, blurFBO);
     glDeleteTextures(2, blurTex);
+    glDeleteFramebuffers(2, jfaFBO);
+    glDeleteTextures(2, jfaTex);
+    if (giHistoryFBO) glDeleteFramebuffers(1, &giHistoryFBO);
+    if (giHistoryTex) glDeleteTextures(1, &giHistoryTex);
+    if (lightTex) {
+        glDeleteTextures(1, &lightTex);
+        glDeleteTextures(1, &lightTileTex);
+        glDeleteTextures(1, &lightIndexTex);
+        lightTex = lightTileTex = lightIndexTex = 0;
+    }
+    if (staticLightmapTex) {
+        glDeleteTextures(1, &staticLightmapTex);
+        staticLightmapTex = 0;
+    }
+    if (cascadeCount) {
+        glDeleteFramebuffers(cascadeCount, cascadeFBO);
+        glDeleteTextures(cascadeCount, cascadeTex);
+        glDeleteFramebuffers(2, sceneJfaFBO);
+        glDeleteTextures(2, sceneJfaTex);
+    }
     
 #ifndef USE_GLES2
     if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
 #endif
     if (quadVBO) glDeleteBuffers(1, &quadVBO);
+    passProfiler.setGpuTimer(nullptr);
+    gpuTimers.shutdown();
+    uniformRing.shutdown();
+    frameConstantsOffset = -1;
+    glState().invalidate();
 }
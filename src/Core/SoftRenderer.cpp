@@ -0,0 +1,798 @@
+#include "Core/SoftRenderer.h"
+#include "Math/MathSIMD.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PI_SOFT_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PI_SOFT_SSE 1
+#endif
+
+namespace Core {
+
+// 常驻工作线程：run() 把 [0, jobCount) 的任务按原子计数分给所有线程（调用线程也参与），全部完成后返回
+class SoftWorkerPool {
+public:
+    explicit SoftWorkerPool(int threads) {
+        for (int i = 1; i < threads; ++i) workers.emplace_back(&SoftWorkerPool::workerLoop, this);
+    }
+
+    ~SoftWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    void run(int jobCount, const std::function<void(int)>& fn) {
+        if (workers.empty() || jobCount <= 1) {
+            for (int job = 0; job < jobCount; ++job) fn(job);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &fn;
+            jobTotal = jobCount;
+            nextJob = 0;
+            pending = (int)workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        task = nullptr;
+    }
+
+private:
+    void drain() {
+        for (int job = nextJob++; job < jobTotal; job = nextJob++) (*task)(job);
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            drain();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    const std::function<void(int)>* task = nullptr;
+    int jobTotal = 0;
+    std::atomic<int> nextJob{0};
+    int pending = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+};
+
+static const uint32_t NO_SEED = 0xFFFFFFFFu;
+static const int ROWS_PER_JOB = 8;
+
+static inline float clamp01(float v) {
+    return std::min(std::max(v, 0.0f), 1.0f);
+}
+
+// GL_LINEAR + CLAMP_TO_EDGE 采样，channels 个 float 交错存放
+static void sampleBilinear(const float* img, int w, int h, int channels, float u, float v, float* out) {
+    float px = u * w - 0.5f, py = v * h - 0.5f;
+    float fx0 = floorf(px), fy0 = floorf(py);
+    float fx = px - fx0, fy = py - fy0;
+    int x0 = std::min(std::max((int)fx0, 0), w - 1), x1 = std::min(std::max((int)fx0 + 1, 0), w - 1);
+    int y0 = std::min(std::max((int)fy0, 0), h - 1), y1 = std::min(std::max((int)fy0 + 1, 0), h - 1);
+    const float* a = img + ((size_t)y0 * w + x0) * channels;
+    const float* b = img + ((size_t)y0 * w + x1) * channels;
+    const float* c = img + ((size_t)y1 * w + x0) * channels;
+    const float* d = img + ((size_t)y1 * w + x1) * channels;
+    for (int i = 0; i < channels; ++i) {
+        float top = a[i] + (b[i] - a[i]) * fx;
+        float bottom = c[i] + (d[i] - c[i]) * fx;
+        out[i] = top + (bottom - top) * fy;
+    }
+}
+
+// blockMap（0 / 1）的双线性采样
+static float sampleBlockMap(const uint8_t* img, int w, int h, float u, float v) {
+    float px = u * w - 0.5f, py = v * h - 0.5f;
+    float fx0 = floorf(px), fy0 = floorf(py);
+    float fx = px - fx0, fy = py - fy0;
+    int x0 = std::min(std::max((int)fx0, 0), w - 1), x1 = std::min(std::max((int)fx0 + 1, 0), w - 1);
+    int y0 = std::min(std::max((int)fy0, 0), h - 1), y1 = std::min(std::max((int)fy0 + 1, 0), h - 1);
+    float top = img[(size_t)y0 * w + x0] + (img[(size_t)y0 * w + x1] - img[(size_t)y0 * w + x0]) * fx;
+    float bottom = img[(size_t)y1 * w + x0] + (img[(size_t)y1 * w + x1] - img[(size_t)y1 * w + x0]) * fx;
+    return top + (bottom - top) * fy;
+}
+
+// 三角形的边函数 e[k] = A[k] * x + B[k] * y + C[k]（与顶点 k 相对的边，内侧为正）与深度平面
+struct EdgeSetup {
+    float A[3], B[3], C[3];
+    float zA, zB, zC;
+    float invArea;
+};
+
+// 从像素中心 (px, py) 起一行 4 个像素：三条边函数均 >= 0 为覆盖，depth 非空时再做 LESS 测试。
+// 返回 4 位覆盖掩码，e 输出各像素的边函数值（重心坐标 = e * invArea），z 输出插值深度
+#if defined(PI_SOFT_NEON)
+
+static int coverQuad(const EdgeSetup& s, float px, float py, const float* depth, float e[3][4], float z[4]) {
+    static const float laneOffsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    static const uint32_t laneBits[4] = {1u, 2u, 4u, 8u};
+    const float32x4_t x = vaddq_f32(vdupq_n_f32(px), vld1q_f32(laneOffsets));
+    const float32x4_t y = vdupq_n_f32(py);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+    for (int k = 0; k < 3; ++k) {
+        float32x4_t ek = vmlaq_f32(vmlaq_f32(vdupq_n_f32(s.C[k]), vdupq_n_f32(s.A[k]), x), vdupq_n_f32(s.B[k]), y);
+        vst1q_f32(e[k], ek);
+        inside = vandq_u32(inside, vcgeq_f32(ek, zero));
+    }
+    float32x4_t vz = vmlaq_f32(vmlaq_f32(vdupq_n_f32(s.zC), vdupq_n_f32(s.zA), x), vdupq_n_f32(s.zB), y);
+    vst1q_f32(z, vz);
+    if (depth) inside = vandq_u32(inside, vcltq_f32(vz, vld1q_f32(depth)));
+    uint32x4_t bits = vandq_u32(inside, vld1q_u32(laneBits));
+    uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+    return (int)vget_lane_u32(vpadd_u32(sum, sum), 0);
+}
+
+#elif defined(PI_SOFT_SSE)
+
+static int coverQuad(const EdgeSetup& s, float px, float py, const float* depth, float e[3][4], float z[4]) {
+    const __m128 x = _mm_add_ps(_mm_set1_ps(px), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    const __m128 y = _mm_set1_ps(py);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 inside = _mm_cmpeq_ps(zero, zero);
+    for (int k = 0; k < 3; ++k) {
+        __m128 ek = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(s.A[k]), x), _mm_mul_ps(_mm_set1_ps(s.B[k]), y)),
+                               _mm_set1_ps(s.C[k]));
+        _mm_storeu_ps(e[k], ek);
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(ek, zero));
+    }
+    __m128 vz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(s.zA), x), _mm_mul_ps(_mm_set1_ps(s.zB), y)),
+                           _mm_set1_ps(s.zC));
+    _mm_storeu_ps(z, vz);
+    if (depth) inside = _mm_and_ps(inside, _mm_cmplt_ps(vz, _mm_loadu_ps(depth)));
+    return _mm_movemask_ps(inside);
+}
+
+#else
+
+static int coverQuad(const EdgeSetup& s, float px, float py, const float* depth, float e[3][4], float z[4]) {
+    int mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        float x = px + (float)i;
+        bool inside = true;
+        for (int k = 0; k < 3; ++k) {
+            e[k][i] = s.A[k] * x + s.B[k] * py + s.C[k];
+            inside = inside && e[k][i] >= 0.0f;
+        }
+        z[i] = s.zA * x + s.zB * py + s.zC;
+        if (depth && !(z[i] < depth[i])) inside = false;
+        if (inside) mask |= 1 << i;
+    }
+    return mask;
+}
+
+#endif
+
+SoftRenderer::SoftRenderer() {
+    memset(blockMapVP, 0, sizeof(blockMapVP));
+}
+
+SoftRenderer::~SoftRenderer() {
+    shutdown();
+}
+
+void SoftRenderer::setThreadCount(int threads) {
+    threadCount = threads;
+    if (pool) pool.reset(new SoftWorkerPool(threadCount > 0 ? threadCount : std::max(1, (int)std::thread::hardware_concurrency())));
+}
+
+bool SoftRenderer::init() {
+    int threads = threadCount > 0 ? threadCount : std::max(1, (int)std::thread::hardware_concurrency());
+    pool.reset(new SoftWorkerPool(threads));
+    reinitializeFBOs(width, height);
+    return true;
+}
+
+void SoftRenderer::reinitializeFBOs(int w, int h) {
+    width = std::max(1, w);
+    height = std::max(1, h);
+    giWidth = std::max(1, width / giDivisor);
+    giHeight = std::max(1, height / giDivisor);
+
+    const size_t pixels = (size_t)width * height;
+    const size_t giPixels = (size_t)giWidth * giHeight;
+    // 光栅化按 4 像素一组读取深度，末尾留出余量
+    sceneColor.assign(pixels * 4, 0.0f);
+    sceneDepth.assign(pixels + 4, 1.0f);
+    radiance.assign(giPixels * 4, 0.0f);
+    blockMap.assign(pixels, 0);
+    distanceField.assign(giPixels, NO_SEED);
+    jfaScratch.assign(giPixels, NO_SEED);
+    giBlockMap.assign(giPixels, 0);
+    giColor.assign(giPixels * 4, 0.0f);
+    giFull.assign(giDivisor > 1 ? pixels * 4 : 0, 0.0f);
+    ppColor.assign(pixels * 4, 0.0f);
+    finalColor = &sceneColor;
+    blockMapValid = false;
+}
+
+void SoftRenderer::shutdown() {
+    pool.reset();
+    sceneColor.clear();
+    sceneDepth.clear();
+    radiance.clear();
+    blockMap.clear();
+    distanceField.clear();
+    jfaScratch.clear();
+    giBlockMap.clear();
+    giColor.clear();
+    giFull.clear();
+    ppColor.clear();
+    finalColor = nullptr;
+    blockMapValid = false;
+}
+
+void SoftRenderer::setGIResolutionDivisor(int divisor) {
+    divisor = divisor >= 4 ? 4 : (divisor >= 2 ? 2 : 1);
+    if (divisor == giDivisor) return;
+    giDivisor = divisor;
+    if (!sceneColor.empty()) reinitializeFBOs(width, height);
+}
+
+void SoftRenderer::setLightParameters(float baseRange, float intensity) {
+    sdfLights.setLightParameters(baseRange, intensity);
+}
+
+void SoftRenderer::setStaticLightmap(const LightBaker& baker) {
+    lightmap = baker.irradiance();
+    lightmapW = baker.mapWidth();
+    lightmapH = baker.mapHeight();
+    baker.worldToMapUV(lightmapScale, lightmapOffset);
+}
+
+void SoftRenderer::beginFrame(const float vp[16], uint32_t vpVersion, const InstanceStore& instances) {
+    passProfiler.beginFrame();
+    ProfileScope scope(passProfiler, PROFILE_BEGIN_FRAME);
+    transformCache.update(vp, vpVersion, instances);
+}
+
+// ---------------------------------------------------------------------------
+// 几何阶段：逐实例变换顶点，裁剪到近/远平面后投影到视口，按块登记三角形（保持提交顺序）
+
+void SoftRenderer::setupTriangles(Pass pass, const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    triangles.clear();
+    tilesX = (targetWidth + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (targetHeight + TILE_SIZE - 1) / TILE_SIZE;
+    tileBins.resize((size_t)tilesX * tilesY);
+    for (std::vector<uint32_t>& bin : tileBins) bin.clear();
+
+    Frustum frustum;
+    frustum.extract(vp);
+    const bool cached = transformCache.isValidFor(vp, instances);
+    const float* models = instances.modelMatrices();
+    const unsigned int* layers = instances.layers();
+    const bool shade = pass == PASS_SCENE;
+
+    for (uint32_t idx = 0; idx < (uint32_t)instances.size(); ++idx) {
+        if (!(layers[idx] & layerMask)) continue;
+        float boundsMin[3], boundsMax[3];
+        instanceWorldBounds(instances, idx, boundsMin, boundsMax);
+        if (!frustum.intersectsAABB(boundsMin, boundsMax)) continue;
+
+        const float* mvp;
+        if (cached) {
+            mvp = transformCache.mvps() + idx * 16;
+        } else {
+            mvpScratch.resize(16);
+            multiplyMatricesSIMD(vp, models + idx * 16, mvpScratch.data());
+            mvp = mvpScratch.data();
+        }
+
+        // 法线矩阵 = transpose(inverse(model))，与实例化着色器一致
+        float inv[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        if (shade) invertAffineMatrix(models + idx * 16, inv);
+
+        Mesh* mesh = instances.mesh(instances.meshIds()[idx]);
+        const std::vector<float>& verts = mesh->getVertices();
+        const std::vector<unsigned short>& idxs = mesh->getIndices();
+        const size_t vertexCount = verts.size() / 6;
+        clipScratch.resize(vertexCount * 4);
+        if (shade) normalScratch.resize(vertexCount * 3);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            const float* p = &verts[v * 6];
+            float* c = &clipScratch[v * 4];
+            for (int r = 0; r < 4; ++r) c[r] = mvp[r] * p[0] + mvp[4 + r] * p[1] + mvp[8 + r] * p[2] + mvp[12 + r];
+            if (shade) {
+                const float* n = p + 3;
+                float* out = &normalScratch[v * 3];
+                for (int r = 0; r < 3; ++r) out[r] = inv[r * 4] * n[0] + inv[r * 4 + 1] * n[1] + inv[r * 4 + 2] * n[2];
+            }
+        }
+
+        for (size_t t = 0; t + 2 < idxs.size(); t += 3) {
+            float clip[3][4];
+            float normals[3][3] = {{0.0f}};
+            for (int k = 0; k < 3; ++k) {
+                memcpy(clip[k], &clipScratch[idxs[t + k] * 4], sizeof(clip[k]));
+                if (shade) memcpy(normals[k], &normalScratch[idxs[t + k] * 3], sizeof(normals[k]));
+            }
+            emitTriangle(clip, normals, idx);
+        }
+    }
+    triangleCount += (uint32_t)triangles.size();
+}
+
+void SoftRenderer::emitTriangle(const float clip[3][4], const float normals[3][3], uint32_t instance) {
+    // 整个三角形在某个 x/y 裁剪平面外侧时剔除；x/y 其余部分由包围盒截断到视口处理
+    for (int axis = 0; axis < 2; ++axis) {
+        if (clip[0][axis] > clip[0][3] && clip[1][axis] > clip[1][3] && clip[2][axis] > clip[2][3]) return;
+        if (clip[0][axis] < -clip[0][3] && clip[1][axis] < -clip[1][3] && clip[2][axis] < -clip[2][3]) return;
+    }
+
+    // 依次对近平面 (z + w >= 0) 与远平面 (w - z >= 0) 做 Sutherland-Hodgman 裁剪，最多得到 5 边形
+    struct ClipVertex { float c[4]; float n[3]; };
+    ClipVertex polygon[2][8];
+    int count = 3;
+    for (int k = 0; k < 3; ++k) {
+        memcpy(polygon[0][k].c, clip[k], sizeof(polygon[0][k].c));
+        memcpy(polygon[0][k].n, normals[k], sizeof(polygon[0][k].n));
+    }
+    int src = 0;
+    for (int plane = 0; plane < 2; ++plane) {
+        const ClipVertex* in = polygon[src];
+        ClipVertex* out = polygon[1 - src];
+        int outCount = 0;
+        for (int i = 0; i < count; ++i) {
+            const ClipVertex& a = in[i];
+            const ClipVertex& b = in[(i + 1) % count];
+            float da = plane == 0 ? a.c[2] + a.c[3] : a.c[3] - a.c[2];
+            float db = plane == 0 ? b.c[2] + b.c[3] : b.c[3] - b.c[2];
+            if (da >= 0.0f) out[outCount++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                float t = da / (da - db);
+                ClipVertex& v = out[outCount++];
+                for (int r = 0; r < 4; ++r) v.c[r] = a.c[r] + (b.c[r] - a.c[r]) * t;
+                for (int r = 0; r < 3; ++r) v.n[r] = a.n[r] + (b.n[r] - a.n[r]) * t;
+            }
+        }
+        count = outCount;
+        src = 1 - src;
+        if (count < 3) return;
+    }
+
+    // 扇形三角化，投影到视口像素坐标
+    const ClipVertex* poly = polygon[src];
+    for (int i = 1; i + 1 < count; ++i) {
+        const ClipVertex* v[3] = {&poly[0], &poly[i], &poly[i + 1]};
+        Triangle tri;
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+        for (int k = 0; k < 3; ++k) {
+            float invW = 1.0f / v[k]->c[3];
+            tri.x[k] = (v[k]->c[0] * invW * 0.5f + 0.5f) * targetWidth;
+            tri.y[k] = (v[k]->c[1] * invW * 0.5f + 0.5f) * targetHeight;
+            tri.z[k] = v[k]->c[2] * invW * 0.5f + 0.5f;
+            tri.invW[k] = invW;
+            memcpy(tri.normal[k], v[k]->n, sizeof(tri.normal[k]));
+            minX = std::min(minX, tri.x[k]);
+            maxX = std::max(maxX, tri.x[k]);
+            minY = std::min(minY, tri.y[k]);
+            maxY = std::max(maxY, tri.y[k]);
+        }
+        float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+        if (area == 0.0f || !(area == area)) continue;
+
+        // 覆盖像素中心落在 [minX, maxX] 内的像素
+        tri.minX = std::max(0, (int)ceilf(minX - 0.5f));
+        tri.minY = std::max(0, (int)ceilf(minY - 0.5f));
+        tri.maxX = std::min(targetWidth - 1, (int)floorf(maxX - 0.5f));
+        tri.maxY = std::min(targetHeight - 1, (int)floorf(maxY - 0.5f));
+        if (tri.minX > tri.maxX || tri.minY > tri.maxY) continue;
+        tri.instance = instance;
+
+        const uint32_t id = (uint32_t)triangles.size();
+        triangles.push_back(tri);
+        for (int ty = tri.minY / TILE_SIZE; ty <= tri.maxY / TILE_SIZE; ++ty) {
+            for (int tx = tri.minX / TILE_SIZE; tx <= tri.maxX / TILE_SIZE; ++tx) {
+                tileBins[(size_t)ty * tilesX + tx].push_back(id);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 光栅化阶段：每个块由一个线程按提交顺序处理登记的三角形，块之间不共享像素
+
+void SoftRenderer::rasterizeTile(Pass pass, int tile, const InstanceStore& instances) {
+    const int tileX0 = (tile % tilesX) * TILE_SIZE;
+    const int tileY0 = (tile / tilesX) * TILE_SIZE;
+    const int tileX1 = std::min(tileX0 + TILE_SIZE, targetWidth) - 1;
+    const int tileY1 = std::min(tileY0 + TILE_SIZE, targetHeight) - 1;
+    const float* colors = instances.colors();
+    const float* emissives = instances.emissives();
+    const float lightDir = 0.57735027f; // normalize(-u_lightDir)，u_lightDir = (-1, -1, -1)
+
+    for (uint32_t id : tileBins[tile]) {
+        const Triangle& tri = triangles[id];
+        const int x0 = std::max(tileX0, tri.minX), x1 = std::min(tileX1, tri.maxX);
+        const int y0 = std::max(tileY0, tri.minY), y1 = std::min(tileY1, tri.maxY);
+        if (x0 > x1 || y0 > y1) continue;
+
+        // 边 k 为顶点 k+1 -> k+2，e_k(顶点 k) = 有向面积；面积为负时整体取反，不做背面剔除（与 GL 设置一致）
+        EdgeSetup s;
+        float area = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            int a = (k + 1) % 3, b = (k + 2) % 3;
+            s.A[k] = tri.y[a] - tri.y[b];
+            s.B[k] = tri.x[b] - tri.x[a];
+            s.C[k] = tri.x[a] * tri.y[b] - tri.x[b] * tri.y[a];
+        }
+        area = s.A[0] * tri.x[0] + s.B[0] * tri.y[0] + s.C[0];
+        if (area < 0.0f) {
+            for (int k = 0; k < 3; ++k) {
+                s.A[k] = -s.A[k];
+                s.B[k] = -s.B[k];
+                s.C[k] = -s.C[k];
+            }
+            area = -area;
+        }
+        s.invArea = 1.0f / area;
+        s.zA = (tri.z[0] * s.A[0] + tri.z[1] * s.A[1] + tri.z[2] * s.A[2]) * s.invArea;
+        s.zB = (tri.z[0] * s.B[0] + tri.z[1] * s.B[1] + tri.z[2] * s.B[2]) * s.invArea;
+        s.zC = (tri.z[0] * s.C[0] + tri.z[1] * s.C[1] + tri.z[2] * s.C[2]) * s.invArea;
+
+        const float* color = colors + tri.instance * 4;
+        const float* emissive = emissives + tri.instance * 4;
+        for (int y = y0; y <= y1; ++y) {
+            const size_t row = (size_t)y * targetWidth;
+            for (int x = x0; x <= x1; x += 4) {
+                float e[3][4], z[4];
+                float* depth = pass == PASS_SCENE ? &sceneDepth[row + x] : nullptr;
+                int mask = coverQuad(s, x + 0.5f, y + 0.5f, depth, e, z);
+                if (x1 - x < 3) mask &= (1 << (x1 - x + 1)) - 1;
+                if (!mask) continue;
+
+                for (int i = 0; i < 4; ++i) {
+                    if (!(mask & (1 << i))) continue;
+                    const size_t p = row + x + i;
+                    if (pass == PASS_BLOCKMAP) {
+                        blockMap[p] = 1;
+                    } else if (pass == PASS_RADIANCE) {
+                        for (int c = 0; c < 4; ++c) radiance[p * 4 + c] = clamp01(emissive[c]);
+                    } else {
+                        sceneDepth[p] = z[i];
+                        // 透视校正的法线插值（归一化后比例因子抵消）
+                        float n[3];
+                        for (int r = 0; r < 3; ++r) {
+                            n[r] = e[0][i] * tri.invW[0] * tri.normal[0][r] + e[1][i] * tri.invW[1] * tri.normal[1][r] +
+                                   e[2][i] * tri.invW[2] * tri.normal[2][r];
+                        }
+                        float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                        float NdotL = len > 0.0f ? (n[0] + n[1] + n[2]) * lightDir / len : 0.0f;
+                        float diff = clamp01(NdotL * 0.5f + 0.5f);
+                        // 全分辨率时采样点正好在纹素中心，直接取值
+                        float sampled[4];
+                        const float* gi = sampled;
+                        if (giDivisor == 1) {
+                            gi = &radiance[p * 4];
+                        } else {
+                            sampleBilinear(radiance.data(), giWidth, giHeight, 4, (x + i + 0.5f) / width,
+                                           (y + 0.5f) / height, sampled);
+                        }
+                        static const float ambient[3] = {0.05f, 0.05f, 0.08f};
+                        float* out = &sceneColor[p * 4];
+                        for (int c = 0; c < 3; ++c) {
+                            out[c] = clamp01(diff * color[c] * 0.6f + emissive[c] + ambient[c] + gi[c]);
+                        }
+                        out[3] = clamp01(color[3]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SoftRenderer::rasterize(Pass pass, const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    targetWidth = pass == PASS_RADIANCE ? giWidth : width;
+    targetHeight = pass == PASS_RADIANCE ? giHeight : height;
+    setupTriangles(pass, vp, instances, layerMask);
+    if (triangles.empty()) return;
+    pool->run(tilesX * tilesY, [&](int tile) { rasterizeTile(pass, tile, instances); });
+}
+
+// ---------------------------------------------------------------------------
+// 各渲染通道
+
+void SoftRenderer::renderEmissiveToRadianceFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_RADIANCE);
+    std::fill(radiance.begin(), radiance.end(), 0.0f);
+    rasterize(PASS_RADIANCE, vp, instances, layerMask);
+}
+
+void SoftRenderer::renderBlockMap(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_BLOCKMAP);
+    bool occludersStatic = true;
+    const unsigned int* layers = instances.layers();
+    for (uint32_t idx = 0; idx < (uint32_t)instances.size(); ++idx) {
+        if ((layers[idx] & layerMask) && !(layers[idx] & LAYER_STATIC)) {
+            occludersStatic = false;
+            break;
+        }
+    }
+    if (blockMapValid && occludersStatic && blockMapStore == &instances &&
+        blockMapStaticVersion == instances.staticVersion() && blockMapMask == layerMask &&
+        memcmp(blockMapVP, vp, sizeof(blockMapVP)) == 0) {
+        return;
+    }
+
+    std::fill(blockMap.begin(), blockMap.end(), (uint8_t)0);
+    rasterize(PASS_BLOCKMAP, vp, instances, layerMask);
+    buildDistanceField();
+
+    blockMapValid = occludersStatic;
+    memcpy(blockMapVP, vp, sizeof(blockMapVP));
+    blockMapStore = &instances;
+    blockMapStaticVersion = instances.staticVersion();
+    blockMapMask = layerMask;
+}
+
+// JFA：种子与步长序列同 GL 版本（最大步长起逐次减半，步长 1 额外多做一遍），每步按行并行
+void SoftRenderer::buildDistanceField() {
+    const int rowJobs = (giHeight + ROWS_PER_JOB - 1) / ROWS_PER_JOB;
+    pool->run(rowJobs, [&](int job) {
+        for (int y = job * ROWS_PER_JOB; y < std::min(giHeight, (job + 1) * ROWS_PER_JOB); ++y) {
+            for (int x = 0; x < giWidth; ++x) {
+                // 降分辨率时纹素中心可能正好在墙边，双线性结果为 0.5；GPU 的 8 位定点插值会略大于 0.5，按 >= 处理保持一致
+                float block = sampleBlockMap(blockMap.data(), width, height, (x + 0.5f) / giWidth, (y + 0.5f) / giHeight);
+                distanceField[(size_t)y * giWidth + x] = block >= 0.5f ? (uint32_t)x | ((uint32_t)y << 16) : NO_SEED;
+                giBlockMap[(size_t)y * giWidth + x] = block >= 0.5f ? 1 : 0;
+            }
+        }
+    });
+
+    int step = 1;
+    while (step * 2 < std::max(giWidth, giHeight)) step *= 2;
+    bool extraPass = true;
+    while (step >= 1) {
+        const uint32_t* src = distanceField.data();
+        uint32_t* dst = jfaScratch.data();
+        pool->run(rowJobs, [&](int job) {
+            for (int y = job * ROWS_PER_JOB; y < std::min(giHeight, (job + 1) * ROWS_PER_JOB); ++y) {
+                for (int x = 0; x < giWidth; ++x) {
+                    uint32_t best = NO_SEED;
+                    float bestDist = 1e20f;
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        int qy = y + dy * step;
+                        if (qy < 0 || qy >= giHeight) continue;
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            int qx = x + dx * step;
+                            if (qx < 0 || qx >= giWidth) continue;
+                            uint32_t seed = src[(size_t)qy * giWidth + qx];
+                            if (seed == NO_SEED) continue;
+                            float vx = (float)(seed & 0xFFFFu) - x, vy = (float)(seed >> 16) - y;
+                            float d = vx * vx + vy * vy;
+                            if (d < bestDist) {
+                                bestDist = d;
+                                best = seed;
+                            }
+                        }
+                    }
+                    dst[(size_t)y * giWidth + x] = best;
+                }
+            }
+        });
+        distanceField.swap(jfaScratch);
+        if (step == 1 && extraPass) {
+            extraPass = false;
+        } else {
+            step /= 2;
+        }
+    }
+}
+
+// SDF GI：逐像素同 sdfGIFragmentShaderSrc（非时域路径），降分辨率时再做双边上采样
+void SoftRenderer::renderSDFLightsFBO(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_GI);
+    sdfLights.build(vp, instances, layerMask, giWidth, giHeight);
+    const std::vector<ScreenLight>& lights = sdfLights.lights();
+    const std::vector<uint32_t>& tileRanges = sdfLights.tileRanges();
+    const std::vector<uint16_t>& tileIndices = sdfLights.tileIndices();
+    const int lightTilesX = sdfLights.tilesX();
+
+    float screenToLightmap[9];
+    screenToLightmapUV(vp, lightmapScale, lightmapOffset, screenToLightmap);
+    const bool useLightmap = !lightmap.empty();
+
+    const float texelX = 1.0f / (float)giWidth, texelY = 1.0f / (float)giHeight;
+    auto wallDistance = [&](float u, float v) -> float {
+        int px = (int)(u / texelX), py = (int)(v / texelY);
+        if (px < 0 || py < 0 || px >= giWidth || py >= giHeight) return 1e6f;
+        uint32_t seed = distanceField[(size_t)py * giWidth + px];
+        if (seed == NO_SEED) return 1e6f;
+        float dx = (float)(seed & 0xFFFFu) - px, dy = (float)(seed >> 16) - py;
+        return sqrtf(dx * dx + dy * dy);
+    };
+
+    const int rowJobs = (giHeight + ROWS_PER_JOB - 1) / ROWS_PER_JOB;
+    pool->run(rowJobs, [&](int job) {
+        for (int y = job * ROWS_PER_JOB; y < std::min(giHeight, (job + 1) * ROWS_PER_JOB); ++y) {
+            for (int x = 0; x < giWidth; ++x) {
+                float* out = &giColor[((size_t)y * giWidth + x) * 4];
+                const float u = (x + 0.5f) * texelX, v = (y + 0.5f) * texelY;
+                if (wallDistance(u, v) < 0.5f) {
+                    out[0] = out[1] = out[2] = out[3] = 0.0f;
+                    continue;
+                }
+
+                float lighting[3] = {0.0f, 0.0f, 0.0f};
+                if (useLightmap) {
+                    const float* m = screenToLightmap;
+                    float mx = m[0] * u + m[3] * v + m[6];
+                    float my = m[1] * u + m[4] * v + m[7];
+                    float mz = m[2] * u + m[5] * v + m[8];
+                    if (mz > 0.0f) {
+                        float mu = mx / mz, mv = my / mz;
+                        if (mu >= 0.0f && mv >= 0.0f && mu <= 1.0f && mv <= 1.0f) {
+                            sampleBilinear(lightmap.data(), lightmapW, lightmapH, 3, mu, mv, lighting);
+                        }
+                    }
+                }
+
+                const size_t tile = (size_t)(y / TiledLightList::TILE_SIZE) * lightTilesX + x / TiledLightList::TILE_SIZE;
+                const uint32_t offset = tileRanges[tile * 2];
+                const uint32_t count = std::min(tileRanges[tile * 2 + 1], (uint32_t)TiledLightList::MAX_LIGHTS_PER_TILE);
+                for (uint32_t k = 0; k < count; ++k) {
+                    const ScreenLight& light = lights[tileIndices[offset + k]];
+                    float lx = light.uv[0] - u, ly = light.uv[1] - v;
+                    float screenDistance = sqrtf(lx * lx + ly * ly);
+                    if (screenDistance >= light.range) continue;
+
+                    // 球面追踪，同 traceVisibility
+                    float tx = lx / texelX, ty = ly / texelY;
+                    float pixelDistance = sqrtf(tx * tx + ty * ty);
+                    float invLen = 1.0f / std::max(pixelDistance, 1e-4f);
+                    float dirX = tx * invLen, dirY = ty * invLen;
+                    float visibility = 1.0f;
+                    float t = 1.0f;
+                    for (int i = 0; i < 24; ++i) {
+                        if (t >= pixelDistance - 1.0f) break;
+                        float d = wallDistance(u + dirX * t * texelX, v + dirY * t * texelY);
+                        if (d < 1.0f) {
+                            visibility = 0.0f;
+                            break;
+                        }
+                        t += d;
+                    }
+                    if (visibility == 0.0f) continue;
+
+                    float s = clamp01(1.0f - screenDistance / light.range);
+                    float attenuation = s * s * (3.0f - 2.0f * s);
+                    for (int c = 0; c < 3; ++c) lighting[c] += attenuation * attenuation * light.color[c];
+                }
+
+                if (lighting[0] > 0.0f || lighting[1] > 0.0f || lighting[2] > 0.0f) {
+                    lighting[0] += 0.005f;
+                    lighting[1] += 0.005f;
+                    lighting[2] += 0.01f;
+                }
+                for (int c = 0; c < 3; ++c) out[c] = clamp01(lighting[c]);
+                out[3] = 1.0f;
+            }
+        }
+    });
+
+    if (giDivisor <= 1) return;
+
+    // 双边上采样，同 giUpsampleFragmentShaderSrc；样本的遮挡状态在构建距离场时已按 GI 纹素算好。
+    // 样本位置与双线性权重只取决于列/行，先按列算好
+    struct Tap { int i0, i1; float f; };
+    auto tapFor = [](int p, int full, int low) {
+        float pos = (p + 0.5f) / full * low - 0.5f;
+        float base = floorf(pos);
+        Tap t;
+        t.i0 = std::min(std::max((int)base, 0), low - 1);
+        t.i1 = std::min(std::max((int)base + 1, 0), low - 1);
+        t.f = pos - base;
+        return t;
+    };
+    std::vector<Tap> columns(width);
+    for (int x = 0; x < width; ++x) columns[x] = tapFor(x, width, giWidth);
+
+    const int fullRowJobs = (height + ROWS_PER_JOB - 1) / ROWS_PER_JOB;
+    pool->run(fullRowJobs, [&](int job) {
+        for (int y = job * ROWS_PER_JOB; y < std::min(height, (job + 1) * ROWS_PER_JOB); ++y) {
+            const Tap row = tapFor(y, height, giHeight);
+            const int rows[2] = {row.i0, row.i1};
+            const float rowWeights[2] = {1.0f - row.f, row.f};
+            for (int x = 0; x < width; ++x) {
+                const Tap& col = columns[x];
+                const int cols[2] = {col.i0, col.i1};
+                const float colWeights[2] = {1.0f - col.f, col.f};
+                const int centerBlock = blockMap[(size_t)y * width + x];
+                float accum[3] = {0.0f, 0.0f, 0.0f};
+                float weightSum = 0.0f;
+                for (int j = 0; j < 2; ++j) {
+                    for (int i = 0; i < 2; ++i) {
+                        const size_t tap = (size_t)rows[j] * giWidth + cols[i];
+                        float w = colWeights[i] * rowWeights[j];
+                        if (giBlockMap[tap] != centerBlock) w *= 0.001f;
+                        const float* c = &giColor[tap * 4];
+                        accum[0] += w * c[0];
+                        accum[1] += w * c[1];
+                        accum[2] += w * c[2];
+                        weightSum += w;
+                    }
+                }
+                float* out = &giFull[((size_t)y * width + x) * 4];
+                float inv = 1.0f / std::max(weightSum, 1e-4f);
+                for (int c = 0; c < 3; ++c) out[c] = clamp01(accum[c] * inv);
+                out[3] = 1.0f;
+            }
+        }
+    });
+}
+
+void SoftRenderer::renderStaticInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_STATIC);
+    triangleCount = 0;
+    std::fill(sceneColor.begin(), sceneColor.end(), 0.0f);
+    std::fill(sceneDepth.begin(), sceneDepth.end(), 1.0f);
+    rasterize(PASS_SCENE, vp, instances, layerMask);
+}
+
+void SoftRenderer::renderDynamicInstances(const float vp[16], const InstanceStore& instances, unsigned int layerMask) {
+    ProfileScope scope(passProfiler, PROFILE_DYNAMIC);
+    // 不清空，在静态对象之上叠加动态对象
+    rasterize(PASS_SCENE, vp, instances, layerMask);
+}
+
+void SoftRenderer::renderPPGI() {
+    ProfileScope scope(passProfiler, PROFILE_PPGI);
+    const std::vector<float>& gi = giDivisor > 1 ? giFull : giColor;
+    const int rowJobs = (height + ROWS_PER_JOB - 1) / ROWS_PER_JOB;
+    pool->run(rowJobs, [&](int job) {
+        size_t begin = (size_t)job * ROWS_PER_JOB * width * 4;
+        size_t end = std::min((size_t)(job + 1) * ROWS_PER_JOB * width, (size_t)width * height) * 4;
+        for (size_t i = begin; i < end; i += 4) {
+            for (int c = 0; c < 3; ++c) ppColor[i + c] = clamp01(sceneColor[i + c] + gi[i + c]);
+            ppColor[i + 3] = sceneColor[i + 3];
+        }
+    });
+}
+
+void SoftRenderer::OneFrameRenderFinish(bool usePostProcessing) {
+    ProfileScope scope(passProfiler, PROFILE_FINISH);
+    finalColor = usePostProcessing ? &ppColor : &sceneColor;
+}
+
+void SoftRenderer::readPixels(std::vector<uint8_t>& rgba, int& w, int& h) {
+    w = width;
+    h = height;
+    rgba.resize((size_t)width * height * 4);
+    const std::vector<float>& src = finalColor ? *finalColor : sceneColor;
+    for (size_t i = 0; i < rgba.size() && i < src.size(); ++i) {
+        rgba[i] = (uint8_t)(clamp01(src[i]) * 255.0f + 0.5f);
+    }
+}
+
+} // namespace Core
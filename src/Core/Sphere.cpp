@@ -1,12 +1,14 @@
 #include "Core/Sphere.h"
-#include <vector>
+#include <algorithm>
 #include <cmath>
+#include <map>
+#include <tuple>
 
 namespace Core {
 
-SphereMesh::SphereMesh(int sectorCount, int stackCount) {
-    std::vector<float> verts;
-    std::vector<unsigned short> idxs;
+void generateUVSphere(int sectorCount, int stackCount, std::vector<float>& verts, std::vector<unsigned short>& idxs) {
+    verts.clear();
+    idxs.clear();
     const float PI = 3.1415926f;
 
     for (int i = 0; i <= stackCount; ++i) {
@@ -41,53 +43,112 @@ SphereMesh::SphereMesh(int sectorCount, int stackCount) {
             }
         }
     }
-    indexCount = idxs.size();
-
-#ifdef USE_DESKTOP_GL
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-#endif
+}
 
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(float), verts.data(), GL_STATIC_DRAW);
+void generateIcosphere(int frequency, std::vector<float>& verts, std::vector<unsigned short>& idxs) {
+    verts.clear();
+    idxs.clear();
+    const int f = std::min(std::max(frequency, 1), 80);
+    const float t = (1.0f + sqrtf(5.0f)) * 0.5f;
+    const float corners[12][3] = {
+        {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+        {0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+        {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1},
+    };
+    // 逆时针为正面（朝外），与 UV 球一致
+    const int faces[20][3] = {
+        {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+        {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+        {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+        {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1},
+    };
 
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, idxs.size() * sizeof(unsigned short), idxs.data(), GL_STATIC_DRAW);
+    // 共享边上的点在相邻两个面中由同样的两个角点、同样的整数权重算出，量化后去重
+    std::map<std::tuple<long, long, long>, unsigned short> unique;
+    std::vector<unsigned short> grid((f + 1) * (f + 2) / 2);
+    for (const int* face : faces) {
+        const float* a = corners[face[0]];
+        const float* b = corners[face[1]];
+        const float* c = corners[face[2]];
+        // 面内三角网格点 (i, j)：i 沿 a->b，j 沿 a->c，i + j <= f
+        for (int i = 0, n = 0; i <= f; ++i) {
+            for (int j = 0; j <= f - i; ++j, ++n) {
+                const int k = f - i - j;
+                float p[3];
+                float len = 0.0f;
+                for (int d = 0; d < 3; ++d) {
+                    p[d] = a[d] * k + b[d] * i + c[d] * j;
+                    len += p[d] * p[d];
+                }
+                len = sqrtf(len);
+                for (int d = 0; d < 3; ++d) p[d] /= len;
+                const std::tuple<long, long, long> key(lrintf(p[0] * 1e6f), lrintf(p[1] * 1e6f), lrintf(p[2] * 1e6f));
+                auto inserted = unique.insert(std::make_pair(key, (unsigned short)(verts.size() / 6)));
+                if (inserted.second) {
+                    for (int d = 0; d < 3; ++d) verts.push_back(p[d] * 0.5f); // 位置
+                    for (int d = 0; d < 3; ++d) verts.push_back(p[d]);        // 法线
+                }
+                grid[n] = inserted.first->second;
+            }
+        }
+        // 行 i 的起点下标
+        auto at = [f](int i, int j) { return i * (f + 1) - i * (i - 1) / 2 + j; };
+        for (int i = 0; i < f; ++i) {
+            for (int j = 0; j < f - i; ++j) {
+                const unsigned short v0 = grid[at(i, j)], v1 = grid[at(i + 1, j)], v2 = grid[at(i, j + 1)];
+                idxs.push_back(v0);
+                idxs.push_back(v1);
+                idxs.push_back(v2);
+                if (j + 1 < f - i) {
+                    idxs.push_back(v1);
+                    idxs.push_back(grid[at(i + 1, j + 1)]);
+                    idxs.push_back(v2);
+                }
+            }
+        }
+    }
+}
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+float sphereSilhouetteError(const std::vector<float>& verts, const std::vector<unsigned short>& idxs, float radius) {
+    float nearest = radius;
+    for (size_t t = 0; t + 2 < idxs.size(); t += 3) {
+        const float* a = &verts[idxs[t] * 6];
+        const float* b = &verts[idxs[t + 1] * 6];
+        const float* c = &verts[idxs[t + 2] * 6];
+        float e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        float e1[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+        const float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len <= 1e-12f) continue; // 极点处的退化三角形
+        nearest = std::min(nearest, fabsf(n[0] * a[0] + n[1] * a[1] + n[2] * a[2]) / len);
+    }
+    return radius - nearest;
+}
 
-#ifdef USE_DESKTOP_GL
-    glBindVertexArray(0);
-#endif
+int icosphereFrequencyFor(float maxError) {
+    std::vector<float> verts;
+    std::vector<unsigned short> idxs;
+    for (int f = 1; f < 80; ++f) {
+        generateIcosphere(f, verts, idxs);
+        if (sphereSilhouetteError(verts, idxs, 0.5f) <= maxError) return f;
+    }
+    return 80;
 }
 
-SphereMesh::~SphereMesh() {
-#ifdef USE_DESKTOP_GL
-    if (vao) glDeleteVertexArrays(1, &vao);
-#endif
-    if (vbo) glDeleteBuffers(1, &vbo);
-    if (ebo) glDeleteBuffers(1, &ebo);
+SphereMesh::SphereMesh(int sectorCount, int stackCount) {
+    std::vector<float> verts;
+    std::vector<unsigned short> idxs;
+    generateUVSphere(sectorCount, stackCount, verts, idxs);
+    order = optimizeMeshOrder(verts, idxs);
+    setupData(verts.data(), verts.size(), idxs.data(), idxs.size());
 }
 
-void SphereMesh::draw() {
-#ifdef USE_DESKTOP_GL
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, 0);
-    glBindVertexArray(0);
-#else
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, 0);
-#endif
+IcosphereMesh::IcosphereMesh(int frequency) {
+    std::vector<float> verts;
+    std::vector<unsigned short> idxs;
+    generateIcosphere(frequency, verts, idxs);
+    order = optimizeMeshOrder(verts, idxs);
+    setupData(verts.data(), verts.size(), idxs.data(), idxs.size());
 }
 
-} // namespace Core
\ No newline at end of file
+} // namespace Core
@@ -0,0 +1,271 @@
+#include "Core/StaticBatch.h"
+#include "Core/GLState.h"
+#include "Math/MathSIMD.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace Core {
+
+namespace {
+
+// 世界空间三角形，用于检测重合面
+struct WorldTriangle {
+    int32_t key[9];      // 量化后按字典序排序的三个顶点坐标
+    float normal[3];     // 世界空间法线
+    uint32_t id;
+};
+
+const float kQuantize = 1.0f / 1024.0f;
+
+bool keyLess(const WorldTriangle& a, const WorldTriangle& b) {
+    return std::lexicographical_compare(a.key, a.key + 9, b.key, b.key + 9);
+}
+
+bool keyEqual(const WorldTriangle& a, const WorldTriangle& b) {
+    return std::equal(a.key, a.key + 9, b.key);
+}
+
+void transformPoint(const float m[16], const float* p, float* out) {
+    for (int r = 0; r < 3; ++r) {
+        out[r] = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+    }
+}
+
+// 法线矩阵 = 模型矩阵逆的转置（只取 3x3），不可逆时退化为单位矩阵
+void normalMatrix(const float model[16], float inv[16]) {
+    if (!invertAffineMatrix(model, inv)) {
+        for (int i = 0; i < 16; ++i) inv[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+void transformNormal(const float inv[16], const float* n, float* out) {
+    for (int r = 0; r < 3; ++r) {
+        out[r] = inv[r * 4 + 0] * n[0] + inv[r * 4 + 1] * n[1] + inv[r * 4 + 2] * n[2];
+    }
+    float len = sqrtf(out[0] * out[0] + out[1] * out[1] + out[2] * out[2]);
+    if (len > 0.0f) { out[0] /= len; out[1] /= len; out[2] /= len; }
+}
+
+// 法线取顶点属性法线（现有网格的绕序并不统一朝外，不能用叉积）
+void makeTriangle(const float* const pts[3], const float normal[3], uint32_t id, WorldTriangle& tri) {
+    std::array<int32_t, 3> q[3];
+    for (int v = 0; v < 3; ++v) {
+        for (int k = 0; k < 3; ++k) q[v][k] = (int32_t)lroundf(pts[v][k] / kQuantize);
+    }
+    // 顶点按字典序排序，使相同位置、不同绕序的三角形得到相同的键
+    std::sort(q, q + 3);
+    for (int v = 0; v < 3; ++v) {
+        for (int k = 0; k < 3; ++k) tri.key[v * 3 + k] = q[v][k];
+    }
+    memcpy(tri.normal, normal, 3 * sizeof(float));
+    tri.id = id;
+}
+
+} // namespace
+
+uint32_t StaticBatch::bake(const InstanceStore& instances, unsigned int layerMask, std::vector<Chunk>& chunks) {
+    chunks.clear();
+
+    std::vector<uint32_t> batchInstances;
+    const unsigned int* layers = instances.layers();
+    for (uint32_t i = 0; i < (uint32_t)instances.size(); ++i) {
+        if (layers[i] & layerMask) batchInstances.push_back(i);
+    }
+
+    // 1) 所有三角形变换到世界空间，三角形编号 = 实例内三角形偏移 + 序号
+    std::vector<uint32_t> firstTriangle(batchInstances.size() + 1, 0);
+    std::vector<WorldTriangle> worldTris;
+    std::vector<float> worldPos;
+    float inv[16];
+    for (std::size_t b = 0; b < batchInstances.size(); ++b) {
+        uint32_t idx = batchInstances[b];
+        const Mesh* mesh = instances.mesh(instances.meshIds()[idx]);
+        const float* model = instances.modelMatrices() + idx * 16;
+        const std::vector<float>& verts = mesh->getVertices();
+        const std::vector<unsigned short>& idxs = mesh->getIndices();
+
+        normalMatrix(model, inv);
+        worldPos.resize(verts.size());
+        for (std::size_t v = 0; v < verts.size() / 6; ++v) {
+            transformPoint(model, &verts[v * 6], &worldPos[v * 6]);
+            transformNormal(inv, &verts[v * 6 + 3], &worldPos[v * 6 + 3]);
+        }
+        firstTriangle[b] = (uint32_t)worldTris.size();
+        for (std::size_t t = 0; t + 2 < idxs.size(); t += 3) {
+            const float* pts[3] = {&worldPos[idxs[t] * 6], &worldPos[idxs[t + 1] * 6], &worldPos[idxs[t + 2] * 6]};
+            float n[3];
+            for (int k = 0; k < 3; ++k) n[k] = pts[0][3 + k] + pts[1][3 + k] + pts[2][3 + k];
+            float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if (len > 0.0f) { n[0] /= len; n[1] /= len; n[2] /= len; }
+            WorldTriangle tri;
+            makeTriangle(pts, n, (uint32_t)worldTris.size(), tri);
+            worldTris.push_back(tri);
+        }
+    }
+    firstTriangle[batchInstances.size()] = (uint32_t)worldTris.size();
+
+    // 2) 位置完全重合且法线相反的三角形成对剔除（相邻墙体之间的内部面）
+    std::vector<char> removed(worldTris.size(), 0);
+    std::vector<WorldTriangle> sorted(worldTris);
+    std::sort(sorted.begin(), sorted.end(), keyLess);
+    uint32_t removedCount = 0;
+    for (std::size_t begin = 0; begin < sorted.size();) {
+        std::size_t end = begin + 1;
+        while (end < sorted.size() && keyEqual(sorted[begin], sorted[end])) ++end;
+        for (std::size_t i = begin; i < end; ++i) {
+            for (std::size_t j = i + 1; j < end; ++j) {
+                if (removed[sorted[i].id] || removed[sorted[j].id]) continue;
+                const float* ni = sorted[i].normal;
+                const float* nj = sorted[j].normal;
+                if (ni[0] * nj[0] + ni[1] * nj[1] + ni[2] * nj[2] < -0.99f) {
+                    removed[sorted[i].id] = removed[sorted[j].id] = 1;
+                    removedCount += 2;
+                }
+            }
+        }
+        begin = end;
+    }
+
+    // 3) 逐实例输出保留的三角形，只拷贝被引用的顶点；单块顶点数超过 16 位索引上限时另起一块
+    std::vector<int32_t> remap;
+    for (std::size_t b = 0; b < batchInstances.size(); ++b) {
+        uint32_t idx = batchInstances[b];
+        const Mesh* mesh = instances.mesh(instances.meshIds()[idx]);
+        const float* model = instances.modelMatrices() + idx * 16;
+        const float* color = instances.colors() + idx * 4;
+        const float* emissive = instances.emissives() + idx * 4;
+        const std::vector<float>& verts = mesh->getVertices();
+        const std::vector<unsigned short>& idxs = mesh->getIndices();
+
+        // 统计本实例需要的顶点
+        remap.assign(verts.size() / 6, -1);
+        uint32_t usedVerts = 0;
+        for (std::size_t t = 0; t + 2 < idxs.size(); t += 3) {
+            if (removed[firstTriangle[b] + t / 3]) continue;
+            for (int k = 0; k < 3; ++k) {
+                if (remap[idxs[t + k]] < 0) remap[idxs[t + k]] = (int32_t)usedVerts++;
+            }
+        }
+        if (usedVerts == 0) continue;
+
+        if (chunks.empty() ||
+            chunks.back().vertices.size() / VERTEX_FLOATS + usedVerts > 65535) {
+            chunks.push_back(Chunk());
+        }
+        Chunk& chunk = chunks.back();
+        uint32_t base = (uint32_t)(chunk.vertices.size() / VERTEX_FLOATS);
+
+        normalMatrix(model, inv);
+        chunk.vertices.resize((base + usedVerts) * VERTEX_FLOATS);
+        for (std::size_t v = 0; v < remap.size(); ++v) {
+            if (remap[v] < 0) continue;
+            float* dst = &chunk.vertices[(base + remap[v]) * VERTEX_FLOATS];
+            const float* src = &verts[v * 6];
+            transformPoint(model, src, dst);
+            transformNormal(inv, src + 3, dst + 3);
+            memcpy(dst + 6, color, 4 * sizeof(float));
+            memcpy(dst + 10, emissive, 4 * sizeof(float));
+        }
+        for (std::size_t t = 0; t + 2 < idxs.size(); t += 3) {
+            if (removed[firstTriangle[b] + t / 3]) continue;
+            for (int k = 0; k < 3; ++k) {
+                chunk.indices.push_back((unsigned short)(base + remap[idxs[t + k]]));
+            }
+        }
+    }
+    return removedCount;
+}
+
+StaticBatch::~StaticBatch() {
+    release();
+}
+
+void StaticBatch::release() {
+    for (auto& c : gpuChunks) {
+#ifdef USE_DESKTOP_GL
+        if (c.vao) glDeleteVertexArrays(1, &c.vao);
+#endif
+        if (c.vbo) glDeleteBuffers(1, &c.vbo);
+        if (c.ebo) glDeleteBuffers(1, &c.ebo);
+    }
+    gpuChunks.clear();
+    triangles = 0;
+    removedTriangles = 0;
+    glState().invalidate();
+}
+
+void StaticBatch::bindChunk(const GpuChunk& chunk) {
+    GLStateCache& gl = glState();
+#ifdef USE_DESKTOP_GL
+    gl.bindVertexArray(chunk.vao);
+#else
+    const GLsizei stride = VERTEX_FLOATS * sizeof(float);
+    gl.bindArrayBuffer(chunk.vbo);
+    gl.bindElementBuffer(chunk.ebo);
+    gl.vertexAttribPointer(0, 3, stride, 0);                      // 位置
+    gl.enableVertexAttrib(0);
+    gl.vertexAttribPointer(1, 3, stride, 3 * sizeof(float));      // 法线
+    gl.enableVertexAttrib(1);
+    gl.vertexAttribPointer(2, 4, stride, 6 * sizeof(float));      // 颜色
+    gl.enableVertexAttrib(2);
+    gl.vertexAttribPointer(3, 4, stride, 10 * sizeof(float));     // 自发光
+    gl.enableVertexAttrib(3);
+    // 2、3 号属性可能刚被实例化绘制设为每实例数据；其后的实例属性不再需要
+    gl.vertexAttribDivisor(2, 0);
+    gl.vertexAttribDivisor(3, 0);
+    gl.disableVertexAttribsFrom(4);
+#endif
+}
+
+void StaticBatch::build(const InstanceStore& instances, unsigned int layerMask) {
+    release();
+
+    std::vector<Chunk> chunks;
+    removedTriangles = bake(instances, layerMask, chunks);
+
+    const GLsizei stride = VERTEX_FLOATS * sizeof(float);
+    for (const Chunk& chunk : chunks) {
+        GpuChunk gpu;
+        gpu.indexCount = (GLsizei)chunk.indices.size();
+        triangles += (uint32_t)chunk.indices.size() / 3;
+
+#ifdef USE_DESKTOP_GL
+        glGenVertexArrays(1, &gpu.vao);
+        glBindVertexArray(gpu.vao);
+#endif
+        glGenBuffers(1, &gpu.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, gpu.vbo);
+        glBufferData(GL_ARRAY_BUFFER, chunk.vertices.size() * sizeof(float), chunk.vertices.data(), GL_STATIC_DRAW);
+        glGenBuffers(1, &gpu.ebo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, chunk.indices.size() * sizeof(unsigned short), chunk.indices.data(), GL_STATIC_DRAW);
+
+#ifdef USE_DESKTOP_GL
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)(10 * sizeof(float)));
+        glEnableVertexAttribArray(3);
+        glBindVertexArray(0);
+#else
+        (void)stride;
+#endif
+        gpuChunks.push_back(gpu);
+    }
+    glState().invalidate();
+}
+
+void StaticBatch::draw() {
+    for (const GpuChunk& chunk : gpuChunks) {
+        bindChunk(chunk);
+        glDrawElements(GL_TRIANGLES, chunk.indexCount, GL_UNSIGNED_SHORT, 0);
+    }
+    // GLES 下颜色/自发光属性保持开启，之后的网格与全屏四边形绘制会自行关闭
+}
+
+} // namespace Core
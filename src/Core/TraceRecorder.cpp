@@ -0,0 +1,50 @@
+#include "Core/TraceRecorder.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace Core {
+
+TraceRecorder::TraceRecorder(size_t capacity)
+    : origin(Clock::now()), events(std::max<size_t>(capacity, 1)) {
+}
+
+void TraceRecorder::record(const char* name, const char* category, Clock::time_point start, Clock::time_point end, uint32_t frame) {
+    if (!active) return;
+    Event& e = events[head];
+    e.name = name;
+    e.category = category;
+    e.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+    e.durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    e.frame = frame;
+    head = (head + 1) % events.size();
+    if (count < events.size()) {
+        ++count;
+    } else {
+        ++overwritten;
+    }
+}
+
+void TraceRecorder::clear() {
+    head = 0;
+    count = 0;
+    overwritten = 0;
+}
+
+bool TraceRecorder::writeJSON(const std::string& path) const {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Pi Renderer\"}},\n");
+    fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}");
+    // 环形缓冲中最旧的事件位于 head（未写满时为 0）；嵌套事件按结束顺序写入，查看器会自行排序
+    const size_t first = count < events.size() ? 0 : head;
+    for (size_t i = 0; i < count; ++i) {
+        const Event& e = events[(first + i) % events.size()];
+        fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                e.name, e.category, e.startNs * 1e-3, e.durationNs * 1e-3, e.frame);
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
+
+} // namespace Core
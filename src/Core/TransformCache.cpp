@@ -0,0 +1,58 @@
+#include "Core/TransformCache.h"
+#include "Math/MathSIMD.h"
+#include <cstring>
+
+namespace Core {
+
+void TransformCache::update(const float vp[16], uint32_t vpVersion, const InstanceStore& instances) {
+    recomputeCount = 0;
+    const uint32_t* versions = instances.transformVersions();
+
+    bool fullRebuild = cachedStore != &instances ||
+                       cachedVpVersion != vpVersion ||
+                       memcmp(cachedVp, vp, sizeof(cachedVp)) != 0 ||
+                       cachedStaticVersion != instances.staticVersion() ||
+                       mvpData.size() != instances.size() * 16;
+
+    if (fullRebuild) {
+        const uint32_t count = (uint32_t)instances.size();
+        mvpData.resize(count * 16);
+        multiplyMatricesBatch(vp, instances.modelMatrices(), (int)count, mvpData.data());
+        recomputeCount = count;
+
+        dynamicIndices.clear();
+        dynamicVersions.clear();
+        const unsigned int* layers = instances.layers();
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!(layers[i] & LAYER_STATIC)) {
+                dynamicIndices.push_back(i);
+                dynamicVersions.push_back(versions[i]);
+            }
+        }
+    } else if (cachedDynamicVersion != instances.dynamicVersion()) {
+        // 只检查动态实例，静态实例整体跳过
+        const float* models = instances.modelMatrices();
+        for (std::size_t k = 0; k < dynamicIndices.size(); ++k) {
+            uint32_t idx = dynamicIndices[k];
+            if (dynamicVersions[k] == versions[idx]) continue;
+            multiplyMatricesSIMD(vp, models + idx * 16, &mvpData[idx * 16]);
+            dynamicVersions[k] = versions[idx];
+            ++recomputeCount;
+        }
+    }
+
+    cachedStore = &instances;
+    memcpy(cachedVp, vp, sizeof(cachedVp));
+    cachedVpVersion = vpVersion;
+    cachedStaticVersion = instances.staticVersion();
+    cachedDynamicVersion = instances.dynamicVersion();
+}
+
+bool TransformCache::isValidFor(const float vp[16], const InstanceStore& instances) const {
+    return cachedStore == &instances &&
+           cachedStaticVersion == instances.staticVersion() &&
+           cachedDynamicVersion == instances.dynamicVersion() &&
+           memcmp(cachedVp, vp, sizeof(cachedVp)) == 0;
+}
+
+} // namespace Core
@@ -0,0 +1,50 @@
+#include "Core/UniformRing.h"
+#include "Core/GLState.h"
+
+namespace Core {
+
+bool UniformRing::init(GLsizeiptr bytes) {
+    shutdown();
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment <= 0) alignment = 256;
+    glGenBuffers(1, &ubo);
+    if (!ubo) return false;
+    capacity = stride(bytes);
+    cursor = 0;
+    glState().bindUniformBuffer(ubo);
+    glBufferData(GL_UNIFORM_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    return true;
+}
+
+void UniformRing::shutdown() {
+    if (ubo) {
+        glDeleteBuffers(1, &ubo);
+        ubo = 0;
+        glState().invalidate();
+    }
+    capacity = 0;
+    cursor = 0;
+}
+
+GLsizeiptr UniformRing::stride(GLsizeiptr size) const {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+GLintptr UniformRing::upload(const void* data, GLsizeiptr size) {
+    GLsizeiptr bytes = stride(size);
+    glState().bindUniformBuffer(ubo);
+    if (cursor + bytes > capacity) {
+        // 写满：orphan 后从头开始。容量保持在单次上传的两倍以上，
+        // 保证 orphan 后紧接着重传其它记录（如帧常量）不会再次 orphan
+        if (bytes * 2 > capacity) capacity = stride(bytes * 2);
+        glBufferData(GL_UNIFORM_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        cursor = 0;
+        ++orphans;
+    }
+    GLintptr offset = cursor;
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    cursor += bytes;
+    return offset;
+}
+
+} // namespace Core
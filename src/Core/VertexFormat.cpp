@@ -0,0 +1,234 @@
+#include "Core/VertexFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Core {
+
+bool parseVertexLayout(const std::string& name, VertexLayout& out) {
+    if (name == "float") {
+        out.position = POSITION_FLOAT32;
+        out.normal = NORMAL_FLOAT32;
+    } else if (name == "half") {
+        out.position = POSITION_HALF;
+        out.normal = NORMAL_OCT8;
+    } else if (name == "compact") {
+        out.position = POSITION_SNORM16;
+        out.normal = NORMAL_OCT16;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* vertexLayoutName(const VertexLayout& layout) {
+    if (layout.position == POSITION_FLOAT32 && layout.normal == NORMAL_FLOAT32) return "float";
+    if (layout.position == POSITION_HALF && layout.normal == NORMAL_OCT8) return "half";
+    if (layout.position == POSITION_SNORM16 && layout.normal == NORMAL_OCT16) return "compact";
+    return "custom";
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    const uint32_t absBits = bits & 0x7FFFFFFF;
+    if (absBits >= 0x7F800000) {
+        return sign | (absBits > 0x7F800000 ? 0x7E00 : 0x7C00); // NaN / Inf
+    }
+    if (absBits >= 0x477FF000) return sign | 0x7C00;            // 舍入后超出 65504
+    if (absBits < 0x38800000) {
+        // 非规格化数（含 0）：按 2^-24 的步长就近舍入到偶数
+        if (absBits < 0x33000000) return sign;
+        const uint32_t mantissa = (absBits & 0x007FFFFF) | 0x00800000;
+        const int shift = 126 - (int)(absBits >> 23);             // 14 ~ 24
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) ++half;
+        return sign | (uint16_t)half;
+    }
+    uint32_t half = ((absBits >> 13) - (112u << 10));
+    const uint32_t rest = absBits & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) ++half;
+    return sign | (uint16_t)half;
+}
+
+float halfToFloat(uint16_t value) {
+    const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1F;
+    const uint32_t mantissa = value & 0x3FF;
+    float result;
+    if (exponent == 0) {
+        result = ldexpf((float)mantissa, -24);
+    } else if (exponent == 31) {
+        result = mantissa ? NAN : INFINITY;
+    } else {
+        result = ldexpf((float)(mantissa | 0x400), (int)exponent - 25);
+    }
+    uint32_t bits;
+    memcpy(&bits, &result, sizeof(bits));
+    bits |= sign;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// GL 的有符号归一化整数转换：max(c / (2^(b-1) - 1), -1)
+static float snormToFloat(int value, int maxValue) {
+    return std::max((float)value / (float)maxValue, -1.0f);
+}
+
+static int floatToSnorm(float value, int maxValue) {
+    return (int)lrintf(std::min(std::max(value, -1.0f), 1.0f) * (float)maxValue);
+}
+
+// 与 MESH_NORMAL_GLSL 中的 meshNormal() 一致
+static void octDecode(float ex, float ey, float n[3]) {
+    n[0] = ex;
+    n[1] = ey;
+    n[2] = 1.0f - fabsf(ex) - fabsf(ey);
+    const float t = std::max(-n[2], 0.0f);
+    n[0] += n[0] >= 0.0f ? -t : t;
+    n[1] += n[1] >= 0.0f ? -t : t;
+    const float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (len > 0.0f) {
+        for (int k = 0; k < 3; ++k) n[k] /= len;
+    }
+}
+
+static void octEncode(const float n[3], int maxValue, int out[2]) {
+    const float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+    float p[2] = {0.0f, 0.0f};
+    if (l1 > 0.0f) {
+        p[0] = n[0] / l1;
+        p[1] = n[1] / l1;
+        if (n[2] < 0.0f) {
+            const float x = p[0], y = p[1];
+            p[0] = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            p[1] = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        }
+    }
+    // 截断后的四个相邻量化点中取解码后与原方向夹角最小的
+    const int base[2] = {(int)floorf(p[0] * maxValue), (int)floorf(p[1] * maxValue)};
+    float best = -2.0f;
+    for (int dx = 0; dx <= 1; ++dx) {
+        for (int dy = 0; dy <= 1; ++dy) {
+            int q[2] = {std::min(std::max(base[0] + dx, -maxValue), maxValue),
+                        std::min(std::max(base[1] + dy, -maxValue), maxValue)};
+            float d[3];
+            octDecode(snormToFloat(q[0], maxValue), snormToFloat(q[1], maxValue), d);
+            const float dot = d[0] * n[0] + d[1] * n[1] + d[2] * n[2];
+            if (dot > best) {
+                best = dot;
+                out[0] = q[0];
+                out[1] = q[1];
+            }
+        }
+    }
+}
+
+VertexEncoding encodeVertices(const float* verts, size_t vertexCount, const VertexLayout& layout, uint8_t* out) {
+    VertexEncoding encoding;
+    float halfExtent[3] = {0.0f, 0.0f, 0.0f};
+    if (layout.position == POSITION_SNORM16 && vertexCount > 0) {
+        float lo[3], hi[3];
+        for (int k = 0; k < 3; ++k) lo[k] = hi[k] = verts[k];
+        for (size_t v = 1; v < vertexCount; ++v) {
+            for (int k = 0; k < 3; ++k) {
+                lo[k] = std::min(lo[k], verts[v * 6 + k]);
+                hi[k] = std::max(hi[k], verts[v * 6 + k]);
+            }
+        }
+        for (int k = 0; k < 3; ++k) {
+            encoding.positionBias[k] = (lo[k] + hi[k]) * 0.5f;
+            halfExtent[k] = (hi[k] - lo[k]) * 0.5f;
+            encoding.positionScale[k] = halfExtent[k] / 32767.0f;
+        }
+    }
+
+    const uint32_t stride = layout.stride();
+    const uint32_t normalOffset = layout.normalOffset();
+    memset(out, 0, vertexCount * stride);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const float* src = verts + v * 6;
+        uint8_t* dst = out + v * stride;
+
+        if (layout.position == POSITION_FLOAT32) {
+            memcpy(dst, src, 3 * sizeof(float));
+        } else if (layout.position == POSITION_HALF) {
+            uint16_t h[3] = {floatToHalf(src[0]), floatToHalf(src[1]), floatToHalf(src[2])};
+            memcpy(dst, h, sizeof(h));
+        } else {
+            int16_t q[3];
+            for (int k = 0; k < 3; ++k) {
+                const float t = halfExtent[k] > 0.0f ? (src[k] - encoding.positionBias[k]) / halfExtent[k] : 0.0f;
+                q[k] = (int16_t)floatToSnorm(t, 32767);
+            }
+            memcpy(dst, q, sizeof(q));
+        }
+
+        float n[3] = {src[3], src[4], src[5]};
+        const float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len > 0.0f) {
+            for (int k = 0; k < 3; ++k) n[k] /= len;
+        }
+        if (layout.normal == NORMAL_FLOAT32) {
+            memcpy(dst + normalOffset, src + 3, 3 * sizeof(float));
+        } else if (layout.normal == NORMAL_OCT8) {
+            int q[2];
+            octEncode(n, 127, q);
+            int8_t e[2] = {(int8_t)q[0], (int8_t)q[1]};
+            memcpy(dst + normalOffset, e, sizeof(e));
+        } else {
+            int q[2];
+            octEncode(n, 32767, q);
+            int16_t e[2] = {(int16_t)q[0], (int16_t)q[1]};
+            memcpy(dst + normalOffset, e, sizeof(e));
+        }
+
+        float decoded[6];
+        decodeVertex(dst, layout, encoding, decoded);
+        for (int k = 0; k < 3; ++k) {
+            encoding.maxPositionError = std::max(encoding.maxPositionError, fabsf(decoded[k] - src[k]));
+        }
+        if (len > 0.0f) {
+            // atan2(|a x b|, a . b)：小角度下比 acos 精确
+            const float* d = decoded + 3;
+            float cross[3] = {d[1] * n[2] - d[2] * n[1], d[2] * n[0] - d[0] * n[2], d[0] * n[1] - d[1] * n[0]};
+            float sine = sqrtf(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+            float angle = atan2f(sine, d[0] * n[0] + d[1] * n[1] + d[2] * n[2]) * 57.29578f;
+            encoding.maxNormalError = std::max(encoding.maxNormalError, angle);
+        }
+    }
+    return encoding;
+}
+
+void decodeVertex(const uint8_t* in, const VertexLayout& layout, const VertexEncoding& encoding, float out[6]) {
+    if (layout.position == POSITION_FLOAT32) {
+        memcpy(out, in, 3 * sizeof(float));
+    } else if (layout.position == POSITION_HALF) {
+        uint16_t h[3];
+        memcpy(h, in, sizeof(h));
+        for (int k = 0; k < 3; ++k) out[k] = halfToFloat(h[k]);
+    } else {
+        int16_t q[3];
+        memcpy(q, in, sizeof(q));
+        for (int k = 0; k < 3; ++k) out[k] = (float)q[k];
+    }
+    for (int k = 0; k < 3; ++k) out[k] = out[k] * encoding.positionScale[k] + encoding.positionBias[k];
+
+    const uint8_t* normal = in + layout.normalOffset();
+    if (layout.normal == NORMAL_FLOAT32) {
+        memcpy(out + 3, normal, 3 * sizeof(float));
+    } else if (layout.normal == NORMAL_OCT8) {
+        int8_t e[2];
+        memcpy(e, normal, sizeof(e));
+        octDecode(snormToFloat(e[0], 127), snormToFloat(e[1], 127), out + 3);
+    } else {
+        int16_t e[2];
+        memcpy(e, normal, sizeof(e));
+        octDecode(snormToFloat(e[0], 32767), snormToFloat(e[1], 32767), out + 3);
+    }
+}
+
+} // namespace Core
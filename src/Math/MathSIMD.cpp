@@ -0,0 +1,175 @@
+#include "Math/MathSIMD.h"
+#include <cmath>
+
+// 定义 PI_MATH_SCALAR 时强制使用标量回退（供测试在有 SIMD 的机器上覆盖回退路径）
+#if defined(PI_MATH_SCALAR)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PI_MATH_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PI_MATH_SSE 1
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PI_MATH_AVX 1
+#endif
+#endif
+
+const char* mathSIMDBackendName() {
+#if defined(PI_MATH_NEON)
+    return "NEON";
+#elif defined(PI_MATH_AVX)
+    return "AVX";
+#elif defined(PI_MATH_SSE)
+    return "SSE";
+#else
+    return "Scalar";
+#endif
+}
+
+void multiplyMatricesScalar(const float a[16], const float b[16], float result[16]) {
+    // OpenGL 列主序矩阵乘法 result = a * b
+    float tmp[16];
+    for (int i = 0; i < 4; ++i) {         // 行
+        for (int j = 0; j < 4; ++j) {     // 列
+            tmp[j * 4 + i] = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                tmp[j * 4 + i] += a[k * 4 + i] * b[j * 4 + k];
+            }
+        }
+    }
+    for (int i = 0; i < 16; ++i) result[i] = tmp[i];
+}
+
+// 结果第 j 列 = a 的四列按 b 第 j 列的四个分量线性组合。
+// a 的四列先载入寄存器，b 的第 j 列在写回第 j 列之前读取，因此允许原地计算。
+#if defined(PI_MATH_NEON)
+
+static inline void mul4x4(float32x4_t a0, float32x4_t a1, float32x4_t a2, float32x4_t a3,
+                          const float* b, float* r) {
+    for (int j = 0; j < 4; ++j) {
+        float32x4_t bj = vld1q_f32(b + j * 4);
+        float32x4_t col = vmulq_lane_f32(a0, vget_low_f32(bj), 0);
+        col = vmlaq_lane_f32(col, a1, vget_low_f32(bj), 1);
+        col = vmlaq_lane_f32(col, a2, vget_high_f32(bj), 0);
+        col = vmlaq_lane_f32(col, a3, vget_high_f32(bj), 1);
+        vst1q_f32(r + j * 4, col);
+    }
+}
+
+void multiplyMatricesSIMD(const float a[16], const float b[16], float result[16]) {
+    mul4x4(vld1q_f32(a), vld1q_f32(a + 4), vld1q_f32(a + 8), vld1q_f32(a + 12), b, result);
+}
+
+void multiplyMatricesBatch(const float vp[16], const float* models, int count, float* out) {
+    float32x4_t a0 = vld1q_f32(vp), a1 = vld1q_f32(vp + 4), a2 = vld1q_f32(vp + 8), a3 = vld1q_f32(vp + 12);
+    for (int i = 0; i < count; ++i) {
+        mul4x4(a0, a1, a2, a3, models + i * 16, out + i * 16);
+    }
+}
+
+void multiplyMatricesBatch(const float vp[16], const float* const* models, int count, float* out) {
+    float32x4_t a0 = vld1q_f32(vp), a1 = vld1q_f32(vp + 4), a2 = vld1q_f32(vp + 8), a3 = vld1q_f32(vp + 12);
+    for (int i = 0; i < count; ++i) {
+        mul4x4(a0, a1, a2, a3, models[i], out + i * 16);
+    }
+}
+
+#elif defined(PI_MATH_SSE)
+
+static inline void mul4x4(__m128 a0, __m128 a1, __m128 a2, __m128 a3, const float* b, float* r) {
+#if defined(PI_MATH_AVX)
+    // 一次处理两列：每个 128 位 lane 内广播 b 对应列的第 k 个分量
+    __m256 A0 = _mm256_insertf128_ps(_mm256_castps128_ps256(a0), a0, 1);
+    __m256 A1 = _mm256_insertf128_ps(_mm256_castps128_ps256(a1), a1, 1);
+    __m256 A2 = _mm256_insertf128_ps(_mm256_castps128_ps256(a2), a2, 1);
+    __m256 A3 = _mm256_insertf128_ps(_mm256_castps128_ps256(a3), a3, 1);
+    for (int j = 0; j < 4; j += 2) {
+        __m256 bb = _mm256_loadu_ps(b + j * 4);
+        __m256 col = _mm256_mul_ps(A0, _mm256_permute_ps(bb, 0x00));
+        col = _mm256_add_ps(col, _mm256_mul_ps(A1, _mm256_permute_ps(bb, 0x55)));
+        col = _mm256_add_ps(col, _mm256_mul_ps(A2, _mm256_permute_ps(bb, 0xAA)));
+        col = _mm256_add_ps(col, _mm256_mul_ps(A3, _mm256_permute_ps(bb, 0xFF)));
+        _mm256_storeu_ps(r + j * 4, col);
+    }
+#else
+    for (int j = 0; j < 4; ++j) {
+        __m128 col = _mm_mul_ps(a0, _mm_set1_ps(b[j * 4 + 0]));
+        col = _mm_add_ps(col, _mm_mul_ps(a1, _mm_set1_ps(b[j * 4 + 1])));
+        col = _mm_add_ps(col, _mm_mul_ps(a2, _mm_set1_ps(b[j * 4 + 2])));
+        col = _mm_add_ps(col, _mm_mul_ps(a3, _mm_set1_ps(b[j * 4 + 3])));
+        _mm_storeu_ps(r + j * 4, col);
+    }
+#endif
+}
+
+void multiplyMatricesSIMD(const float a[16], const float b[16], float result[16]) {
+    mul4x4(_mm_loadu_ps(a), _mm_loadu_ps(a + 4), _mm_loadu_ps(a + 8), _mm_loadu_ps(a + 12), b, result);
+}
+
+void multiplyMatricesBatch(const float vp[16], const float* models, int count, float* out) {
+    __m128 a0 = _mm_loadu_ps(vp), a1 = _mm_loadu_ps(vp + 4), a2 = _mm_loadu_ps(vp + 8), a3 = _mm_loadu_ps(vp + 12);
+    for (int i = 0; i < count; ++i) {
+        mul4x4(a0, a1, a2, a3, models + i * 16, out + i * 16);
+    }
+}
+
+void multiplyMatricesBatch(const float vp[16], const float* const* models, int count, float* out) {
+    __m128 a0 = _mm_loadu_ps(vp), a1 = _mm_loadu_ps(vp + 4), a2 = _mm_loadu_ps(vp + 8), a3 = _mm_loadu_ps(vp + 12);
+    for (int i = 0; i < count; ++i) {
+        mul4x4(a0, a1, a2, a3, models[i], out + i * 16);
+    }
+}
+
+#else
+
+void multiplyMatricesSIMD(const float a[16], const float b[16], float result[16]) {
+    multiplyMatricesScalar(a, b, result);
+}
+
+void multiplyMatricesBatch(const float vp[16], const float* models, int count, float* out) {
+    for (int i = 0; i < count; ++i) {
+        multiplyMatricesScalar(vp, models + i * 16, out + i * 16);
+    }
+}
+
+void multiplyMatricesBatch(const float vp[16], const float* const* models, int count, float* out) {
+    for (int i = 0; i < count; ++i) {
+        multiplyMatricesScalar(vp, models[i], out + i * 16);
+    }
+}
+
+#endif
+
+bool invertAffineMatrix(const float m[16], float inv[16]) {
+    // 左上 3x3 求逆（伴随矩阵 / 行列式），平移部分 t' = -R^-1 * t
+    float c00 = m[5] * m[10] - m[6] * m[9];
+    float c01 = m[6] * m[8]  - m[4] * m[10];
+    float c02 = m[4] * m[9]  - m[5] * m[8];
+    float det = m[0] * c00 + m[1] * c01 + m[2] * c02;
+    if (fabsf(det) < 1e-12f) {
+        return false;
+    }
+    float invDet = 1.0f / det;
+
+    float r[9];
+    r[0] = c00 * invDet;
+    r[1] = (m[2] * m[9]  - m[1] * m[10]) * invDet;
+    r[2] = (m[1] * m[6]  - m[2] * m[5])  * invDet;
+    r[3] = c01 * invDet;
+    r[4] = (m[0] * m[10] - m[2] * m[8])  * invDet;
+    r[5] = (m[2] * m[4]  - m[0] * m[6])  * invDet;
+    r[6] = c02 * invDet;
+    r[7] = (m[1] * m[8]  - m[0] * m[9])  * invDet;
+    r[8] = (m[0] * m[5]  - m[1] * m[4])  * invDet;
+
+    float tx = m[12], ty = m[13], tz = m[14];
+    inv[0] = r[0]; inv[1] = r[1]; inv[2]  = r[2]; inv[3]  = 0.0f;
+    inv[4] = r[3]; inv[5] = r[4]; inv[6]  = r[5]; inv[7]  = 0.0f;
+    inv[8] = r[6]; inv[9] = r[7]; inv[10] = r[8]; inv[11] = 0.0f;
+    inv[12] = -(r[0] * tx + r[3] * ty + r[6] * tz);
+    inv[13] = -(r[1] * tx + r[4] * ty + r[7] * tz);
+    inv[14] = -(r[2] * tx + r[5] * ty + r[8] * tz);
+    inv[15] = 1.0f;
+    return true;
+}
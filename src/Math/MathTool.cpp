@@ -1,4 +1,5 @@
 #include "Math/MathTool.h"
+#include "Math/MathSIMD.h"
 
 void createIdentityMatrix(float matrix[16]) {
     for (int i = 0; i < 16; ++i) {
@@ -7,15 +8,8 @@ void createIdentityMatrix(float matrix[16]) {
 }
 
 void multiplyMatrices(const float a[16], const float b[16], float result[16]) {
-    // OpenGL 列主序矩阵乘法 result = a * b
-    for (int i = 0; i < 4; ++i) {         // 行
-        for (int j = 0; j < 4; ++j) {     // 列
-            result[j * 4 + i] = 0.0f;
-            for (int k = 0; k < 4; ++k) {
-                result[j * 4 + i] += a[k * 4 + i] * b[j * 4 + k];
-            }
-        }
-    }
+    // OpenGL 列主序矩阵乘法 result = a * b（NEON / SSE 实现见 MathSIMD）
+    multiplyMatricesSIMD(a, b, result);
 }
 
 void createPerspectiveMatrix(float fovY, float aspect, float nearZ, float farZ, float matrix[16]) {
@@ -141,111 +135,57 @@ void createModelMatrix(float matrix[16], float rotate_y_deg, float rotate_x_deg)
     }
 }
 void createModelMatrix1(float matrix[16], float offset[3],float rotate_deg[3], float scale[3]) {
-
-    createIdentityMatrix(matrix);
+    // 展开 rotY * rotX 的闭式结果，避免构造中间矩阵再相乘
     float angle_rad_y = rotate_deg[1] * (M_PI / 180.0f);
     float c_y = cos(angle_rad_y);
     float s_y = sin(angle_rad_y);
-    
-    float rotY_mat[16]; 
-    createIdentityMatrix(rotY_mat);
-    rotY_mat[0] = c_y; 
-    rotY_mat[2] = s_y;
-    rotY_mat[8] = -s_y; 
-    rotY_mat[10] = c_y;
-
     float angle_rad_x = rotate_deg[2] * (M_PI / 180.0f);
     float c_x = cos(angle_rad_x);
     float s_x = sin(angle_rad_x);
-    
-    float rotX_mat[16]; 
-    createIdentityMatrix(rotX_mat);
-    rotX_mat[5] = c_x; 
-    rotX_mat[6] = -s_x;
-    rotX_mat[9] = s_x; 
-    rotX_mat[10] = c_x;
 
-    float temp_rot[16];
-    multiplyMatrices(rotY_mat, rotX_mat, temp_rot);
-        // 复制结果到返回矩阵
-    for (int i = 0; i < 16; i++) {
-        matrix[i] = temp_rot[i];
-    }
+    matrix[0] = c_y;         matrix[4] = s_x * s_y;   matrix[8]  = -c_x * s_y;  matrix[12] = offset[0];
+    matrix[1] = 0.0f;        matrix[5] = c_x;         matrix[9]  = s_x;         matrix[13] = offset[1];
+    matrix[2] = s_y;         matrix[6] = -s_x * c_y;  matrix[10] = c_x * c_y;   matrix[14] = offset[2];
+    matrix[3] = 0.0f;        matrix[7] = 0.0f;        matrix[11] = 0.0f;        matrix[15] = 1.0f;
 
-    // 平移
-    matrix[12] = offset[0];
-    matrix[13] = offset[1];
-    matrix[14] = offset[2];
-    // 缩放
+    // 缩放（与原实现一致，只作用于对角线）
     matrix[0] *= scale[0];
     matrix[5] *= scale[1];
     matrix[10] *= scale[2];
-    // 旋转
-
-
 }
 
-// 4x4矩阵求逆函数（使用Gauss-Jordan消元法）
+// 4x4矩阵求逆：仿射矩阵走 3x3 快速路径，其余使用余子式展开（无分支、无主元搜索）
 bool invertMatrix(const float m[16], float inv[16]) {
-    // 创建增广矩阵 [M | I]
-    float mat[4][8];
-    
-    // 初始化增广矩阵
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            mat[i][j] = m[i * 4 + j];           // 原矩阵
-            mat[i][j + 4] = (i == j) ? 1.0f : 0.0f; // 单位矩阵
-        }
+    if (m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f) {
+        return invertAffineMatrix(m, inv);
     }
-    
-    // Gauss-Jordan消元
-    for (int i = 0; i < 4; i++) {
-        // 寻找主元
-        int maxRow = i;
-        for (int k = i + 1; k < 4; k++) {
-            if (fabs(mat[k][i]) > fabs(mat[maxRow][i])) {
-                maxRow = k;
-            }
-        }
-        
-        // 交换行
-        if (maxRow != i) {
-            for (int k = 0; k < 8; k++) {
-                float temp = mat[i][k];
-                mat[i][k] = mat[maxRow][k];
-                mat[maxRow][k] = temp;
-            }
-        }
-        
-        // 检查是否可逆
-        if (fabs(mat[i][i]) < 1e-6f) {
-            return false; // 矩阵不可逆
-        }
-        
-        // 归一化主元行
-        float pivot = mat[i][i];
-        for (int k = 0; k < 8; k++) {
-            mat[i][k] /= pivot;
-        }
-        
-        // 消元
-        for (int k = 0; k < 4; k++) {
-            if (k != i) {
-                float factor = mat[k][i];
-                for (int j = 0; j < 8; j++) {
-                    mat[k][j] -= factor * mat[i][j];
-                }
-            }
-        }
+
+    float t[16];
+    t[0]  =  m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+    t[4]  = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+    t[8]  =  m[4]*m[9]*m[15]  - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+    t[12] = -m[4]*m[9]*m[14]  + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+    t[1]  = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+    t[5]  =  m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+    t[9]  = -m[0]*m[9]*m[15]  + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+    t[13] =  m[0]*m[9]*m[14]  - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+    t[2]  =  m[1]*m[6]*m[15]  - m[1]*m[7]*m[14]  - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7]  - m[13]*m[3]*m[6];
+    t[6]  = -m[0]*m[6]*m[15]  + m[0]*m[7]*m[14]  + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7]  + m[12]*m[3]*m[6];
+    t[10] =  m[0]*m[5]*m[15]  - m[0]*m[7]*m[13]  - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7]  - m[12]*m[3]*m[5];
+    t[14] = -m[0]*m[5]*m[14]  + m[0]*m[6]*m[13]  + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6]  + m[12]*m[2]*m[5];
+    t[3]  = -m[1]*m[6]*m[11]  + m[1]*m[7]*m[10]  + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7]   + m[9]*m[3]*m[6];
+    t[7]  =  m[0]*m[6]*m[11]  - m[0]*m[7]*m[10]  - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7]   - m[8]*m[3]*m[6];
+    t[11] = -m[0]*m[5]*m[11]  + m[0]*m[7]*m[9]   + m[4]*m[1]*m[11] - m[4]*m[3]*m[9]  - m[8]*m[1]*m[7]   + m[8]*m[3]*m[5];
+    t[15] =  m[0]*m[5]*m[10]  - m[0]*m[6]*m[9]   - m[4]*m[1]*m[10] + m[4]*m[2]*m[9]  + m[8]*m[1]*m[6]   - m[8]*m[2]*m[5];
+
+    float det = m[0] * t[0] + m[1] * t[4] + m[2] * t[8] + m[3] * t[12];
+    if (fabs(det) < 1e-12f) {
+        return false; // 矩阵不可逆
     }
-    
-    // 提取逆矩阵
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            inv[i * 4 + j] = mat[i][j + 4];
-        }
+    float invDet = 1.0f / det;
+    for (int i = 0; i < 16; i++) {
+        inv[i] = t[i] * invDet;
     }
-    
     return true;
 }
 void createOrthographicMatrix(float left, float right, float bottom, float top, float nearZ, float farZ, float matrix[16]) {
@@ -0,0 +1,232 @@
+// 无窗口基准程序：用 SoftRenderer 在 CPU 上渲染迷宫场景，玩家沿起点到终点的最短路径移动。
+// 输出各通道耗时（平均与 p50/p95/p99）与最后一帧画面（按扩展名写 PPM 或 PNG），可与参考图比较，平均误差超过阈值时返回非零，
+// 供没有 GPU 的构建机做帧时间与画面回归
+#include "Core/SoftRenderer.h"
+#include "Core/MazeScene.h"
+#include "Core/MeshCache.h"
+#include "Core/ImageIO.h"
+#include "Core/TraceRecorder.h"
+#include "Math/MathTool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int width = 800;
+    int height = 600;
+    int frames = 120;
+    int giDivisor = 2;
+    int threads = 0;
+    std::string output = "headless.ppm";
+    std::string reference;
+    float tolerance = 2.0f; // 参考图比较：每通道平均绝对误差（0~255）
+    std::string tracePath;  // 非空时写出各通道的 Chrome Trace JSON
+    std::string modelPath;  // 非空时导入 OBJ 模型放在终点格子
+    bool icosphere = false; // 玩家球体用 icosphere
+    bool meshReport = false; // 只打印程序生成网格的顶点缓存报告
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--size WxH] [--frames N] [--gi-divisor 1|2|4] [--threads N]\n"
+              << "       [--out frame.ppm|frame.png] [--compare ref.ppm] [--tolerance 2.0]\n"
+              << "       [--trace frames.json] [--model model.obj] [--sphere uv|ico] [--mesh-report]" << std::endl;
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--size" && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &opt.width, &opt.height) != 2) return false;
+        } else if (arg == "--frames" && hasValue) {
+            opt.frames = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--gi-divisor" && hasValue) {
+            opt.giDivisor = atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            opt.threads = atoi(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            opt.output = argv[++i];
+        } else if (arg == "--compare" && hasValue) {
+            opt.reference = argv[++i];
+        } else if (arg == "--tolerance" && hasValue) {
+            opt.tolerance = (float)atof(argv[++i]);
+        } else if (arg == "--trace" && hasValue) {
+            opt.tracePath = argv[++i];
+        } else if (arg == "--model" && hasValue) {
+            opt.modelPath = argv[++i];
+        } else if (arg == "--sphere" && hasValue) {
+            std::string kind = argv[++i];
+            if (kind != "uv" && kind != "ico") return false;
+            opt.icosphere = kind == "ico";
+        } else if (arg == "--mesh-report") {
+            opt.meshReport = true;
+        } else {
+            return false;
+        }
+    }
+    return opt.width > 0 && opt.height > 0;
+}
+
+// 程序生成网格的顶点缓存报告：生成顺序与优化后的 ACMR（VERTEX_CACHE_SIZE 项 FIFO），球体另附轮廓误差
+void printMeshReport() {
+    Core::MazeMeshes uv(false), ico(true);
+    const Core::Mesh* meshes[] = {&uv.cube, &uv.panel, uv.sphere.get(), ico.sphere.get()};
+    const char* names[] = {"cube", "panel", "uv sphere", "icosphere"};
+    printf("%-10s %8s %9s %14s %11s\n", "mesh", "vertices", "triangles", "ACMR", "silhouette");
+    for (int m = 0; m < 4; ++m) {
+        const Core::Mesh& mesh = *meshes[m];
+        const Core::MeshOrderStats& order = mesh.orderStats();
+        printf("%-10s %8zu %9zu %6.3f -> %5.3f", names[m], mesh.getVertices().size() / 6, mesh.getIndices().size() / 3,
+               order.acmrBefore, order.acmrAfter);
+        if (m >= 2) printf(" %11.5f", Core::sphereSilhouetteError(mesh.getVertices(), mesh.getIndices(), 0.5f));
+        printf("\n");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point launchTime = Clock::now();
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (opt.meshReport) {
+        printMeshReport();
+        return 0;
+    }
+    // 模型优先映射二进制缓存（CPU 副本为 float 顶点，缓存按 float 格式）；缓存缺失或过期时在工作线程中
+    // 解析与优化并写回缓存，与渲染器初始化、场景构建和光照烘焙重叠
+    Core::VertexLayout cacheLayout;
+    Core::MeshCache modelCache;
+    std::future<Core::ModelImport> modelLoad;
+    if (!opt.modelPath.empty()) {
+        const std::string cachePath = Core::meshCachePath(opt.modelPath, cacheLayout);
+        if (!modelCache.open(cachePath, Core::meshSourceHash(opt.modelPath), cacheLayout)) {
+            modelLoad = Core::importObjModelAsync(opt.modelPath, cachePath, cacheLayout);
+        }
+    }
+
+    Core::SoftRenderer renderer;
+    renderer.setThreadCount(opt.threads);
+    renderer.setGIResolutionDivisor(opt.giDivisor);
+    if (!renderer.init()) return 1;
+    renderer.reinitializeFBOs(opt.width, opt.height);
+
+    // 与窗口程序相同的正交俯视相机
+    const float orthoSize = std::max(Core::MAZE_WIDTH, Core::MAZE_HEIGHT) + 2.0f;
+    const float aspect = (float)opt.width / (float)opt.height;
+    float eye[3] = {Core::MAZE_WIDTH / 2.0f, Core::MAZE_HEIGHT / 2.0f, 25.0f};
+    float center[3] = {Core::MAZE_WIDTH / 2.0f, Core::MAZE_HEIGHT / 2.0f, 0.0f};
+    float up[3] = {0, 1, 0};
+    float view[16], projection[16], vp[16];
+    createLookAtMatrix(eye, center, up, view);
+    createOrthographicMatrix(-orthoSize * aspect * 0.5f, orthoSize * aspect * 0.5f, -orthoSize * 0.5f, orthoSize * 0.5f,
+                             0.1f, 100.0f, projection);
+    multiplyMatrices(projection, view, vp);
+
+    Core::MazeMeshes meshes(opt.icosphere);
+    Core::InstanceStore instances;
+    Core::InstanceHandle player = Core::buildMazeScene(instances, meshes);
+    {
+        Core::LightBaker baker;
+        Core::bakeMazeLights(instances, orthoSize, baker);
+        renderer.setStaticLightmap(baker);
+    }
+    // 基准需要确定的画面，在第一帧之前等待模型
+    std::vector<std::unique_ptr<Core::ModelMesh> > modelMeshes;
+    const char* modelSource = "none";
+    if (modelCache.isOpen()) {
+        Core::addMazeModel(modelCache, modelMeshes, instances, true); // SoftRenderer 读取 CPU 副本
+        const Core::MeshCacheHeader& header = modelCache.header();
+        printf("Model %s: %u triangles, %u vertices, %u parts from cache (%zu bytes mapped)\n", opt.modelPath.c_str(),
+               header.triangles, header.uniqueVertices, header.partCount, modelCache.size());
+        modelCache.close();
+        modelSource = "cache hit";
+    } else if (modelLoad.valid()) {
+        Core::ModelImport import = modelLoad.get();
+        const Core::ModelData& model = import.model;
+        if (!model.error.empty()) {
+            std::cerr << "Model load failed: " << model.error << std::endl;
+            return 1;
+        }
+        Core::addMazeModel(model, modelMeshes, instances);
+        printf("Model %s: %u triangles, %u -> %u vertices, %zu parts, ACMR %.3f -> %.3f, %.1f ms, cache %s\n",
+               opt.modelPath.c_str(), model.triangles, model.faceCorners, model.uniqueVertices, model.parts.size(),
+               model.acmrBefore, model.acmrAfter, model.loadMs, import.cacheWritten ? "written" : "not written");
+        modelSource = "cache miss, OBJ imported";
+    }
+    double coldStartMs = 0.0;
+    const std::vector<std::pair<int, int> > path = Core::mazeSolutionPath();
+
+    Core::TraceRecorder trace((size_t)opt.frames * 10);
+    if (!opt.tracePath.empty()) renderer.profiler().setTrace(&trace);
+
+    for (int frame = 0; frame < opt.frames; ++frame) {
+        trace.setFrame((uint32_t)frame);
+        Core::TraceScope frameScope(opt.tracePath.empty() ? nullptr : &trace, "frame", "frame");
+        float pos[3], model[16];
+        Core::mazePathPosition(path, frame * 0.25f, pos); // 每帧前进 0.25 格
+        Core::mazePlayerModel(pos, model);
+        instances.setModelMatrix(player, model);
+
+        // 各通道耗时由 renderer.profiler() 记录
+        renderer.beginFrame(vp, 1, instances);
+        renderer.renderEmissiveToRadianceFBO(vp, instances, Core::LAYER_RADIANCE);
+        renderer.renderBlockMap(vp, instances, Core::LAYER_OCCLUDER);
+        renderer.renderSDFLightsFBO(vp, instances, Core::LAYER_DYNAMIC);
+        renderer.renderStaticInstances(vp, instances, Core::LAYER_STATIC);
+        renderer.renderDynamicInstances(vp, instances, Core::LAYER_DYNAMIC);
+        renderer.renderPPGI();
+        renderer.OneFrameRenderFinish(true);
+        if (frame == 0) coldStartMs = std::chrono::duration<double, std::milli>(Clock::now() - launchTime).count();
+    }
+
+    std::cout << "Headless " << opt.width << "x" << opt.height << ", GI 1/" << opt.giDivisor << ", "
+              << opt.frames << " frames, " << renderer.lastTriangleCount() << " scene triangles" << std::endl;
+    printf("Cold start: %.1f ms from launch to first frame (model: %s)\n", coldStartMs, modelSource);
+    renderer.profiler().print();
+    if (!opt.tracePath.empty()) {
+        renderer.profiler().setTrace(nullptr);
+        if (!trace.writeJSON(opt.tracePath)) {
+            std::cerr << "Failed to write " << opt.tracePath << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> rgba;
+    int w = 0, h = 0;
+    renderer.readPixels(rgba, w, h);
+    if (!opt.output.empty() && !Core::writeImage(opt.output, rgba, w, h)) {
+        std::cerr << "Failed to write " << opt.output << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    if (!opt.reference.empty()) {
+        std::vector<uint8_t> ref;
+        int rw = 0, rh = 0;
+        if (!Core::readPPM(opt.reference, ref, rw, rh) || rw != w || rh != h) {
+            std::cerr << "Reference " << opt.reference << " missing or size mismatch" << std::endl;
+            return 1;
+        }
+        double error = Core::meanAbsoluteError(rgba, ref);
+        printf("  mean abs error vs %s: %.3f (tolerance %.3f)\n", opt.reference.c_str(), error, opt.tolerance);
+        if (error > opt.tolerance) result = 1;
+    }
+
+    renderer.shutdown();
+    return result;
+}
@@ -4,11 +4,23 @@
 #include "Core/Mesh.h"
 #include "Core/CubeMesh.h"
 #include "Core/PanelMesh.h"
-#include "Core/InstanceBase.h"
+#include "Core/InstanceStore.h"
 #include "Core/Sphere.h"
 #include "Core/Renderer.h"
+#include "Core/GeometryArena.h"
+#include "Core/LightBaker.h"
+#include "Core/MazeScene.h"
+#include "Core/MeshCache.h"
+#include "Core/ModelMesh.h"
+#include "Core/ImageIO.h"
+#include "Core/TraceRecorder.h"
 #include "Math/MathTool.h"
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <future>
+#include <memory>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -36,6 +48,7 @@ class Camera
         float view[16];
         float perspective[16];
         float vp[16];
+        unsigned int version = 0; // 每次 updateMatrix 递增，供渲染器的 MVP 缓存判断 VP 是否变化
 
 
         Camera(float pos[3], float tar[3], float upVec[3], float aspectRatio = 1.0f, float fovY = M_PI / 4.0f, float nearZ = 0.1f, float farZ = 100.0f, bool ortho = false, float orthoSz = 10.0f) {
@@ -67,81 +80,176 @@ class Camera
             }
             
             multiplyMatrices(perspective, view, vp);
+            ++version;
         }
 
 };
 float mazeCenterX = 0.0f;
 float mazeCenterY = 0.0f;
-const int mazeWidth = 16;
-const int mazeHeight = 16;
-// 更大更复杂的迷宫：0=通道，1=墙，2=起点，3=终点
-int maze[mazeHeight][mazeWidth] = {
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-    {1,2,0,0,1,0,0,0,0,1,0,0,0,0,0,1}, // 起点在(1,1)
-    {1,0,1,0,1,0,1,1,0,1,0,1,1,1,0,1},
-    {1,0,1,0,0,0,0,1,0,0,0,1,0,0,0,1},
-    {1,0,1,1,1,1,0,1,1,1,0,1,0,1,1,1},
-    {1,0,0,0,0,0,0,0,0,1,0,0,0,1,0,1},
-    {1,1,1,0,1,1,1,1,0,1,1,1,0,1,0,1},
-    {1,0,0,0,1,0,0,0,0,0,0,1,0,0,0,1},
-    {1,0,1,1,1,0,1,1,1,1,0,1,1,1,0,1},
-    {1,0,0,0,0,0,1,0,0,0,0,0,0,1,0,1},
-    {1,1,1,1,0,1,1,0,1,1,1,1,0,1,0,1},
-    {1,0,0,0,0,0,0,0,1,0,0,0,0,1,0,1},
-    {1,0,1,1,1,1,1,0,1,0,1,1,0,0,0,1},
-    {1,0,0,0,0,0,1,0,0,0,1,0,0,1,0,1},
-    {1,0,1,1,1,0,0,0,1,0,0,0,1,0,3,1}, // 终点在(14,14)
-    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
+// 迷宫布局与场景构建见 Core/MazeScene.h，与无窗口基准程序共用
+const int mazeWidth = Core::MAZE_WIDTH;
+const int mazeHeight = Core::MAZE_HEIGHT;
+const float exitX = Core::MAZE_EXIT_X;
+const float exitY = Core::MAZE_EXIT_Y;
+
+// --offscreen：不开窗口，在 EGL pbuffer / surfaceless 上下文中跑固定帧数，玩家沿最短路径自动移动，
+// 结束时输出帧时间统计，可按间隔导出 PNG 并与参考图比较（没有显示器的机器上做性能与画面回归）
+struct RunOptions {
+    bool offscreen = false;
+    int frames = 300;
+    int width = 800;
+    int height = 600;
+    std::string dumpPrefix;   // 非空时每 dumpEvery 帧写 <prefix><帧号>.png
+    int dumpEvery = 0;        // 0 表示只写最后一帧
+    std::string reference;    // 最后一帧与之比较的 PPM
+    float tolerance = 2.0f;   // 每通道平均绝对误差（0~255）
+    std::string tracePath;    // 非空时记录帧时间线，退出时写出 Chrome Trace JSON（窗口模式同样可用）
+    int traceEvents = 65536;  // 环形缓冲容量，约 10 个事件/帧
+    std::string vertexFormat = "compact"; // 网格顶点格式：float / half / compact，见 Core/VertexFormat.h
+    std::string modelPath;    // 非空时导入 OBJ 模型放在终点格子（工作线程加载，就绪后加入场景）
+    bool icosphere = false;   // 玩家球体用 icosphere（同样轮廓误差下顶点更少）
+    bool staticBatch = false; // 支持实例化时也强制静态迷宫走合并批次（默认只在不支持实例化时启用）
 };
 
-// 起点和终点坐标
-const float startX = 1.0f;
-const float startY = 1.0f;
-const float exitX = 14.0f;
-const float exitY = 14.0f;
+static bool parseRunOptions(int argc, char** argv, RunOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--offscreen") {
+            opt.offscreen = true;
+        } else if (arg == "--frames" && hasValue) {
+            opt.frames = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--size" && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &opt.width, &opt.height) != 2) return false;
+        } else if (arg == "--dump-prefix" && hasValue) {
+            opt.dumpPrefix = argv[++i];
+        } else if (arg == "--dump-every" && hasValue) {
+            opt.dumpEvery = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--compare" && hasValue) {
+            opt.reference = argv[++i];
+        } else if (arg == "--tolerance" && hasValue) {
+            opt.tolerance = (float)atof(argv[++i]);
+        } else if (arg == "--trace" && hasValue) {
+            opt.tracePath = argv[++i];
+        } else if (arg == "--trace-events" && hasValue) {
+            opt.traceEvents = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--vertex-format" && hasValue) {
+            opt.vertexFormat = argv[++i];
+            Core::VertexLayout layout;
+            if (!Core::parseVertexLayout(opt.vertexFormat, layout)) return false;
+        } else if (arg == "--model" && hasValue) {
+            opt.modelPath = argv[++i];
+        } else if (arg == "--sphere" && hasValue) {
+            std::string kind = argv[++i];
+            if (kind != "uv" && kind != "ico") return false;
+            opt.icosphere = kind == "ico";
+        } else if (arg == "--static-batch") {
+            opt.staticBatch = true;
+        } else {
+            return false;
+        }
+    }
+    return opt.width > 0 && opt.height > 0;
+}
 
-int main() {
+static bool dumpFrame(Core::RenderBackend& renderer, const std::string& prefix, int frame) {
+    std::vector<uint8_t> rgba;
+    int w = 0, h = 0;
+    renderer.readPixels(rgba, w, h);
+    char name[32];
+    snprintf(name, sizeof(name), "%05d.png", frame);
+    std::string path = prefix + name;
+    if (!Core::writePNG(path, rgba, w, h)) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    // 冷启动计时起点：到第一帧结束的耗时（含模型加载：离屏运行在第一帧前等待模型）
+    const std::chrono::steady_clock::time_point launchTime = std::chrono::steady_clock::now();
     std::cout << "Program started" << std::endl;
     using namespace Platform;
+    RunOptions options;
+    if (!parseRunOptions(argc, argv, options)) {
+        std::cout << "Usage: " << argv[0] << " [--offscreen] [--frames N] [--size WxH]\n"
+                  << "       [--dump-prefix out/frame_] [--dump-every K] [--compare ref.ppm] [--tolerance 2.0]\n"
+                  << "       [--trace frames.json] [--trace-events 65536] [--vertex-format float|half|compact]\n"
+                  << "       [--model model.obj] [--sphere uv|ico] [--static-batch]" << std::endl;
+        return 2;
+    }
+    // 着色器按顶点格式编译，必须在 Renderer::init 与创建网格之前设置；网格缓存也按该格式编码
+    Core::VertexLayout vertexLayout;
+    Core::parseVertexLayout(options.vertexFormat, vertexLayout);
+    Core::geometryArena().setLayout(vertexLayout);
+
+    // 模型优先映射二进制缓存。缓存缺失或过期时 OBJ 的解析、去重与缓存优化在工作线程中进行并写回缓存，
+    // 不阻塞窗口与渲染器初始化；GL 上传留在主线程
+    Core::MeshCache modelCache;
+    std::future<Core::ModelImport> modelLoad;
+    if (!options.modelPath.empty()) {
+        const std::string cachePath = Core::meshCachePath(options.modelPath, vertexLayout);
+        if (!modelCache.open(cachePath, Core::meshSourceHash(options.modelPath), vertexLayout)) {
+            modelLoad = Core::importObjModelAsync(options.modelPath, cachePath, vertexLayout);
+        }
+    }
+    const bool offscreen = options.offscreen;
     int window_width = 800;
     int window_height = 600;
-    if (!initWindow(window_width, window_height)) {
-        std::cerr << "initWindow failed!" << std::endl;
-        return -1;
-    }
+    if (offscreen) {
+        window_width = options.width;
+        window_height = options.height;
+        if (!initOffscreen(window_width, window_height)) {
+            std::cerr << "initOffscreen failed!" << std::endl;
+            return -1;
+        }
+    } else {
+        if (!initWindow(window_width, window_height)) {
+            std::cerr << "initWindow failed!" << std::endl;
+            return -1;
+        }
 
-    // 获取实际屏幕分辨率（全屏模式下的真实尺寸）
-    SDL_DisplayMode displayMode;
-    if (SDL_GetCurrentDisplayMode(0, &displayMode) == 0) {
-        window_width = displayMode.w;
-        window_height = displayMode.h;
-        std::cout << "Full screen resolution: " << window_width << "x" << window_height << std::endl;
+        // 获取实际屏幕分辨率（全屏模式下的真实尺寸）
+        SDL_DisplayMode displayMode;
+        if (SDL_GetCurrentDisplayMode(0, &displayMode) == 0) {
+            window_width = displayMode.w;
+            window_height = displayMode.h;
+            std::cout << "Full screen resolution: " << window_width << "x" << window_height << std::endl;
+        }
     }
 
-    Core::Renderer renderer;
-    if (!renderer.init()) return -1;
-    
-    // 重新初始化FBO以适应实际屏幕分辨率
-    renderer.reinitializeFBOs(window_width, window_height);
-
-    bool running = true;
-    float aspect = (float)window_width / (float)window_height;
-    // float proj[16], view[16], model[16], tmp[16], mvp[16],vp[16];
-    float model[16];
-    float PanelModel[16];
-
     // Performance optimization settings
     bool enableGI = true;  // 启用全局光照测试
     bool enablePostProcessing = true; // 后处理开关
     int frameSkip = 0; // 每帧都计算GI以获得更好效果
+    int giResolutionDivisor = 1; // GI 以 1/divisor 分辨率计算后双边上采样（1 / 2 / 4）
+    int giTemporalInterleave = 1; // 每帧追踪 1/N 的 GI 像素并复用重投影历史（1 / 2 / 4）
+    bool useRadianceCascades = true; // 多级 Radiance Cascades（所有发光体）；false 时为玩家点光源的 SDF GI
 
     // 根据树莓派性能调整设置
     #ifndef _WIN32
     enableGI = true;  // 树莓派也启用GI测试SDF效果
     frameSkip = 2;    // 每3帧计算一次GI（平衡性能和效果）
+    giResolutionDivisor = 2; // 半分辨率GI，填充开销降为1/4
+    giTemporalInterleave = 4; // GI 帧内只追踪1/4像素，其余复用历史
+    useRadianceCascades = false; // 树莓派保留开销更低的 SDF 点光源
     std::cout << "Using Raspberry Pi with SDF GI enabled" << std::endl;
     #endif
 
+    Core::Renderer renderer;
+    renderer.setGIResolutionDivisor(giResolutionDivisor);
+    renderer.setGITemporalInterleave(giTemporalInterleave);
+    if (!renderer.init()) return -1;
+    
+    // 重新初始化FBO以适应实际屏幕分辨率
+    renderer.reinitializeFBOs(window_width, window_height);
+
+    bool running = true;
+    float aspect = (float)window_width / (float)window_height;
+    // float proj[16], view[16], model[16], tmp[16], mvp[16],vp[16];
+    float model[16];
+
     const float targetFrameTime = 1000.0f / 60.0f; // 60帧
     Uint32 lastTicks = SDL_GetTicks();
     float totalTime = 0.0f;
@@ -164,96 +272,115 @@ int main() {
 
     
 
-    Core::CubeMesh cubeMesh;
-    Core::PanelMesh panelMesh;
-    Core::SphereMesh sphereMesh;
-    std::vector<Core::Instance*> StaticInstances;
-    std::vector<Core::Instance*> DynamicInstances;
-    std::vector<Core::Instance*> BlockInstances;
-
-    Core::Instance* instance = new Core::PanelInstance(&panelMesh);
-    float pos[3] = {mazeHeight/2.f, mazeWidth/2.f, -3.0f};
-    float rot[3] = {0, 3.14f/2, 0}; // 只绕Y轴旋转
-    float scale[3] = {20, 20, 20}; 
-    createModelMatrix1(PanelModel, pos, rot, scale);
-    instance->setModelMatrix(PanelModel);
-    instance->setColor(0.0f, 0.0f, 0.0f, 1.0f); // 黑色地板
-    StaticInstances.push_back(instance);
-
-
-
-    for (int y = 0; y < mazeHeight; ++y) {
-        for (int x = 0; x < mazeWidth; ++x) {
-            if (maze[y][x] == 1) { // 是墙
-                float pos[3] = { (float)x, (float)y, 0.0f}; // y轴向下
-                float rot[3] = {0, 0, 0};
-                float scale[3] = {1, 1, 2};
-                float* model = new float[16];
-                createModelMatrix1(model, pos, rot, scale);
-                Core::Instance* instance = new Core::CubeInstance(&cubeMesh);
-                instance->setModelMatrix(model);
-                instance->setColor(0.0f, 0.0f, 0.0f, 1.0f);
-                instance->setEmissive(0.f, 0.f, 0.f, 0.0f);
-                StaticInstances.push_back(instance);
-                BlockInstances.push_back(instance); // 墙体实例也加入BlockMap
-            } else if (maze[y][x] == 2) { // 起点标记
-                // 在起点放置一个黑色地板标记，只有微弱绿色发光
-                float pos[3] = { (float)x, (float)y, -0.5f}; // 稍微低一点
-                float rot[3] = {M_PI/2, 0, 0}; // 旋转90度让面板水平
-                float scale[3] = {0.8f, 0.8f, 0.1f};
-                float* model = new float[16];
-                createModelMatrix1(model, pos, rot, scale);
-                Core::Instance* instance = new Core::PanelInstance(&panelMesh);
-                instance->setModelMatrix(model);
-                instance->setColor(0.0f, 0.0f, 0.0f, 1.0f); // 黑色
-                instance->setEmissive(0.05f, 0.2f, 0.05f, 1.0f); // 很微弱的绿色发光
-                StaticInstances.push_back(instance);
-            } else if (maze[y][x] == 3) { // 终点标记
-                // 在终点放置一个黑色地板标记，只有微弱红色发光
-                float pos[3] = { (float)x, (float)y, -0.5f}; // 稍微低一点
-                float rot[3] = {M_PI/2, 0, 0}; // 旋转90度让面板水平
-                float scale[3] = {0.8f, 0.8f, 0.1f};
-                float* model = new float[16];
-                createModelMatrix1(model, pos, rot, scale);
-                Core::Instance* instance = new Core::PanelInstance(&panelMesh);
-                instance->setModelMatrix(model);
-                instance->setColor(0.0f, 0.0f, 0.0f, 1.0f); // 黑色
-                instance->setEmissive(0.2f, 0.05f, 0.05f, 1.0f); // 很微弱的红色发光
-                StaticInstances.push_back(instance);
-            }
-        }
+    Core::MazeMeshes meshes(options.icosphere);
+    std::vector<std::unique_ptr<Core::ModelMesh> > modelMeshes; // --model 导入的分段
+    // 所有实例存放在一个 SoA 存储中，通过层掩码区分静态/动态/遮挡/发光
+    Core::InstanceStore instances;
+    Core::InstanceHandle playerInstance = Core::buildMazeScene(instances, meshes);
+    {
+        Core::GeometryArena::Stats arena = Core::geometryArena().stats();
+        std::cout << "Geometry arena: " << arena.meshes << " meshes, " << arena.usedVertices << "/"
+                  << arena.vertexCapacity << " vertices, " << arena.usedIndices << "/" << arena.indexCapacity
+                  << " indices in one VBO/IBO" << std::endl;
+        std::cout << "Vertex format: " << options.vertexFormat << ", " << arena.vertexStride
+                  << " bytes/vertex, max error " << arena.maxPositionError << " (position), "
+                  << arena.maxNormalError << " deg (normal)" << std::endl;
     }
 
-
     //Player:
-    Core::Instance* playerInstance = new Core::SphereInstance(&sphereMesh);
-    DynamicInstances.push_back(playerInstance);
-    float playerPos[3] = {startX, startY, 0.0f}; // 玩家从起点开始
-    float playerRot[3] = {0, 0, 0};
-    float playerScale[3] = {0.3f, 0.3f, 0.3f}; // 球体半径为0.3
-    float* playerModel = new float[16];
-    float* playerMVP = new float[16];
-    createModelMatrix1(playerModel, playerPos, playerRot, playerScale);
-    playerInstance->setModelMatrix(playerModel);
-    playerInstance->setColor(1.0f, 0.0f, 0.0f, 1.0f); // 红色球体
-    playerInstance->setEmissive(1.5f, 1.0f, 0.8f, 1.0f); // 更强的橙红色发光
+    float playerPos[3] = {Core::MAZE_START_X, Core::MAZE_START_Y, 0.0f}; // 玩家从起点开始
+    float playerModel[16];
+    float playerMVP[16];
+
+    // 静态发光体（起点/终点标记）启动时在 CPU 上烘焙成光照贴图，SDF GI 每帧只追踪动态光源
+    {
+        Core::LightBaker baker;
+        Core::bakeMazeLights(instances, orthoSize, baker);
+        renderer.setStaticLightmap(baker);
+    }
+
+    // 不支持实例化（或 --static-batch）时，静态迷宫合并为一个预变换的顶点缓冲绘制
+    const bool staticBatching = options.staticBatch || !renderer.supportsInstancing();
+    renderer.setStaticBatchingEnabled(staticBatching);
+    // 裁剪网格与迷宫格子对齐（格子中心在整数坐标）
+    renderer.setCullingGrid(-0.5f, -0.5f, 1.0f);
 
     //Input:
     #ifndef _WIN32
-    wiringPiSetupGpio(); // 使用BCM编号
-    pinMode(17, INPUT);
-    pinMode(18, INPUT);
-    pinMode(27, INPUT);
-    pinMode(22, INPUT);
-    pullUpDnControl(17, PUD_UP); // 上拉
-    pullUpDnControl(18, PUD_UP);
-    pullUpDnControl(27, PUD_UP);
-    pullUpDnControl(22, PUD_UP);
+    if (!offscreen) {
+        wiringPiSetupGpio(); // 使用BCM编号
+        pinMode(17, INPUT);
+        pinMode(18, INPUT);
+        pinMode(27, INPUT);
+        pinMode(22, INPUT);
+        pullUpDnControl(17, PUD_UP); // 上拉
+        pullUpDnControl(18, PUD_UP);
+        pullUpDnControl(27, PUD_UP);
+        pullUpDnControl(22, PUD_UP);
+    }
     #endif
 
+    // 无窗口模式：玩家沿起点到终点的最短路径往返，每帧 CPU 提交 + glFinish 的耗时
+    const std::vector<std::pair<int, int> > solutionPath = Core::mazeSolutionPath();
+    std::vector<double> offscreenFrameTimes;
+    typedef std::chrono::steady_clock Clock;
+    int exitCode = 0;
+
+    // 帧时间线：输入、更新、各渲染通道（经 profiler）与 swapBuffers，容量用尽后覆盖最旧的帧
+    std::unique_ptr<Core::TraceRecorder> traceRecorder;
+    if (!options.tracePath.empty()) {
+        traceRecorder.reset(new Core::TraceRecorder((size_t)options.traceEvents));
+        renderer.profiler().setTrace(traceRecorder.get());
+    }
+    Core::TraceRecorder* trace = traceRecorder.get();
+    uint32_t traceFrame = 0;
+
+    // 模型就绪后在主线程创建网格并加入场景；离屏运行需要确定的画面，在第一帧之前等待
+    auto addLoadedModel = [&]() {
+        Clock::time_point uploadBegin = Clock::now();
+        if (modelCache.isOpen()) {
+            // 只有静态合批读取 CPU 副本，否则映射的顶点直接上传，不在主线程解码
+            Core::addMazeModel(modelCache, modelMeshes, instances, staticBatching);
+            const Core::MeshCacheHeader& header = modelCache.header();
+            std::cout << "Model " << options.modelPath << ": " << header.triangles << " triangles, "
+                      << header.uniqueVertices << " vertices, " << header.partCount << " parts from cache ("
+                      << modelCache.size() << " bytes mapped), uploaded in "
+                      << std::chrono::duration<double, std::milli>(Clock::now() - uploadBegin).count() << " ms"
+                      << std::endl;
+            modelCache.close();
+        } else {
+            Core::ModelImport import = modelLoad.get();
+            const Core::ModelData& model = import.model;
+            if (!model.error.empty()) {
+                std::cerr << "Model load failed: " << model.error << std::endl;
+                return;
+            }
+            Core::addMazeModel(model, modelMeshes, instances);
+            std::cout << "Model " << options.modelPath << ": " << model.triangles << " triangles, " << model.faceCorners
+                      << " -> " << model.uniqueVertices << " vertices, " << model.parts.size() << " parts, ACMR "
+                      << model.acmrBefore << " -> " << model.acmrAfter << ", loaded in " << model.loadMs
+                      << " ms on a worker thread";
+            if (import.cacheWritten) {
+                std::cout << ", cache written in " << import.cacheWriteMs << " ms" << std::endl;
+            } else {
+                std::cout << ", cache not written" << std::endl;
+            }
+        }
+        std::cout << "Model ready " << std::chrono::duration<double, std::milli>(Clock::now() - launchTime).count()
+                  << " ms after launch" << std::endl;
+    };
+    if (offscreen && (modelCache.isOpen() || modelLoad.valid())) addLoadedModel();
+    bool firstFrame = true;
+
     while (running) {
+        if (trace) trace->setFrame(traceFrame++);
+        Core::TraceScope frameScope(trace, "frame", "frame");
         models.clear();
-        Uint32 frameStart = SDL_GetTicks();
+        Clock::time_point frameBegin = Clock::now();
+        if (modelCache.isOpen() ||
+            (modelLoad.valid() && modelLoad.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+            addLoadedModel();
+        }
 
         //pollEvents(running);
 
@@ -263,65 +390,73 @@ int main() {
         // 1秒转半圈
         float angle = fmod(totalTime * 180.0f, 360.0f);
 
+        if (offscreen) {
+            Core::mazePathPosition(solutionPath, offscreenFrameTimes.size() * 0.25f, playerPos); // 每帧前进 0.25 格
+        } else {
+            Core::TraceScope inputScope(trace, "input");
     #ifdef _WIN32
-        // Windows下用原有的Platform::pollEvents
-        Platform::InputState input;
-        Platform::pollEvents(running, input);
+            // Windows下用原有的Platform::pollEvents
+            Platform::InputState input;
+            Platform::pollEvents(running, input);
         
-        // 保存当前位置用于碰撞检测
-        float newPlayerPos[3] = {playerPos[0], playerPos[1], playerPos[2]};
+            // 保存当前位置用于碰撞检测
+            float newPlayerPos[3] = {playerPos[0], playerPos[1], playerPos[2]};
         
-        if (input.up) newPlayerPos[1] += 0.1f;
-        else if (input.down) newPlayerPos[1] -= 0.1f;
-        else if (input.left) newPlayerPos[0] -= 0.1f;
-        else if (input.right) newPlayerPos[0] += 0.1f;
+            if (input.up) newPlayerPos[1] += 0.1f;
+            else if (input.down) newPlayerPos[1] -= 0.1f;
+            else if (input.left) newPlayerPos[0] -= 0.1f;
+            else if (input.right) newPlayerPos[0] += 0.1f;
         
-        // 碰撞检测：检查新位置是否合法
-        int gridX = (int)round(newPlayerPos[0]);
-        int gridY = (int)round(newPlayerPos[1]);
-        if (gridX >= 0 && gridX < mazeWidth && gridY >= 0 && gridY < mazeHeight && 
-            maze[gridY][gridX] != 1) { // 不是墙
-            playerPos[0] = newPlayerPos[0];
-            playerPos[1] = newPlayerPos[1];
+            // 碰撞检测：检查新位置是否合法
+            int gridX = (int)round(newPlayerPos[0]);
+            int gridY = (int)round(newPlayerPos[1]);
+            if (gridX >= 0 && gridX < mazeWidth && gridY >= 0 && gridY < mazeHeight && 
+                Core::mazeLayout[gridY][gridX] != 1) { // 不是墙
+                playerPos[0] = newPlayerPos[0];
+                playerPos[1] = newPlayerPos[1];
             
-            // 检查是否到达终点
-            if (gridX == (int)exitX && gridY == (int)exitY) {
-                std::cout << "恭喜！到达终点！" << std::endl;
+                // 检查是否到达终点
+                if (gridX == (int)exitX && gridY == (int)exitY) {
+                    std::cout << "恭喜！到达终点！" << std::endl;
+                }
             }
-        }
     #else
-        // 树莓派下用GPIO
-        Platform::pollEvents(running);
+            // 树莓派下用GPIO
+            Platform::pollEvents(running);
         
-        // 保存当前位置用于碰撞检测
-        float newPlayerPos[3] = {playerPos[0], playerPos[1], playerPos[2]};
+            // 保存当前位置用于碰撞检测
+            float newPlayerPos[3] = {playerPos[0], playerPos[1], playerPos[2]};
         
-        if (digitalRead(17) == LOW) newPlayerPos[1] += 0.1f;   // 上
-        else if (digitalRead(18) == LOW) newPlayerPos[1] -= 0.1f; // 下
-        else if (digitalRead(27) == LOW) newPlayerPos[0] -= 0.1f; // 左
-        else if (digitalRead(22) == LOW) newPlayerPos[0] += 0.1f; // 右
+            if (digitalRead(17) == LOW) newPlayerPos[1] += 0.1f;   // 上
+            else if (digitalRead(18) == LOW) newPlayerPos[1] -= 0.1f; // 下
+            else if (digitalRead(27) == LOW) newPlayerPos[0] -= 0.1f; // 左
+            else if (digitalRead(22) == LOW) newPlayerPos[0] += 0.1f; // 右
         
-        // 碰撞检测：检查新位置是否合法
-        int gridX = (int)round(newPlayerPos[0]);
-        int gridY = (int)round(newPlayerPos[1]);
-        if (gridX >= 0 && gridX < mazeWidth && gridY >= 0 && gridY < mazeHeight && 
-            maze[gridY][gridX] != 1) { // 不是墙
-            playerPos[0] = newPlayerPos[0];
-            playerPos[1] = newPlayerPos[1];
+            // 碰撞检测：检查新位置是否合法
+            int gridX = (int)round(newPlayerPos[0]);
+            int gridY = (int)round(newPlayerPos[1]);
+            if (gridX >= 0 && gridX < mazeWidth && gridY >= 0 && gridY < mazeHeight && 
+                Core::mazeLayout[gridY][gridX] != 1) { // 不是墙
+                playerPos[0] = newPlayerPos[0];
+                playerPos[1] = newPlayerPos[1];
             
-            // 检查是否到达终点
-            if (gridX == (int)exitX && gridY == (int)exitY) {
-                std::cout << "恭喜！到达终点！" << std::endl;
+                // 检查是否到达终点
+                if (gridX == (int)exitX && gridY == (int)exitY) {
+                    std::cout << "恭喜！到达终点！" << std::endl;
+                }
             }
-        }
     #endif
+        }
 
         // 限制玩家在迷宫范围内
         // playerPos[0] = std::max(0.5f, std::min((float)mazeWidth - 0.5f, playerPos[0]));
         // playerPos[1] = std::max(0.5f, std::min((float)mazeHeight - 0.5f, playerPos[1]));
 
-        createModelMatrix1(playerModel, playerPos, playerRot, playerScale);
-        playerInstance->setModelMatrix(playerModel);
+        {
+            Core::TraceScope updateScope(trace, "update");
+            Core::mazePlayerModel(playerPos, playerModel);
+            instances.setModelMatrix(playerInstance, playerModel);
+        }
 
         float pos[3] = {mazeHeight/2.f, mazeWidth/2.f, 0.0f};
         float rot[3] = {0, 3.14f/2, 0}; // 只绕Y轴旋转
@@ -335,7 +470,7 @@ int main() {
         frameCount++;
         
         // 坐标转换调试：计算玩家的屏幕坐标
-        if (frameCount % 10 == 0) { // 每10帧打印一次，更频繁
+        if (!offscreen && frameCount % 10 == 0) { // 每10帧打印一次，更频繁
             // 将玩家世界坐标转换为屏幕坐标
 
             multiplyMatrices(camera.vp, playerModel,playerMVP);
@@ -367,49 +502,116 @@ int main() {
             std::cout << "屏幕UV: (" << playerScreenUV[0] << ", " << playerScreenUV[1] << ")" << std::endl;
         }
         
+        // 每帧 MVP 只计算一次；相机不动时静态墙体完全跳过
+        renderer.beginFrame(camera.vp, camera.version, instances);
+
         if (enableGI && (frameSkip == 0 || frameCount % (frameSkip + 1) == 0)) {
             // 完整的全局光照渲染
             // if (frameCount % 60 == 0) {
             //     std::cout << "Rendering GI frame " << frameCount << std::endl;
             // }
-            renderer.renderEmissiveToRadianceFBO(camera.vp, DynamicInstances);
-            renderer.renderBlockMap(camera.vp, BlockInstances);
+            renderer.renderEmissiveToRadianceFBO(camera.vp, instances, Core::LAYER_RADIANCE);
+            renderer.renderBlockMap(camera.vp, instances, Core::LAYER_OCCLUDER);
             
-            // 统一使用SDF GI shader，传递VP矩阵和玩家坐标
-            renderer.renderDiffuseFBO(camera.vp, DynamicInstances, playerPos, camera.vp);
+            if (useRadianceCascades) {
+                renderer.renderDiffuseFBO(camera.vp, instances, Core::LAYER_DYNAMIC);
+            } else {
+                // SDF GI：静态光源已烘焙，只对动态自发光实例（玩家）分块追踪
+                renderer.renderSDFLightsFBO(camera.vp, instances, Core::LAYER_DYNAMIC);
+            }
         }
         
         // 基础渲染（每帧都执行）
-        renderer.renderStaticInstances(camera.vp, StaticInstances);
-        renderer.renderDynamicInstances(camera.vp, DynamicInstances);
+        renderer.renderStaticInstances(camera.vp, instances, Core::LAYER_STATIC);
+        renderer.renderDynamicInstances(camera.vp, instances, Core::LAYER_DYNAMIC);
 
         if (enablePostProcessing) {
             renderer.renderPPGI();
         }
         
         renderer.OneFrameRenderFinish(enablePostProcessing);
-        swapBuffers();
+        {
+            Core::TraceScope swapScope(trace, "swapBuffers");
+            swapBuffers();
+        }
+        if (firstFrame) {
+            firstFrame = false;
+            printf("Cold start: %.1f ms from launch to first frame\n",
+                   std::chrono::duration<double, std::milli>(Clock::now() - launchTime).count());
+        }
+
+        if (offscreen) {
+            offscreenFrameTimes.push_back(
+                std::chrono::duration<double, std::milli>(Clock::now() - frameBegin).count());
+            const int frameIndex = (int)offscreenFrameTimes.size();
+            const bool last = frameIndex >= options.frames;
+            // 导出不计入帧时间
+            if (!options.dumpPrefix.empty() && (last || (options.dumpEvery > 0 && frameIndex % options.dumpEvery == 0))) {
+                Core::TraceScope dumpScope(trace, "dumpFrame");
+                if (!dumpFrame(renderer, options.dumpPrefix, frameIndex)) exitCode = 1;
+            }
+            if (last) running = false;
+            continue;
+        }
 
         // 性能统计（无帧率限制）
-        Uint32 frameEnd = SDL_GetTicks();
-        Uint32 frameTime = frameEnd - frameStart;
-        
-        // 如果需要限制帧率，可以启用以下代码
-        // if (frameTime < targetFrameTime) {
-        //     SDL_Delay((Uint32)(targetFrameTime - frameTime));
-        // }
-        
         // Frame info moved to less frequent output
         if (frameCount % 60 == 0) { // 每60帧输出一次
-            float fps = frameTime > 0 ? 1000.0f / frameTime : 0.0f;
-            std::cout << "FPS: " << fps << " FrameTime: " << frameTime << "ms" 
+            // 帧时间取 profiler 最近 256 帧的滚动平均（steady_clock，亚毫秒精度）
+            Core::PassStats frameStats = renderer.profiler().frameStats();
+            float fps = frameStats.avg > 0.0 ? (float)(1000.0 / frameStats.avg) : 0.0f;
+            const Core::GLStateCache::Stats& glStats = renderer.glStateStats();
+            std::cout << "FPS: " << fps << " FrameTime: " << frameStats.avg << "ms (p95 " << frameStats.p95 << "ms)"
+                      << " GL state: " << glStats.elided << " elided / " << glStats.issued << " issued"
                       << " PlayerPos: (" << playerPos[0] << ", " << playerPos[1] << ")" << std::endl;
         }
+        if (frameCount % 600 == 0) { // 每600帧输出各通道耗时，定位瓶颈
+            renderer.profiler().print();
+        }
+    }
+
+    if (offscreen && !offscreenFrameTimes.empty()) {
+        std::vector<double> sorted = offscreenFrameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double t : sorted) sum += t;
+        size_t p95 = std::min(sorted.size() - 1, (size_t)std::ceil(sorted.size() * 0.95) - 1);
+        printf("Offscreen %dx%d, %d frames: avg %.3f ms, min %.3f ms, p95 %.3f ms, max %.3f ms\n",
+               window_width, window_height, (int)sorted.size(), sum / sorted.size(),
+               sorted.front(), sorted[p95], sorted.back());
+        renderer.profiler().print();
+        const Core::GLStateCache::Stats& glStats = renderer.glStateStats();
+        printf("GL state (last frame): %u elided / %u issued\n", glStats.elided, glStats.issued);
+
+        if (!options.reference.empty()) {
+            std::vector<uint8_t> rgba, ref;
+            int w = 0, h = 0, rw = 0, rh = 0;
+            renderer.readPixels(rgba, w, h);
+            if (!Core::readPPM(options.reference, ref, rw, rh) || rw != w || rh != h) {
+                std::cerr << "Reference " << options.reference << " missing or size mismatch" << std::endl;
+                exitCode = 1;
+            } else {
+                double error = Core::meanAbsoluteError(rgba, ref);
+                printf("Mean abs error vs %s: %.3f (tolerance %.3f)\n", options.reference.c_str(), error, options.tolerance);
+                if (error > options.tolerance) exitCode = 1;
+            }
+        }
+    }
+
+    if (trace) {
+        renderer.profiler().setTrace(nullptr);
+        if (trace->writeJSON(options.tracePath)) {
+            std::cout << "Trace: " << trace->size() << " events (" << trace->dropped() << " overwritten) -> "
+                      << options.tracePath << std::endl;
+        } else {
+            std::cerr << "Failed to write " << options.tracePath << std::endl;
+            exitCode = 1;
+        }
     }
 
     renderer.shutdown();
     shutdown();
-    return 0;
+    return exitCode;
 }
 
 
@@ -0,0 +1,145 @@
+// LightBaker 的正确性对照：多线程 SIMD 的 bake() 与标量单线程的 bakeReference() 逐纹素比较。
+// 覆盖迷宫同款网格（自发光实例收集光源）与非 2 的幂格子、贴图宽度非 4 的倍数、光源在墙内 / 网格外 / 零半径等边界，
+// 以及不同线程数（含超过行数）。任一纹素超出容差返回非零
+#include "Core/LightBaker.h"
+#include "Math/MathTool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+// 两种实现的衰减只在 sqrt / 乘加顺序上有舍入差异（armv7 NEON 为倒数平方根迭代）
+const float TOLERANCE = 1e-4f;
+
+// 逐纹素比较 bake(threads) 与 bakeReference()，返回参考结果的总辐照度（用于确认用例不是全黑）
+double compareBakes(const char* name, Core::LightBaker& baker) {
+    baker.bakeReference();
+    const std::vector<float> reference = baker.irradiance();
+    double energy = 0.0;
+    for (float v : reference) energy += v;
+
+    const int threadCounts[] = {1, 2, 3, 8, 0, 100000};
+    for (int t = 0; t < (int)(sizeof(threadCounts) / sizeof(threadCounts[0])); ++t) {
+        baker.bake(threadCounts[t]);
+        const std::vector<float>& got = baker.irradiance();
+        if (got.size() != reference.size()) {
+            printf("FAIL %s threads %d: map size %zu != %zu\n", name, threadCounts[t], got.size(), reference.size());
+            ++failures;
+            continue;
+        }
+        float maxError = 0.0f;
+        int bad = 0, firstBad = -1;
+        for (size_t i = 0; i < got.size(); ++i) {
+            float error = std::fabs(got[i] - reference[i]);
+            maxError = std::max(maxError, error);
+            if (error > TOLERANCE * std::max(1.0f, std::fabs(reference[i]))) {
+                if (firstBad < 0) firstBad = (int)i;
+                ++bad;
+            }
+        }
+        if (bad) {
+            const int texel = firstBad / 3;
+            printf("FAIL %s threads %d: %d channels differ (max %g), first at texel (%d, %d): %g != %g\n", name,
+                   threadCounts[t], bad, maxError, texel % baker.mapWidth(), texel / baker.mapWidth(), got[firstBad],
+                   reference[firstBad]);
+            ++failures;
+        }
+    }
+    printf("%-12s %4dx%-4d %3zu lights, energy %.1f\n", name, baker.mapWidth(), baker.mapHeight(),
+           baker.lights().size(), energy);
+    if (!(energy > 0.0)) {
+        printf("FAIL %s: reference bake is black\n", name);
+        ++failures;
+    }
+    return energy;
+}
+
+// 边框为墙、内部约四分之一为墙的随机网格
+std::vector<uint8_t> randomGrid(std::mt19937& rng, int width, int height) {
+    std::vector<uint8_t> grid(width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            bool border = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+            grid[y * width + x] = border || rng() % 4 == 0 ? 1 : 0;
+        }
+    }
+    return grid;
+}
+
+// 与 bakeMazeLights 相同的网格参数，光源由 LAYER_STATIC 的自发光实例收集
+void testMazeGrid(std::mt19937& rng) {
+    const int size = 16;
+    std::vector<uint8_t> grid = randomGrid(rng, size, size);
+    Core::InstanceStore instances;
+    std::uniform_real_distribution<float> cell(1.0f, size - 2.0f), emissive(0.0f, 1.5f);
+    for (int i = 0; i < 12; ++i) {
+        // 一半为动态实例，不应被收集
+        Core::InstanceHandle h = instances.create(nullptr, i & 1 ? Core::LAYER_DYNAMIC : Core::LAYER_STATIC);
+        float model[16], offset[3] = {cell(rng), cell(rng), 0.5f}, rotate[3] = {0, 0, 0}, scale[3] = {1, 1, 1};
+        createModelMatrix1(model, offset, rotate, scale);
+        instances.setModelMatrix(h, model);
+        instances.setEmissive(h, emissive(rng), emissive(rng), emissive(rng), 1.0f);
+    }
+
+    Core::LightBaker baker;
+    baker.setGrid(grid.data(), size, size, -0.5f, -0.5f, 1.0f);
+    baker.addEmissiveInstances(instances, Core::LAYER_STATIC, 0.2f * 20.0f, 0.8f);
+    if (baker.lights().size() != 6) {
+        printf("FAIL maze: collected %zu lights from 6 static emitters\n", baker.lights().size());
+        ++failures;
+    }
+    compareBakes("maze", baker);
+}
+
+// 非 2 的幂格子与偏移原点、贴图宽度非 4 的倍数，以及各类边界光源
+void testIrregularGrid(std::mt19937& rng) {
+    const int width = 13, height = 9;
+    const float originX = 2.3f, originY = -1.7f, cellSize = 0.7f;
+    std::vector<uint8_t> grid = randomGrid(rng, width, height);
+
+    Core::LightBaker baker;
+    baker.setGrid(grid.data(), width, height, originX, originY, cellSize);
+    baker.setTexelsPerCell(5);
+    std::uniform_real_distribution<float> px(originX, originX + width * cellSize);
+    std::uniform_real_distribution<float> py(originY, originY + height * cellSize);
+    std::uniform_real_distribution<float> radius(0.2f, 4.0f);
+    for (int i = 0; i < 16; ++i) {
+        Core::BakeLight light = {{px(rng), py(rng)}, radius(rng), {1.0f, 0.6f, 0.3f}};
+        baker.addLight(light);
+    }
+    const Core::BakeLight edges[] = {
+        {{originX + 5 * cellSize, originY + 4 * cellSize}, 2.0f, {0.5f, 0.5f, 1.0f}},  // 恰在格线交点
+        {{originX - 1.0f, originY + 3.0f}, 2.5f, {1.0f, 1.0f, 1.0f}},                 // 网格外，半径伸入
+        {{originX + 0.35f, originY + 0.35f}, 3.0f, {0.2f, 1.0f, 0.2f}},               // 墙内（边框格子中心）
+        {{originX + 4.0f, originY + 3.0f}, 0.0f, {9.0f, 9.0f, 9.0f}},                 // 零半径：不贡献
+        {{originX + 4.0f, originY + 3.0f}, 0.05f, {9.0f, 9.0f, 9.0f}},                // 小于一个纹素
+        {{originX + 4.5f, originY + 3.1f}, 50.0f, {0.1f, 0.1f, 0.1f}},                // 覆盖整张贴图
+    };
+    for (const Core::BakeLight& light : edges) baker.addLight(light);
+    compareBakes("irregular", baker);
+
+    // 纹素数为 1（每格一个纹素）与较大值
+    baker.setTexelsPerCell(1);
+    compareBakes("texels=1", baker);
+    baker.setTexelsPerCell(11);
+    compareBakes("texels=11", baker);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(20240613u);
+    testMazeGrid(rng);
+    testIrregularGrid(rng);
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
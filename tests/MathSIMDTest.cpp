@@ -0,0 +1,321 @@
+// MathSIMD / MathTool 的正确性对照：向量化乘法、批量 VP×N、求逆与模型矩阵，
+// 与标量三重循环和 MathSIMD 引入前的原实现（Gauss-Jordan 求逆、rotY*rotX 相乘构造模型矩阵）逐元素比较。
+// CMake 同时以 SIMD 与 PI_MATH_SCALAR 两种方式编译本文件，任一不符返回非零
+#include "Math/MathSIMD.h"
+#include "Math/MathTool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+// 相对误差：|a - b| <= tol * max(1, |a|, |b|, magnitude)
+bool nearlyEqual(float a, float b, float tol, float magnitude) {
+    float scale = std::max(std::max(1.0f, magnitude), std::max(std::fabs(a), std::fabs(b)));
+    return std::fabs(a - b) <= tol * scale;
+}
+
+// magnitude 为各元素的误差量级（可为空），乘积相消时结果很小而舍入误差按 sum|a||b| 计
+void expectMatrix(const char* what, int caseIndex, const float got[16], const float want[16], float tol,
+                  const float* magnitude = nullptr) {
+    for (int i = 0; i < 16; ++i) {
+        if (!nearlyEqual(got[i], want[i], tol, magnitude ? magnitude[i] : 0.0f)) {
+            if (failures < 20) {
+                printf("FAIL %s case %d: [%d] %.9g != %.9g\n", what, caseIndex, i, got[i], want[i]);
+            }
+            ++failures;
+            return;
+        }
+    }
+}
+
+// MathSIMD 引入前的 invertMatrix（Gauss-Jordan 消元，选列主元）
+bool invertMatrixBaseline(const float m[16], float inv[16]) {
+    float mat[4][8];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            mat[i][j] = m[i * 4 + j];
+            mat[i][j + 4] = (i == j) ? 1.0f : 0.0f;
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        int maxRow = i;
+        for (int k = i + 1; k < 4; k++) {
+            if (std::fabs(mat[k][i]) > std::fabs(mat[maxRow][i])) maxRow = k;
+        }
+        if (maxRow != i) {
+            for (int k = 0; k < 8; k++) std::swap(mat[i][k], mat[maxRow][k]);
+        }
+        if (std::fabs(mat[i][i]) < 1e-6f) return false;
+        float pivot = mat[i][i];
+        for (int k = 0; k < 8; k++) mat[i][k] /= pivot;
+        for (int k = 0; k < 4; k++) {
+            if (k == i) continue;
+            float factor = mat[k][i];
+            for (int j = 0; j < 8; j++) mat[k][j] -= factor * mat[i][j];
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) inv[i * 4 + j] = mat[i][j + 4];
+    }
+    return true;
+}
+
+// MathSIMD 引入前的 createModelMatrix1（构造 rotY、rotX 再相乘）
+void createModelMatrix1Baseline(float matrix[16], const float offset[3], const float rotate_deg[3],
+                                const float scale[3]) {
+    float angle_rad_y = rotate_deg[1] * (M_PI / 180.0f);
+    float c_y = cos(angle_rad_y);
+    float s_y = sin(angle_rad_y);
+    float rotY_mat[16];
+    createIdentityMatrix(rotY_mat);
+    rotY_mat[0] = c_y;
+    rotY_mat[2] = s_y;
+    rotY_mat[8] = -s_y;
+    rotY_mat[10] = c_y;
+
+    float angle_rad_x = rotate_deg[2] * (M_PI / 180.0f);
+    float c_x = cos(angle_rad_x);
+    float s_x = sin(angle_rad_x);
+    float rotX_mat[16];
+    createIdentityMatrix(rotX_mat);
+    rotX_mat[5] = c_x;
+    rotX_mat[6] = -s_x;
+    rotX_mat[9] = s_x;
+    rotX_mat[10] = c_x;
+
+    multiplyMatricesScalar(rotY_mat, rotX_mat, matrix);
+    matrix[12] = offset[0];
+    matrix[13] = offset[1];
+    matrix[14] = offset[2];
+    matrix[0] *= scale[0];
+    matrix[5] *= scale[1];
+    matrix[10] *= scale[2];
+}
+
+// sum_k |a_ik| * |b_kj|：点积舍入误差的量级（FMA 与分开乘加的差异在此范围内）
+void productMagnitude(const float a[16], const float b[16], float out[16]) {
+    float absA[16], absB[16];
+    for (int i = 0; i < 16; ++i) {
+        absA[i] = std::fabs(a[i]);
+        absB[i] = std::fabs(b[i]);
+    }
+    multiplyMatricesScalar(absA, absB, out);
+}
+
+void randomMatrix(std::mt19937& rng, float m[16], float range) {
+    std::uniform_real_distribution<float> dist(-range, range);
+    for (int i = 0; i < 16; ++i) m[i] = dist(rng);
+}
+
+// 对角占优的一般矩阵，条件数有界，两种求逆的差异只来自舍入
+void randomInvertible(std::mt19937& rng, float m[16]) {
+    randomMatrix(rng, m, 1.0f);
+    for (int i = 0; i < 4; ++i) m[i * 5] += (m[i * 5] < 0.0f ? -5.0f : 5.0f);
+}
+
+// 旋转 * 非零缩放 + 平移，最后一行为 (0,0,0,1)，走 invertAffineMatrix 快速路径
+void randomAffine(std::mt19937& rng, float m[16]) {
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f), scale(0.25f, 4.0f), offset(-50.0f, 50.0f);
+    float rotY[16], rotX[16], s[16];
+    float offs[3] = {0.0f, 0.0f, 0.0f}, deg[3] = {0.0f, angle(rng), angle(rng)}, one[3] = {1.0f, 1.0f, 1.0f};
+    createModelMatrix1Baseline(rotY, offs, deg, one);
+    deg[1] = angle(rng);
+    deg[2] = angle(rng);
+    createModelMatrix1Baseline(rotX, offs, deg, one);
+    createIdentityMatrix(s);
+    for (int k = 0; k < 3; ++k) s[k * 5] = (rng() & 1 ? 1.0f : -1.0f) * scale(rng);
+    multiplyMatricesScalar(rotY, rotX, m);
+    multiplyMatricesScalar(m, s, m);
+    for (int k = 0; k < 3; ++k) m[12 + k] = offset(rng);
+}
+
+// 乘法的边界输入：单位阵、零矩阵、负零、极大 / 极小量级、投影矩阵
+std::vector<std::vector<float> > edgeMatrices() {
+    std::vector<std::vector<float> > out;
+    std::vector<float> m(16);
+    createIdentityMatrix(m.data());
+    out.push_back(m);
+    out.push_back(std::vector<float>(16, 0.0f));
+    out.push_back(std::vector<float>(16, -0.0f));
+    for (int i = 0; i < 16; ++i) m[i] = (i & 1 ? -1.0f : 1.0f) * 1e6f;
+    out.push_back(m);
+    for (int i = 0; i < 16; ++i) m[i] = (i & 1 ? -1.0f : 1.0f) * 1e-6f * (i + 1);
+    out.push_back(m);
+    createPerspectiveMatrix(1.0f, 4.0f / 3.0f, 0.1f, 100.0f, m.data());
+    out.push_back(m);
+    createOrthographicMatrix(-8.0f, 8.0f, -6.0f, 6.0f, -20.0f, 20.0f, m.data());
+    out.push_back(m);
+    return out;
+}
+
+void testMultiply(std::mt19937& rng) {
+    const float tol = 1e-6f;
+    std::vector<std::vector<float> > edges = edgeMatrices();
+    int caseIndex = 0;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        for (size_t j = 0; j < edges.size(); ++j, ++caseIndex) {
+            float got[16], want[16], magnitude[16];
+            multiplyMatricesSIMD(edges[i].data(), edges[j].data(), got);
+            multiplyMatricesScalar(edges[i].data(), edges[j].data(), want);
+            productMagnitude(edges[i].data(), edges[j].data(), magnitude);
+            expectMatrix("multiply/edge", caseIndex, got, want, tol, magnitude);
+        }
+    }
+    for (int n = 0; n < 10000; ++n) {
+        float a[16], b[16], got[16], want[16], magnitude[16];
+        randomMatrix(rng, a, 100.0f);
+        randomMatrix(rng, b, 100.0f);
+        multiplyMatricesScalar(a, b, want);
+        productMagnitude(a, b, magnitude);
+        multiplyMatricesSIMD(a, b, got);
+        expectMatrix("multiply/random", n, got, want, tol, magnitude);
+        multiplyMatrices(a, b, got);
+        expectMatrix("multiplyMatrices", n, got, want, tol, magnitude);
+
+        // 原地：结果与 a 或 b 共用数组
+        float inA[16], inB[16];
+        memcpy(inA, a, sizeof(a));
+        memcpy(inB, b, sizeof(b));
+        multiplyMatricesSIMD(inA, b, inA);
+        expectMatrix("multiply/alias-a", n, inA, want, tol, magnitude);
+        multiplyMatricesSIMD(a, inB, inB);
+        expectMatrix("multiply/alias-b", n, inB, want, tol, magnitude);
+    }
+}
+
+void testBatch(std::mt19937& rng) {
+    const float tol = 1e-6f;
+    // 覆盖 0、1 与奇数个（AVX 一次处理两列，检查尾部）
+    const int counts[] = {0, 1, 2, 3, 7, 64, 257};
+    int caseIndex = 0;
+    for (int c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); ++c) {
+        const int count = counts[c];
+        float vp[16];
+        randomMatrix(rng, vp, 10.0f);
+        std::vector<float> models(count * 16 + 1), want(count * 16), magnitude(count * 16);
+        std::vector<float> got(count * 16 + 16, 12345.0f);
+        std::vector<const float*> pointers(count);
+        for (int i = 0; i < count; ++i) {
+            randomMatrix(rng, &models[i * 16], 10.0f);
+            multiplyMatricesScalar(vp, &models[i * 16], &want[i * 16]);
+            productMagnitude(vp, &models[i * 16], &magnitude[i * 16]);
+        }
+        // 每个矩阵的指针都错开一个 float，检查非对齐读取
+        std::vector<float> shifted(models.size());
+        for (int i = 0; i < count; ++i) {
+            memcpy(&shifted[i * 16 + 1], &models[i * 16], 16 * sizeof(float));
+            pointers[i] = &shifted[i * 16 + 1];
+        }
+
+        multiplyMatricesBatch(vp, models.data(), count, got.data());
+        for (int i = 0; i < count; ++i, ++caseIndex) {
+            expectMatrix("batch/contiguous", caseIndex, &got[i * 16], &want[i * 16], tol, &magnitude[i * 16]);
+        }
+        for (int i = count * 16; i < (int)got.size(); ++i) {
+            if (got[i] != 12345.0f) {
+                printf("FAIL batch/contiguous count %d: wrote past the end\n", count);
+                ++failures;
+                break;
+            }
+        }
+        multiplyMatricesBatch(vp, pointers.data(), count, got.data());
+        for (int i = 0; i < count; ++i, ++caseIndex) {
+            expectMatrix("batch/pointers", caseIndex, &got[i * 16], &want[i * 16], tol, &magnitude[i * 16]);
+        }
+    }
+}
+
+void testInvert(std::mt19937& rng) {
+    const float tol = 1e-4f;
+    float identity[16];
+    createIdentityMatrix(identity);
+    for (int n = 0; n < 10000; ++n) {
+        float m[16], got[16], want[16], product[16];
+        if (n & 1) {
+            randomAffine(rng, m);
+        } else {
+            randomInvertible(rng, m);
+        }
+        bool okGot = invertMatrix(m, got);
+        bool okWant = invertMatrixBaseline(m, want);
+        if (!okGot || !okWant) {
+            printf("FAIL invert case %d: invertible matrix rejected (%d, %d)\n", n, okGot, okWant);
+            ++failures;
+            continue;
+        }
+        expectMatrix(n & 1 ? "invert/affine" : "invert/general", n, got, want, tol);
+        multiplyMatricesScalar(m, got, product);
+        expectMatrix("invert/identity", n, product, identity, tol);
+    }
+
+    // 边界：单位阵、纯平移、奇异矩阵（零矩阵、两列相同、零缩放的仿射矩阵）
+    float m[16], got[16], want[16];
+    createIdentityMatrix(m);
+    if (!invertMatrix(m, got)) ++failures;
+    expectMatrix("invert/identity-input", 0, got, identity, 0.0f);
+    m[12] = 3.0f;
+    m[13] = -4.0f;
+    m[14] = 5.0f;
+    invertMatrixBaseline(m, want);
+    if (!invertMatrix(m, got)) ++failures;
+    expectMatrix("invert/translation", 0, got, want, tol);
+
+    float singular[3][16];
+    memset(singular[0], 0, sizeof(singular[0]));
+    // 整数元素：行列式精确为 0，不受舍入影响
+    const float duplicated[16] = {1, 2, 3, 4, 1, 2, 3, 4, 5, 6, 7, 9, 2, 0, 1, 3};
+    memcpy(singular[1], duplicated, sizeof(duplicated));
+    createIdentityMatrix(singular[2]);
+    singular[2][5] = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        if (invertMatrix(singular[i], got) || invertMatrixBaseline(singular[i], want)) {
+            printf("FAIL invert/singular case %d: accepted a singular matrix\n", i);
+            ++failures;
+        }
+    }
+}
+
+void testModelMatrix(std::mt19937& rng) {
+    const float tol = 1e-6f;
+    std::uniform_real_distribution<float> angle(-720.0f, 720.0f), offset(-100.0f, 100.0f), scale(-4.0f, 4.0f);
+    for (int n = 0; n < 10000; ++n) {
+        float offs[3], deg[3], s[3], got[16], want[16];
+        for (int k = 0; k < 3; ++k) {
+            offs[k] = offset(rng);
+            deg[k] = angle(rng);
+            s[k] = scale(rng);
+        }
+        // 边界：0 / 90 / 180 度与零缩放
+        if (n < 16) {
+            deg[1] = 90.0f * (n & 3);
+            deg[2] = 90.0f * (n >> 2);
+            s[n % 3] = 0.0f;
+        }
+        createModelMatrix1(got, offs, deg, s);
+        createModelMatrix1Baseline(want, offs, deg, s);
+        expectMatrix("modelMatrix1", n, got, want, tol);
+    }
+}
+
+} // namespace
+
+int main() {
+    printf("MathSIMD backend: %s\n", mathSIMDBackendName());
+    std::mt19937 rng(20240601u);
+    testMultiply(rng);
+    testBatch(rng);
+    testInvert(rng);
+    testModelMatrix(rng);
+    if (failures) {
+        printf("%d mismatches\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}